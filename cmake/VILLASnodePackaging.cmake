@@ -45,8 +45,8 @@ set(CPACK_RPM_PLUGINS_FILE_NAME "${CPACK_RPM_PLUGINS_PACKAGE_NAME}-${SUFFIX}")
 set(CPACK_RPM_TOOLS_FILE_NAME   "${CPACK_RPM_TOOLS_PACKAGE_NAME}-${SUFFIX}")
 set(CPACK_RPM_DOC_FILE_NAME     "${CPACK_RPM_DOC_PACKAGE_NAME}-${SUFFIX}")
 
-set(CPACK_RPM_DEVEL_PACKAGE_REQUIRES   "${CPACK_RPM_LIB_PACKAGE_NAME} >= ${CPACK_PACKAGE_VERSION} fmt-devel >= 5.2.0, spdlog-devel >= 1.3.1, openssl-devel >= 1.0.0, libuuid-devel, protobuf-devel >= 2.6.0, protobuf-c-devel >= 1.1.0, libconfig-devel >= 1.4.9, libnl3-devel >= 3.2.27, libcurl-devel >= 7.29.0, jansson-devel >= 2.7, libwebsockets-devel >= 2.3.0, zeromq-devel >= 2.2.0, nanomsg-devel >= 1.0.0, librabbitmq-devel >= 0.8.0, mosquitto-devel >= 1.4.15, libibverbs-devel >= 16.2, librdmacm-devel >= 16.2, libusb-devel >= 0.1.5, lua-devel >= 5.1, librdkafka-devel >= 1.5.0, hiredis-devel >= 1.0.0")
-set(CPACK_RPM_LIB_PACKAGE_REQUIRES     "                                                          fmt >= 5.2.0,       spdlog >= 1.3.1,       openssl-libs >= 1.0.0,  libuuid,       protobuf >= 2.6.0,       protobuf-c >= 1.1.0,       libconfig >= 1.4.9,       libnl3 >= 3.2.27,       libcurl >= 7.29.0,       jansson >= 2.7,       libwebsockets >= 2.3.0,       zeromq >= 2.2.0,       nanomsg >= 1.0.0,       librabbitmq >= 0.8.0,       mosquitto >= 1.4.15,       libibverbs >= 16.2,       librdmacm >= 16.2,       libusb >= 0.1.5,       lua >= 5.1,       librdkafka >= 1.5.0,       hiredis >= 1.0.0")
+set(CPACK_RPM_DEVEL_PACKAGE_REQUIRES   "${CPACK_RPM_LIB_PACKAGE_NAME} >= ${CPACK_PACKAGE_VERSION} fmt-devel >= 5.2.0, spdlog-devel >= 1.3.1, openssl-devel >= 1.0.0, libuuid-devel, protobuf-devel >= 2.6.0, libconfig-devel >= 1.4.9, libnl3-devel >= 3.2.27, libcurl-devel >= 7.29.0, jansson-devel >= 2.7, libwebsockets-devel >= 2.3.0, zeromq-devel >= 2.2.0, nanomsg-devel >= 1.0.0, librabbitmq-devel >= 0.8.0, mosquitto-devel >= 1.4.15, libibverbs-devel >= 16.2, librdmacm-devel >= 16.2, libusb-devel >= 0.1.5, lua-devel >= 5.1, librdkafka-devel >= 1.5.0, hiredis-devel >= 1.0.0")
+set(CPACK_RPM_LIB_PACKAGE_REQUIRES     "                                                          fmt >= 5.2.0,       spdlog >= 1.3.1,       openssl-libs >= 1.0.0,  libuuid,       protobuf >= 2.6.0,       libconfig >= 1.4.9,       libnl3 >= 3.2.27,       libcurl >= 7.29.0,       jansson >= 2.7,       libwebsockets >= 2.3.0,       zeromq >= 2.2.0,       nanomsg >= 1.0.0,       librabbitmq >= 0.8.0,       mosquitto >= 1.4.15,       libibverbs >= 16.2,       librdmacm >= 16.2,       libusb >= 0.1.5,       lua >= 5.1,       librdkafka >= 1.5.0,       hiredis >= 1.0.0")
 set(CPACK_RPM_BIN_PACKAGE_REQUIRES     "${CPACK_RPM_LIB_PACKAGE_NAME} >= ${CPACK_PACKAGE_VERSION}")
 set(CPACK_RPM_PLUGINS_PACKAGE_REQUIRES "${CPACK_RPM_LIB_PACKAGE_NAME} >= ${CPACK_PACKAGE_VERSION}")
 set(CPACK_RPM_TOOLS_PACKAGE_REQUIRES   "${CPACK_RPM_LIB_PACKAGE_NAME} >= ${CPACK_PACKAGE_VERSION}")
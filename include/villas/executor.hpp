@@ -0,0 +1,134 @@
+/* A shared pool of worker threads which executes paths.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <jansson.h>
+
+#include <villas/common.hpp>
+#include <villas/log.hpp>
+
+namespace villas {
+namespace node {
+
+// Forward declarations
+class Path;
+
+/* Executes the steps of many paths on a small number of worker threads.
+ *
+ * Each path is assigned to a home worker, whose epoll instance waits for
+ * the path to become ready. Ready paths are queued at their home worker
+ * and can be stolen by idle workers.
+ *
+ * The epoll file descriptor of a path is registered with EPOLLONESHOT and
+ * only re-armed after its step has been completed. Hence, a path is never
+ * executed by more than one worker at a time, which preserves the order
+ * of its samples.
+ */
+class Executor final {
+
+protected:
+  struct Worker;
+
+  struct Task {
+    Path *path;
+    Worker *home; // The worker whose epoll instance waits for this task
+
+    std::atomic<bool> busy;    // A worker is currently executing this task
+    std::atomic<bool> removed; // The path has been removed from the executor
+  };
+
+  struct Worker {
+    unsigned index;
+
+    int epoll_fd;
+    int event_fd; // Used to wake up the worker for stealing or stopping
+
+    std::mutex mutex;
+    std::deque<Task *> tasks; // Owner pops from front, thieves from back
+
+    std::atomic<bool> sleeping;
+
+    std::thread thread;
+
+    // Statistics
+    uint64_t steps;
+    uint64_t steals;
+  };
+
+  enum State state;
+
+  bool enabled;
+  int num_workers; // Number of worker threads (0 = one per CPU)
+  int affinity;    // CPUs to which the workers are pinned round-robin
+
+  std::atomic<bool> running;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  /* Removed tasks are kept until the executor is destroyed, as workers
+   * might still hold stale references to them in their queues. */
+  std::mutex tasks_mutex;
+  std::vector<std::unique_ptr<Task>> tasks;
+
+  Logger logger;
+
+  void run(Worker *w);
+
+  // Wait for ready tasks of the home worker and queue them.
+  int collect(Worker *w, int timeout);
+
+  Task *pop(Worker *w);
+  Task *steal(Worker *w);
+
+  void push(Worker *w, Task *t);
+  void wake(Worker *w);
+  void arm(Task *t, int op);
+
+public:
+  Executor();
+  ~Executor();
+
+  int parse(json_t *json);
+
+  void check();
+
+  // Create the workers. Paths can be added afterwards.
+  void prepare(int default_affinity);
+
+  void start();
+  void stop();
+
+  /* Register a started path whose epoll file descriptor is ready for use.
+   *
+   * Paths can be added before or after the executor has been started.
+   */
+  void add(Path *p);
+
+  /* Unregister a path.
+   *
+   * Waits until no worker executes the path anymore. Afterwards, the path
+   * can safely close its epoll file descriptor.
+   */
+  void remove(Path *p);
+
+  bool isEnabled() const { return enabled; }
+
+  size_t getWorkerCount() const { return workers.size(); }
+
+  enum State getState() const { return state; }
+};
+
+} // namespace node
+} // namespace villas
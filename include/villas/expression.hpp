@@ -0,0 +1,103 @@
+/* Natively compiled signal expressions.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <villas/signal_list.hpp>
+
+namespace villas {
+namespace node {
+
+// Forward declarations
+struct Sample;
+
+/* An arithmetic expression over the fields of a sample.
+ *
+ * The expression is written in the subset of Lua which is used by the
+ * signal expressions of the lua hook, e.g.:
+ *
+ *   math.sqrt(smp.data.u_re^2 + smp.data.u_im^2) * 1e-3
+ *
+ * It is parsed once, constant folded and compiled into a register-based
+ * program which is evaluated without a Lua state.
+ * Expressions which use any other language construct are rejected with a
+ * RuntimeError so that the caller can fall back to Lua.
+ */
+class Expression {
+
+public:
+  using Ptr = std::unique_ptr<Expression>;
+
+  enum class OpCode : uint8_t {
+    CONST,         // r[dst] = value
+    LOAD_FLOAT,    // r[dst] = smp->data[index].f
+    LOAD_INTEGER,  // r[dst] = smp->data[index].i
+    LOAD_SEQUENCE, // r[dst] = smp->sequence
+    LOAD_FLAGS,    // r[dst] = smp->flags
+    LOAD_TS,       // r[dst] = smp->ts.{origin,received}.{tv_sec,tv_nsec}
+    NEG,           // r[dst] = -r[a]
+    ADD,           // r[dst] = r[a] + r[b]
+    SUB,           // r[dst] = r[a] - r[b]
+    MUL,           // r[dst] = r[a] * r[b]
+    DIV,           // r[dst] = r[a] / r[b]
+    MOD,           // r[dst] = r[a] % r[b] (floored as in Lua)
+    POW,           // r[dst] = r[a] ^ r[b]
+    MIN,           // r[dst] = math.min(r[a], r[b])
+    MAX,           // r[dst] = math.max(r[a], r[b])
+    CALL1,         // r[dst] = func1(r[a])
+    CALL2          // r[dst] = func2(r[a], r[b])
+  };
+
+  struct Instruction {
+    OpCode op;
+    uint8_t dst, a, b;
+
+    union {
+      double value;                    // CONST
+      unsigned index;                  // LOAD_*
+      double (*func1)(double);         // CALL1
+      double (*func2)(double, double); // CALL2
+    };
+
+    std::string toString() const;
+  };
+
+protected:
+  std::string expression;
+
+  std::vector<Instruction> program;
+  unsigned registers;
+
+public:
+  /* Compile an expression against the signals of the input samples.
+   *
+   * Signals are referenced by name (smp.data.name or smp.data["name"]) if
+   * useNames is set, otherwise by their index (smp.data[0]).
+   */
+  Expression(const std::string &expr, SignalList::Ptr signals,
+             bool useNames = true);
+
+  // Evaluate the expression for a sample.
+  double evaluate(const struct Sample *smp) const;
+
+  // The expression does not depend on the sample.
+  bool isConstant() const {
+    return program.size() == 1 && program[0].op == OpCode::CONST;
+  }
+
+  const std::vector<Instruction> &getProgram() const { return program; }
+
+  std::string toString() const;
+};
+
+} // namespace node
+} // namespace villas
@@ -7,8 +7,13 @@
 
 #pragma once
 
+#include <cerrno>
+#include <cstdio>
 #include <memory>
 
+#include <sys/types.h>
+#include <sys/uio.h>
+
 #include <villas/list.hpp>
 #include <villas/plugin.hpp>
 #include <villas/sample.hpp>
@@ -29,7 +34,8 @@ public:
 
 protected:
   int flags;          // A set of flags which is automatically used.
-  int real_precision; // Number of digits used for floatint point numbers
+  int real_precision; // Number of decimal places of real numbers or -1 for the
+                      // shortest representation which round-trips (opt-in).
 
   Logger logger;
 
@@ -38,10 +44,57 @@ protected:
     size_t buflen;
   } in, out;
 
+  /* State of the incremental scanner used by Format::scan().
+   *
+   * Data which has been read from the stream but not yet been consumed by
+   * sscan() is kept in in.buffer[head, tail). The buffer is always
+   * terminated by a null character at in.buffer[tail].
+   */
+  struct {
+    FILE *file;
+    off_t offset; // Position of the file descriptor after the last read
+
+    size_t head;
+    size_t tail;
+
+    bool active;    // Set while sscan() is invoked by scan()
+    bool eof;       // The last read reached the end of the stream
+    bool truncated; // The stream ends with an incomplete record
+
+    /* Number of samples of the record at in.buffer[head] which have
+     * already been returned. Formats which store multiple samples per
+     * record set this instead of rbytes if a record exceeds cnt.
+     */
+    unsigned skip;
+  } stream;
+
   SignalList::Ptr
       signals; // Signal meta data for parsed samples by Format::scan()
 
+  /* Reset the scanner if the stream has been changed or repositioned.
+   *
+   * Data which stdio has already buffered is moved into the scanner. This
+   * is only supported with glibc. Other C libraries read via stdio instead.
+   */
+  void syncStream(FILE *f);
+
+  /* Read more data from the stream into the scanner buffer.
+   *
+   * @retval >0		The number of bytes which have been read.
+   * @retval 0		The end of the stream has been reached or no data is available.
+   * @retval <0		Something went wrong.
+   */
+  ssize_t fillStream(FILE *f);
+
 public:
+  /* Returned by sscan() if the buffer starts with an incomplete record.
+   *
+   * This is only reported while scanning a stream with scan(). If complete
+   * records precede the incomplete one, sscan() returns their number and
+   * sets rbytes to the beginning of the incomplete record instead.
+   */
+  static constexpr int NEED_MORE = -EAGAIN;
+
   Format(int fl);
 
   virtual ~Format();
@@ -61,8 +114,28 @@ public:
 
   virtual int print(FILE *f, const struct Sample *const smps[], unsigned cnt);
 
+  /* Read samples from a stream.
+   *
+   * With glibc, the scanner reads from the file descriptor of the stream
+   * directly. Hence, once scanning has started, the stream must only be
+   * read via scan().
+   */
   virtual int scan(FILE *f, struct Sample *const smps[], unsigned cnt);
 
+  /* Write out all samples which have been buffered by print().
+   *
+   * Some formats collect samples in print() to write them in batches.
+   * This needs to be called before the stream is closed.
+   */
+  virtual int finish(FILE *f) { return 0; }
+
+  /* Check if all samples of a stream have been scanned.
+   *
+   * As scan() reads ahead, feof() might already be true while samples are
+   * still left in the buffer of the scanner.
+   */
+  bool eof(FILE *f) const;
+
   virtual void printMetadata(FILE *f, json_t *json) {}
 
   /* Print \p cnt samples from \p smps into buffer \p buf of length \p len.
@@ -79,6 +152,32 @@ public:
   virtual int sprint(char *buf, size_t len, size_t *wbytes,
                      const struct Sample *const smps[], unsigned cnt) = 0;
 
+  /* Print \p cnt samples from \p smps into a list of buffers.
+   *
+   * Formats whose wire layout of the signal values matches their layout in
+   * memory point the vectors directly to the sample data. All other parts
+   * are written to \p buf. The default implementation calls sprint() and
+   * returns a single vector to \p buf.
+   *
+   * This allows nodes to pass the payload to sendmsg() without copying it.
+   * The vectors are only valid as long as \p buf and the samples are not
+   * modified.
+   *
+   * @param buf[out]	The scratch buffer for the data which is not referenced in place.
+   * @param len[in]	The length of the buffer \p buf.
+   * @param wbytes[out]	The total number of bytes of all vectors. Ignored if nullptr.
+   * @param iov[out]	The array of vectors.
+   * @param iovcnt[in,out]	The capacity of \p iov, updated to the number of vectors used.
+   * @param smps[in]	The array of pointers to samples.
+   * @param cnt[in]	The number of pointers in the array \p smps.
+   *
+   * @retval >=0		The number of samples from \p smps which have been written.
+   * @retval <0		Something went wrong.
+   */
+  virtual int sprintv(char *buf, size_t len, size_t *wbytes, struct iovec iov[],
+                      size_t *iovcnt, const struct Sample *const smps[],
+                      unsigned cnt);
+
   /* Parse samples from the buffer \p buf with a length of \p len bytes.
    *
    * @param buf[in]	The buffer of data which should be parsed / de-serialized.
@@ -88,6 +187,7 @@ public:
    * @param cnt[in]	The number of pointers in the array \p smps.
    *
    * @retval >=0		The number of samples which have been parsed from \p buf and written into \p smps.
+   * @retval NEED_MORE	The buffer does not contain a complete record (only while scanning a stream).
    * @retval <0		Something went wrong.
    */
   virtual int sscan(const char *buf, size_t len, size_t *rbytes,
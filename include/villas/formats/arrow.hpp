@@ -0,0 +1,131 @@
+/* Apache Arrow IPC stream format.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+
+#include <villas/format.hpp>
+
+namespace villas {
+namespace node {
+
+// Forward declarations
+struct Sample;
+
+/* Columnar format based on the Apache Arrow IPC streaming format.
+ *
+ * Samples are stored in record batches with one column per signal, as well as
+ * optional columns for the timestamps and the sequence number.
+ *
+ * print() collects samples until a batch is full. The remaining samples are
+ * written by finish(). scan() maps regular files into memory and reads the
+ * record batches without copying them.
+ */
+class ArrowFormat : public BinaryFormat {
+
+protected:
+  unsigned batch_size;                  // Number of samples per record batch.
+  arrow::Compression::type compression; // Compression of the record batches.
+
+  std::shared_ptr<arrow::Schema> schema;
+
+  // Indices of the columns in a schema which is read by scan() or sscan()
+  struct Columns {
+    int ts_origin;
+    int ts_received;
+    int sequence;
+
+    std::vector<int> data;
+  };
+
+  // State of print()
+  struct {
+    FILE *file;
+
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+    std::unique_ptr<arrow::RecordBatchBuilder> builder;
+    unsigned pending; // Number of samples in the builder
+  } output;
+
+  // State of scan() in addition to Format::stream
+  struct {
+    void *map; // Regular files are mapped into memory
+    size_t maplen;
+
+    std::shared_ptr<arrow::io::InputStream> source;
+    std::shared_ptr<arrow::ipc::RecordBatchStreamReader> reader;
+    int64_t start;    // Position of the current IPC stream in the source
+    unsigned batches; // Number of batches read from the current IPC stream
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    int64_t row;
+
+    Columns columns;
+  } replay;
+
+  arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchWriter>>
+  makeWriter(std::shared_ptr<arrow::io::OutputStream> sink);
+
+  arrow::Status appendSample(arrow::RecordBatchBuilder *builder,
+                             const struct Sample *smp);
+
+  arrow::Result<Columns>
+  resolveColumns(const std::shared_ptr<arrow::Schema> &sch) const;
+
+  void unpackSample(const std::vector<std::shared_ptr<arrow::Array>> &arrays,
+                    const Columns &cols, int64_t row, struct Sample *smp);
+
+  arrow::Status writeSamples(std::shared_ptr<arrow::io::OutputStream> sink,
+                             const struct Sample *const smps[], unsigned cnt);
+
+  arrow::Result<unsigned>
+  readSamples(std::shared_ptr<arrow::io::InputStream> source,
+              struct Sample *const smps[], unsigned cnt);
+
+  arrow::Status writeBatch();
+
+  arrow::Status openReplay(FILE *f);
+
+  arrow::Status remapReplay();
+
+  arrow::Status nextBatch();
+
+  void closeReplay();
+
+public:
+  ArrowFormat(int fl);
+
+  virtual ~ArrowFormat();
+
+  using Format::start;
+
+  virtual void start();
+
+  virtual void parse(json_t *json);
+
+  virtual int sscan(const char *buf, size_t len, size_t *rbytes,
+                    struct Sample *const smps[], unsigned cnt);
+
+  virtual int sprint(char *buf, size_t len, size_t *wbytes,
+                     const struct Sample *const smps[], unsigned cnt);
+
+  virtual int print(FILE *f, const struct Sample *const smps[], unsigned cnt);
+
+  virtual int scan(FILE *f, struct Sample *const smps[], unsigned cnt);
+
+  virtual int finish(FILE *f);
+};
+
+} // namespace node
+} // namespace villas
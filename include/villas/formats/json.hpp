@@ -35,10 +35,40 @@ protected:
   virtual int unpackSamples(json_t *json_smps, struct Sample *const smps[],
                             unsigned cnt);
 
+  /* Serialize samples without building a jansson object tree.
+   *
+   * The signal list of the samples is used as schema and values are written
+   * directly from Sample::data. If \p array is false, only a single sample
+   * is written without enclosing array.
+   *
+   * @retval -1		The samples can not be serialized directly.
+   */
+  int sprintDirect(char *buf, size_t len, size_t *wbytes,
+                   const struct Sample *const smps[], unsigned cnt,
+                   bool array = true);
+
+  /* Parse samples without building a jansson object tree.
+   *
+   * Values are parsed on-demand directly into Sample::data according to the
+   * signal list of the format.
+   *
+   * @retval -1		The buffer can not be parsed directly.
+   */
+  int sscanDirect(const char *buf, size_t len, size_t *rbytes,
+                  struct Sample *const smps[], unsigned cnt);
+
+  /* Check if the direct (de-)serialization can be used.
+   *
+   * Formats deriving from JsonFormat with a different schema must override
+   * this to return false. The jansson-based implementation is used instead.
+   */
+  virtual bool isDirectSupported() const;
+
   int dump_flags;
+  bool direct; // Use direct (de-)serialization if possible
 
 public:
-  JsonFormat(int fl) : Format(fl), dump_flags(0) {}
+  JsonFormat(int fl) : Format(fl), dump_flags(0), direct(true) {}
 
   virtual int sscan(const char *buf, size_t len, size_t *rbytes,
                     struct Sample *const smps[], unsigned cnt);
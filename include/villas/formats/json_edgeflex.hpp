@@ -18,6 +18,8 @@ protected:
   virtual int packSample(json_t **j, const struct Sample *smp);
   virtual int unpackSample(json_t *json_smp, struct Sample *smp);
 
+  virtual bool isDirectSupported() const { return false; }
+
 public:
   using JsonFormat::JsonFormat;
 };
@@ -19,6 +19,8 @@ protected:
   virtual int packSample(json_t **j, const struct Sample *smp);
   virtual int unpackSample(json_t *json_smp, struct Sample *smp);
 
+  virtual bool isDirectSupported() const { return false; }
+
   const char *villasToKafkaType(enum SignalType vt);
 
   json_t *json_schema;
@@ -18,6 +18,7 @@ namespace node {
 
 // Forward declarations
 struct Message;
+struct MessageBatch;
 struct Sample;
 
 // Convert msg from network to host byteorder
@@ -50,5 +51,48 @@ int msg_to_sample(const struct Message *msg, struct Sample *smp,
 int msg_from_sample(struct Message *msg, const struct Sample *smp,
                     const SignalList::Ptr sigs, uint8_t source_index);
 
+// Convert batch from network to host byteorder
+void msg_batch_ntoh(struct MessageBatch *b);
+
+// Convert batch from host to network byteorder
+void msg_batch_hton(struct MessageBatch *b);
+
+// Convert batch from little-endian to host byteorder (used by villas.web)
+void msg_batch_letoh(struct MessageBatch *b);
+
+// Convert batch from host to little-endian byteorder (used by villas.web)
+void msg_batch_htole(struct MessageBatch *b);
+
+/* Check the consistency of a batch.
+ *
+ * @param b A pointer to the batch in host byteorder
+ * @retval 0 The batch header is valid.
+ * @retval <0 The batch header is invalid.
+ */
+int msg_batch_verify(const struct MessageBatch *b);
+
+/* Get the number of leading samples of \p smps which can share a batch.
+ *
+ * Those samples have the same length, consecutive sequence numbers and
+ * timestamps within 2^32 nanoseconds after the first one.
+ */
+unsigned msg_batch_count(const struct Sample *const smps[], unsigned cnt);
+
+/* Copy up to \p cnt samples starting at index \p first from \p b into \p smps.
+ *
+ * @return The number of samples or a negative number on error.
+ */
+int msg_batch_to_samples(const struct MessageBatch *b, unsigned first,
+                         struct Sample *const smps[], unsigned cnt,
+                         const SignalList::Ptr sigs, uint8_t *source_index);
+
+/* Copy \p cnt samples from \p smps into \p b.
+ *
+ * The samples must have been checked with msg_batch_count() before.
+ */
+int msg_batch_from_samples(struct MessageBatch *b,
+                           const struct Sample *const smps[], unsigned cnt,
+                           const SignalList::Ptr sigs, uint8_t source_index);
+
 } // namespace node
 } // namespace villas
@@ -12,6 +12,9 @@
 // The current version number for the message format
 #define MSG_VERSION 2
 
+// The version number for batches of samples with a common header
+#define MSG_BATCH_VERSION 3
+
 // TODO: Implement more message types
 #define MSG_TYPE_DATA 0  // Message contains float / integer values
 #define MSG_TYPE_START 1 // Message marks the beginning of a new simulation case
@@ -26,6 +29,15 @@
 // The offset to the first data value in a message.
 #define MSG_DATA_OFFSET(msg) ((char *)(msg) + offsetof(struct Message, data))
 
+// The total size in bytes of a batch of \p count samples with \p values each
+#define MSG_BATCH_LEN(count, values)                                           \
+  (sizeof(struct MessageBatch) +                                               \
+   (count) * (sizeof(uint32_t) + MSG_DATA_LEN(values)))
+
+// The offset to the first data value in a batch.
+#define MSG_BATCH_DATA_OFFSET(b)                                               \
+  ((char *)(b) + sizeof(struct MessageBatch) + sizeof(uint32_t) * (b)->count)
+
 // The timestamp of a message in struct timespec format
 #define MSG_TS(msg, i)                                                         \
   i.tv_sec = (msg)->ts.sec;                                                    \
@@ -68,5 +80,43 @@ struct Message {
   } data[];
 } __attribute__((packed));
 
+/* A batch of samples which share a single header (version 3).
+ *
+ * All samples of a batch have the same number of values and consecutive
+ * sequence numbers. The header is followed by the offsets of the timestamps
+ * and then by the values of all samples.
+ *
+ * The first byte is identical to the one of struct Message. Hence, a
+ * receiver can distinguish both by the version field.
+ */
+struct MessageBatch {
+#if BYTE_ORDER == BIG_ENDIAN
+  unsigned version : 4;   // Always MSG_BATCH_VERSION
+  unsigned type : 2;      // Data or control message (see MSG_TYPE_*)
+  unsigned reserved1 : 2; // Reserved bits
+#elif BYTE_ORDER == LITTLE_ENDIAN
+  unsigned reserved1 : 2; // Reserved bits
+  unsigned type : 2;      // Data or control message (see MSG_TYPE_*)
+  unsigned version : 4;   // Always MSG_BATCH_VERSION
+#else
+#error Invalid byte-order
+#endif
+
+  uint8_t source_index; // An id which identifies the source of the samples.
+  uint16_t count;       // The number of samples in the batch.
+  uint16_t length;      // The number of values per sample.
+  uint16_t reserved2;   // Reserved bytes
+  uint32_t sequence;    // The sequence number of the first sample.
+
+  // The timestamp of the first sample.
+  struct {
+    uint32_t sec;  // Seconds since 1970-01-01 00:00:00
+    uint32_t nsec; // Nanoseconds of the current second
+  } ts;
+
+  // Offsets of the timestamps in nanoseconds relative to ts.
+  uint32_t offsets[];
+} __attribute__((packed));
+
 } // namespace node
 } // namespace villas
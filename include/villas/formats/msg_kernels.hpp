@@ -0,0 +1,52 @@
+/* Vectorized kernels for converting message payloads.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace villas {
+namespace node {
+
+/* A set of kernels which swap and convert the values of a message payload.
+ *
+ * All kernels accept unaligned pointers. The byte-swap kernel can also
+ * operate in-place.
+ */
+struct MsgKernels {
+  const char *name;
+
+  // Swap the byte-order of cnt 32-bit words.
+  void (*bswap32)(uint32_t *dst, const uint32_t *src, size_t cnt);
+
+  // Convert cnt single-precision values to double-precision.
+  void (*f32_to_f64)(double *dst, const float *src, size_t cnt);
+
+  // Convert cnt double-precision values to single-precision.
+  void (*f64_to_f32)(float *dst, const double *src, size_t cnt);
+};
+
+// Get the kernels which are currently used by the msg_*() functions.
+const struct MsgKernels *msg_kernels();
+
+/* Override the kernels which are used by the msg_*() functions.
+ *
+ * Passing a null pointer restores the default.
+ */
+void msg_kernels_set(const struct MsgKernels *k);
+
+/* Get all kernels supported by the CPU.
+ *
+ * The first entry is always the scalar reference implementation.
+ * The last entry is the fastest one, which is also used by default.
+ */
+std::vector<const struct MsgKernels *> msg_kernels_supported();
+
+} // namespace node
+} // namespace villas
@@ -15,6 +15,11 @@ namespace node {
 // Forward declarations
 struct Sample;
 
+/* Encodes samples as villas.node.Message defined in villas.proto.
+ *
+ * The wire format is implemented directly, so no memory is allocated for
+ * encoding or decoding.
+ */
 class ProtobufFormat : public BinaryFormat {
 
 public:
@@ -23,8 +23,12 @@ namespace node {
 // Forward declarations
 struct Sample;
 
+template <typename T, bool big, bool fake> struct RawCodec;
+
 class RawFormat : public BinaryFormat {
 
+  template <typename T, bool big, bool fake> friend struct RawCodec;
+
 public:
   enum Endianess { BIG, LITTLE };
 
@@ -33,17 +37,56 @@ protected:
   int bits;
   bool fake;
 
+  /* Codec which has been specialized by start() for the word size,
+   * byte-order and header settings.
+   *
+   * Unsupported word sizes use the generic implementation.
+   * sprintv is only set if values can be sent without conversion.
+   */
+  struct {
+    int (*sprint)(RawFormat *f, char *buf, size_t len, size_t *wbytes,
+                  const struct Sample *const smps[], unsigned cnt);
+    int (*sscan)(RawFormat *f, const char *buf, size_t len, size_t *rbytes,
+                 struct Sample *const smps[], unsigned cnt);
+    int (*sprintv)(RawFormat *f, char *buf, size_t len, size_t *wbytes,
+                   struct iovec iov[], size_t *iovcnt,
+                   const struct Sample *const smps[], unsigned cnt);
+  } codec;
+
+  // Type of all signals of the format, computed by start()
+  enum SignalType uniform_type;
+
+  /* Get the type of all signals or SignalType::INVALID if they differ.
+   *
+   * This does not modify the format, as it is called concurrently by the
+   * read and write threads of a node.
+   */
+  enum SignalType uniformType(const SignalList::Ptr &sigs) const;
+
+  int sprintGeneric(char *buf, size_t len, size_t *wbytes,
+                    const struct Sample *const smps[], unsigned cnt);
+  int sscanGeneric(const char *buf, size_t len, size_t *rbytes,
+                   struct Sample *const smps[], unsigned cnt);
+
 public:
   RawFormat(int fl, int b = 32, enum Endianess e = Endianess::LITTLE)
-      : BinaryFormat(fl), endianess(e), bits(b), fake(false) {
+      : BinaryFormat(fl), endianess(e), bits(b), fake(false),
+        codec{nullptr, nullptr, nullptr}, uniform_type(SignalType::INVALID) {
     if (fake)
       flags |= (int)SampleFlags::HAS_SEQUENCE | (int)SampleFlags::HAS_TS_ORIGIN;
   }
 
+  using Format::start;
+
+  virtual void start();
+
   virtual int sscan(const char *buf, size_t len, size_t *rbytes,
                     struct Sample *const smps[], unsigned cnt);
   virtual int sprint(char *buf, size_t len, size_t *wbytes,
                      const struct Sample *const smps[], unsigned cnt);
+  virtual int sprintv(char *buf, size_t len, size_t *wbytes, struct iovec iov[],
+                      size_t *iovcnt, const struct Sample *const smps[],
+                      unsigned cnt);
 
   virtual void parse(json_t *json);
 };
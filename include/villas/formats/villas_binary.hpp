@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdlib>
 
 #include <villas/format.hpp>
+#include <villas/formats/msg_format.hpp>
 
 namespace villas {
 namespace node {
@@ -17,6 +19,14 @@ namespace node {
 // Forward declarations
 struct Sample;
 
+/* The VILLAS binary network format.
+ *
+ * Version 2 sends a complete header with each sample. Version 3 sends
+ * consecutive samples with a single header per batch. sscan() accepts both.
+ *
+ * If the version is negotiated, sprint() uses the version of the last
+ * message received by sscan(), starting with version 2.
+ */
 class VillasBinaryFormat : public BinaryFormat {
 
 protected:
@@ -24,10 +34,31 @@ protected:
   bool web;
   bool validate_source_index;
 
+  /* Version of the messages printed by sprint()
+   *
+   * If negotiated, sscan() updates it while sprint() might be called from
+   * another thread, e.g. by the read and write threads of a socket node.
+   */
+  std::atomic<int> version;
+  bool negotiate; // Follow the version of received messages
+
+  int sprintBatch(char *buf, size_t len, size_t *wbytes,
+                  const struct Sample *const smps[], unsigned cnt);
+
+  /* Parse a single batch (version 3) from \p buf.
+   *
+   * Excess samples of a datagram are dropped. In a stream, they are returned
+   * by the next call if \p head is set. Otherwise the batch is left in the
+   * buffer.
+   */
+  int sscanBatch(const char *buf, size_t len, size_t *rbytes,
+                 struct Sample *const smps[], unsigned cnt, bool head,
+                 uint8_t *sid);
+
 public:
   VillasBinaryFormat(int fl, bool w, uint8_t sid = 0)
       : BinaryFormat(fl), source_index(sid), web(w),
-        validate_source_index(false) {}
+        validate_source_index(false), version(MSG_VERSION), negotiate(false) {}
 
   virtual int sscan(const char *buf, size_t len, size_t *rbytes,
                     struct Sample *const smps[], unsigned cnt);
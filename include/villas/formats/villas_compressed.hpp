@@ -0,0 +1,75 @@
+/* Compressed time-series format.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <villas/format.hpp>
+
+namespace villas {
+namespace node {
+
+// Forward declarations
+struct Sample;
+
+/* A compact binary format for slowly changing time-series.
+ *
+ * All samples passed to sprint() are encoded into a single frame. Within a
+ * frame, the values of each signal are compressed using the XOR scheme of
+ * Facebook's Gorilla TSDB. Timestamps are encoded as delta-of-deltas and
+ * sequence numbers as deltas using variable-length codes.
+ *
+ * Each frame starts with a header which carries a magic number and a
+ * checksum. This allows the receiver to resynchronize to the next frame
+ * after corrupted data in a stream.
+ */
+class VillasCompressedFormat : public BinaryFormat {
+
+public:
+  static constexpr uint8_t MAGIC[2] = {'V', 'C'};
+  static constexpr uint8_t VERSION = 1;
+
+  // Fields which are present for all samples of a frame
+  enum Field : uint8_t { SEQUENCE = 1 << 0, TS_ORIGIN = 1 << 1 };
+
+  // Frame header (all fields in network byte order)
+  struct Header {
+    uint8_t magic[2];
+#if BYTE_ORDER == BIG_ENDIAN
+    unsigned version : 4;
+    unsigned fields : 4;
+#else
+    unsigned fields : 4;
+    unsigned version : 4;
+#endif
+    uint8_t checksum; // Header bytes XOR'ed together must be zero
+    uint16_t count;   // Number of samples in the frame
+    uint16_t columns; // Number of signals in the frame
+    uint32_t length;  // Length of the payload in bytes
+  } __attribute__((packed));
+
+protected:
+  // Decode the samples [first, first + cnt) of a frame
+  int decodeFrame(const struct Header *hdr, const uint8_t *payload,
+                  struct Sample *const smps[], unsigned cnt,
+                  unsigned first = 0);
+
+  bool checkHeader(const struct Header *hdr) const;
+
+public:
+  using BinaryFormat::BinaryFormat;
+
+  virtual int sscan(const char *buf, size_t len, size_t *rbytes,
+                    struct Sample *const smps[], unsigned cnt);
+
+  virtual int sprint(char *buf, size_t len, size_t *wbytes,
+                     const struct Sample *const smps[], unsigned cnt);
+};
+
+} // namespace node
+} // namespace villas
@@ -26,6 +26,7 @@ class Node;
 class Path;
 struct Sample;
 class HookFactory;
+class FusedHook;
 
 class Hook {
 
@@ -54,6 +55,7 @@ protected:
   unsigned
       priority; // A priority to change the order of execution within one type of hook.
   bool enabled; // Is this hook active?
+  bool fusable; // May this hook be fused with neighbouring hooks?
 
   Path *path;
   Node *node;
@@ -108,6 +110,22 @@ public:
   // Called whenever a sample is processed.
   virtual Reason process(struct Sample *smp) { return Reason::OK; };
 
+  /* Called whenever a vector of samples is processed.
+   *
+   * The result for each sample is stored in reasons. Returns the number of
+   * samples which have been passed (Reason::OK) or -1 on error.
+   * The default implementation calls process() for each sample.
+   */
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
+
+  /* Append the elementwise operations of this hook to a fused hook.
+   *
+   * Only stateless hooks which modify signal values in place can be fused.
+   * Returns false if the hook can not be fused.
+   */
+  virtual bool fuseInto(FusedHook &fh) const { return false; }
+
   unsigned getPriority() const { return priority; }
 
   int getFlags() const { return flags; }
@@ -119,6 +137,8 @@ public:
   HookFactory *getFactory() const { return factory; }
 
   bool isEnabled() const { return enabled; }
+
+  bool isFusable() const { return fusable; }
 };
 
 class SingleSignalHook : public Hook {
@@ -23,8 +23,18 @@ struct Sample;
 
 class HookList : public std::list<Hook::Ptr> {
 
+protected:
+  SignalList::Ptr signals; // Signals which are passed to the first hook.
+
+  // Hooks in order of execution. Runs of elementwise hooks are fused.
+  std::vector<Hook::Ptr> plan;
+  size_t planSize; // Number of hooks for which the plan has been compiled.
+
+  // Compile the execution plan from the current list of hooks.
+  void compile();
+
 public:
-  HookList() {}
+  HookList() : planSize(0) {}
 
   /* Parses an object of hooks
    *
@@ -53,6 +63,9 @@ public:
 
   void dump(villas::Logger logger, std::string subject) const;
 
+  // Get the execution plan including fused hooks.
+  json_t *planToJson() const;
+
   SignalList::Ptr getSignals() const;
 
   // Get the maximum number of signals which is used by any of the hooks in the list.
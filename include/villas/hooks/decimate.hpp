@@ -39,6 +39,9 @@ public:
   virtual void parse(json_t *json);
 
   virtual Hook::Reason process(struct Sample *smp);
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
 };
 
 } // namespace node
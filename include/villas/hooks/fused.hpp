@@ -0,0 +1,119 @@
+/* Fused elementwise hooks.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <villas/hook.hpp>
+#include <villas/signal_data.hpp>
+
+namespace villas {
+namespace node {
+
+/* A run of consecutive elementwise hooks which are executed as one.
+ *
+ * The operations of all fused hooks are collected per signal at prepare time.
+ * Signals which share the same sequence of operations form a kernel.
+ * During processing, each signal is gathered once from all samples of a
+ * vector, passes all operations of its kernel and is written back.
+ *
+ * Fused hooks are created by HookList::prepare() and are not registered as
+ * plugins. The hooks which it contains are still started and stopped by the
+ * hook list.
+ */
+class FusedHook : public Hook {
+
+public:
+  using Ptr = std::shared_ptr<FusedHook>;
+
+  // An elementwise operation on a single signal value.
+  struct Operation {
+    enum class Type {
+      SCALE, // value = value * a + b
+      ROUND, // value = round(value * a) / a
+      LIMIT, // value = min(max(value, a), b)
+      CAST   // value = cast(value, from, to)
+    } type;
+
+    enum SignalType from; // Signal type before the operation.
+    enum SignalType to;   // Signal type after the operation.
+
+    double a, b;
+
+    bool operator==(const Operation &o) const {
+      return type == o.type && from == o.from && to == o.to && a == o.a &&
+             b == o.b;
+    }
+
+    std::string toString() const;
+  };
+
+  // A sequence of operations which is applied to a set of signals.
+  struct Kernel {
+    std::vector<unsigned> indices;
+    std::vector<Operation> operations;
+
+    std::string toString() const;
+
+    json_t *toJson() const;
+  };
+
+protected:
+  std::vector<Hook::Ptr> hooks; // Fused hooks in order of execution.
+  std::vector<Kernel> kernels;
+
+  std::vector<enum SignalType> types; // Current type of each signal.
+  std::map<unsigned, std::vector<Operation>> chains; // Operations per signal.
+
+  static void apply(const Operation &op, union SignalData values[],
+                    unsigned cnt);
+
+public:
+  FusedHook(Path *p, Node *n, SignalList::Ptr sigs);
+
+  /* Append a hook to the end of the run.
+   *
+   * Returns false if the hook can not be fused. The run is left unchanged
+   * in this case.
+   */
+  bool add(Hook::Ptr h);
+
+  /* Append an operation for a signal.
+   *
+   * Operations which have no effect on the current type of the signal are
+   * dropped. Returns false if the operation is not supported for this type.
+   */
+  bool addOperation(unsigned index, Operation::Type type, double a = 0,
+                    double b = 0);
+
+  bool addCast(unsigned index, enum SignalType to);
+
+  // Group signals with identical operations into kernels.
+  void compile();
+
+  const std::vector<Hook::Ptr> &getHooks() const { return hooks; }
+
+  const std::vector<Kernel> &getKernels() const { return kernels; }
+
+  virtual Hook::Reason process(struct Sample *smp);
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
+
+  virtual SignalList::Ptr getSignals() const {
+    return hooks.back()->getSignals();
+  }
+
+  std::string toString() const;
+
+  json_t *toJson() const;
+};
+
+} // namespace node
+} // namespace villas
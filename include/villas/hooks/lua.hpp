@@ -10,7 +10,9 @@
 #include <mutex>
 #include <vector>
 
+#include <villas/expression.hpp>
 #include <villas/hook.hpp>
+#include <villas/node/config.hpp>
 
 extern "C" {
 #include "lua.h"
@@ -30,19 +32,37 @@ protected:
   lua_State *L;
 
   std::string expression;
+  Expression::Ptr native; // Natively compiled expression if supported.
 
   json_t *cfg;
 
 public:
   LuaSignalExpression(lua_State *L, json_t *json_sig);
 
-  void prepare();
+  /* Compile the expression natively or load it into the Lua state.
+   *
+   * Expressions which are not supported by the native engine or if
+   * allowNative is not set fall back to Lua.
+   */
+  void prepare(SignalList::Ptr signals, bool useNames, bool allowNative);
 
   void parseExpression(const std::string &expr);
 
-  void evaluate(union SignalData *data, enum SignalType type);
+  bool isNative() const { return native != nullptr; }
+
+  const Expression::Ptr &getNative() const { return native; }
+
+  void evaluate(union SignalData *data, enum SignalType type,
+                const struct Sample *smp);
 };
 
+/* How samples are passed to the Lua script.
+ *
+ * TABLE: Each sample is converted into a Lua table and back.
+ * FFI:   Samples are accessed in place as LuaJIT FFI cdata.
+ */
+enum class LuaBinding { TABLE, FFI };
+
 class LuaHook : public Hook {
 
   friend LuaSignalExpression;
@@ -61,8 +81,12 @@ protected:
   lua_State *L;
   std::mutex mutex;
 
+  LuaBinding binding;
+
   bool useNames;
   bool hasExpressions;
+  bool hasLuaExpressions; // Some expressions require the Lua state
+  bool useNative;         // Compile expressions natively if possible
   bool needsLocking;
 
   // Function indices
@@ -73,13 +97,23 @@ protected:
     int process;
     int periodic;
     int prepare;
+    int processBatch;
   } functions;
 
+  // References to the wrappers of the FFI binding
+  struct {
+    int processBatch; // Calls process_batch() or process() of the script
+    int setSample;    // Sets the global variable 'smp' for expressions
+  } ffi;
+
   void parseExpressions(json_t *json_sigs);
 
   void loadScript();
   void lookupFunctions();
   void setupEnvironment();
+  void setupFFI();
+
+  void evaluateExpressions(struct Sample *smp);
 
   // Lua functions
 
@@ -125,6 +159,10 @@ public:
 
   // Called whenever a sample is processed.
   virtual Reason process(struct Sample *smp);
+
+  // Called whenever a vector of samples is processed.
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
 };
 
 } // namespace node
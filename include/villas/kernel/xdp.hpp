@@ -0,0 +1,127 @@
+/* AF_XDP sockets.
+ *
+ * These functions use Linux-specific APIs to exchange raw Ethernet frames
+ * with a network interface via a UMEM shared with the kernel.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <linux/if_xdp.h>
+
+#include <villas/log.hpp>
+
+namespace villas {
+namespace kernel {
+
+class XdpSocket {
+
+public:
+  enum class Mode {
+    AUTO,     // Try native XDP with zero-copy first, then generic XDP
+    ZEROCOPY, // Native XDP with zero-copy (requires driver support)
+    COPY      // Generic XDP in copy mode (works with any interface)
+  };
+
+protected:
+  // A single-producer / single-consumer ring shared with the kernel
+  struct Ring {
+    uint32_t *producer;
+    uint32_t *consumer;
+    uint32_t *flags;
+    void *descs;
+
+    uint32_t size;
+    uint32_t mask;
+    uint32_t cached_prod;
+    uint32_t cached_cons;
+
+    void *map;
+    size_t map_len;
+  };
+
+  int fd;       // The AF_XDP socket
+  int map_fd;   // XSKMAP which is used by the program to redirect frames
+  int prog_fd;  // The XDP program
+  int ifindex;  // Interface to which the program is attached
+  int xdp_flags; // Flags which have been used to attach the program
+  unsigned queue;
+  uint16_t ethertype; // In network byte order
+
+  char *umem;
+  size_t frame_size;
+  size_t frames;
+
+  bool zerocopy;
+
+  struct Ring fill, comp, rx, tx;
+
+  std::vector<uint64_t> tx_free; // UMEM addresses of unused TX frames
+
+  Logger logger;
+
+  void setup(Mode mode);
+  void teardown();
+
+  void mapRing(struct Ring *r, const struct xdp_ring_offset *off, size_t len,
+               size_t desc_size, off_t pgoff);
+  void unmapRing(struct Ring *r);
+
+  void loadProgram();
+  void attachProgram(int fd, int flags);
+
+  // Move TX frames from the completion ring back to the free list
+  void reclaimTx();
+
+public:
+  /* Create AF_XDP socket and attach an XDP program to the interface which
+   * redirects all frames of the given Ethertype into this socket.
+   *
+   * @param umem A page aligned memory region of frames * frame_size bytes.
+   *             Half of the frames are used for receiving, half for sending.
+   */
+  XdpSocket(int ifindex, unsigned queue, uint16_t ethertype, void *umem,
+            size_t frames, size_t frame_size, Mode mode = Mode::AUTO);
+  ~XdpSocket();
+
+  int getFD() const { return fd; }
+
+  bool isZeroCopy() const { return zerocopy; }
+
+  size_t getFrameSize() const { return frame_size; }
+
+  char *getFrame(uint64_t addr) { return umem + addr; }
+
+  /* Take up to cnt received frames from the RX ring.
+   *
+   * The frames must be handed back with release() after use.
+   *
+   * @return The number of received frames.
+   */
+  unsigned receive(uint64_t addrs[], uint32_t lens[], unsigned cnt);
+
+  // Return received frames to the kernel.
+  void release(const uint64_t addrs[], unsigned cnt);
+
+  /* Get up to cnt unused frames for sending.
+   *
+   * @return The number of frames which can be filled and passed to send().
+   */
+  unsigned allocate(uint64_t addrs[], unsigned cnt);
+
+  // Return frames from allocate() which have not been sent.
+  void discard(const uint64_t addrs[], unsigned cnt);
+
+  // Pass filled frames to the TX ring and notify the kernel.
+  void send(const uint64_t addrs[], const uint32_t lens[], unsigned cnt);
+};
+
+} // namespace kernel
+} // namespace villas
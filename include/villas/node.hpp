@@ -82,6 +82,7 @@ protected:
   uuid_t uuid;
 
   bool enabled;
+  bool nonblocking; // Let read() return 0 instead of waiting for samples
 
   Stats::Ptr
       stats; // Statistic counters. This is a pointer to the statistic hooks private data.
@@ -181,6 +182,16 @@ public:
   // Reverse local and remote socket address.
   virtual int reverse() { return -1; }
 
+  /* Switch read() between blocking and non-blocking mode.
+   *
+   * In non-blocking mode, read() returns 0 instead of waiting if no
+   * samples are available. Only nodes whose factory has the
+   * NodeFactory::Flags::SUPPORTS_NONBLOCKING flag can be switched.
+   */
+  virtual int setNonBlocking(bool en);
+
+  bool isNonBlocking() const { return nonblocking; }
+
   /* Get a list of file descriptors on which the path should poll
    *  to detect the availability of new samples which can be read.
    */
@@ -299,7 +310,8 @@ public:
     REQUIRES_WEB = (1 << 3),
     PROVIDES_SIGNALS = (1 << 4),
     INTERNAL = (1 << 5),
-    HIDDEN = (1 << 6)
+    HIDDEN = (1 << 6),
+    SUPPORTS_NONBLOCKING = (1 << 7) // See Node::setNonBlocking()
   };
 
   NodeList instances;
@@ -50,7 +50,8 @@ public:
            (int)NodeFactory::Flags::PROVIDES_SIGNALS |
            (int)NodeFactory::Flags::SUPPORTS_READ |
            (int)NodeFactory::Flags::SUPPORTS_WRITE |
-           (int)NodeFactory::Flags::SUPPORTS_POLL;
+           (int)NodeFactory::Flags::SUPPORTS_POLL |
+           (int)NodeFactory::Flags::SUPPORTS_NONBLOCKING;
   }
 
   virtual std::string getName() const { return "loopback.internal"; }
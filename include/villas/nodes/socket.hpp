@@ -11,6 +11,16 @@
 #include <villas/node/config.hpp>
 #include <villas/socket_addr.hpp>
 
+#ifdef WITH_IO_URING
+#include <liburing.h>
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+#include <net/ethernet.h>
+
+#include <villas/kernel/xdp.hpp>
+#endif // WITH_SOCKET_LAYER_XDP
+
 namespace villas {
 namespace node {
 
@@ -20,6 +30,12 @@ class NodeCompat;
 // The maximum length of a packet which contains stuct msg.
 #define SOCKET_INITIAL_BUFFER_LEN (64 * 1024)
 
+// The length of a single datagram buffer in batched mode.
+#define SOCKET_BATCH_BUFFER_LEN (9 * 1024)
+
+// The maximum number of frames which are sent / received at once via AF_XDP.
+#define SOCKET_XDP_BATCH 64u
+
 struct Socket {
   int sd; // The socket descriptor
   int verify_source; // Verify the source address of incoming packets against socket::remote.
@@ -37,10 +53,66 @@ struct Socket {
     struct ip_mreq mreq; // A multicast group to join.
   } multicast;
 
+  // Batched I/O via recvmmsg() / sendmmsg()
+  struct {
+    int enabled; // Use recvmmsg() / sendmmsg() for up to vectorize datagrams.
+    int gso;     // Use UDP generic segmentation offload for sending.
+    int gro;     // Use UDP generic receive offload for receiving.
+
+    // Received datagrams which did not fit into the previous read
+    unsigned received; // The number of datagrams of the last recvmmsg()
+    unsigned next;     // The first datagram which has not been decoded
+    ssize_t offset;    // The first segment of it which has not been decoded
+  } batch;
+
+#ifdef WITH_IO_URING
+  // io_uring I/O engine
+  struct {
+    int enabled;
+    struct io_uring in;  // Ring for multishot receives
+    struct io_uring out; // Ring for batched sends
+    struct io_uring_buf_ring *br; // Receive buffers provided to the kernel
+    unsigned nbufs;
+    unsigned inflight; // Number of sends which have not completed yet
+    struct msghdr msg; // Template for multishot recvmsg()
+  } io_uring;
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+  // AF_XDP options
+  struct {
+    int queue;      // The RX queue of the interface to which we bind
+    int frames;     // The number of UMEM frames
+    int frame_size; // The size of a single UMEM frame
+    enum villas::kernel::XdpSocket::Mode mode;
+
+    villas::kernel::XdpSocket *sock;
+    void *umem;
+
+    unsigned mtu;                       // MTU of the interface
+    unsigned char mac[ETHER_ADDR_LEN]; // MAC address of the interface
+
+    // Received frames which did not fit into the previous read
+    uint64_t addrs[SOCKET_XDP_BATCH];
+    uint32_t lens[SOCKET_XDP_BATCH];
+    unsigned received; // The number of frames taken from the RX ring
+    unsigned next;     // The first frame which has not been decoded
+  } xdp;
+#endif // WITH_SOCKET_LAYER_XDP
+
   struct {
     char *buf; // Buffer for receiving messages
     size_t buflen;
     union sockaddr_union saddr; // Remote address of the socket
+
+    /* Batched mode: buf is split into slots of buflen bytes each
+     * Otherwise: iovs holds the slots vectors of the formatted payload
+     */
+    unsigned slots;
+    struct mmsghdr *msgs;
+    struct iovec *iovs;
+    union sockaddr_union *saddrs; // Source addresses of received datagrams
+    char *ctrl;                   // Control messages (UDP GRO)
   } in, out;
 };
 
@@ -62,6 +134,8 @@ int socket_reverse(NodeCompat *n);
 
 int socket_fds(NodeCompat *n, int fds[]);
 
+int socket_poll_fds(NodeCompat *n, int fds[]);
+
 int socket_write(NodeCompat *n, struct Sample *const smps[], unsigned cnt);
 
 int socket_read(NodeCompat *n, struct Sample *const smps[], unsigned cnt);
@@ -26,16 +26,23 @@
 #include <villas/pool.hpp>
 #include <villas/queue.h>
 #include <villas/signal_list.hpp>
+#include <villas/stats.hpp>
 #include <villas/task.hpp>
 
+#ifdef __x86_64__
+#include <villas/tsc.hpp>
+#endif
+
 // Forward declarations
 struct pollfd;
+struct io_uring;
 
 namespace villas {
 namespace node {
 
 // Forward declarations
 class Node;
+class Executor;
 
 // The datastructure for a path.
 class Path {
@@ -46,10 +53,21 @@ class Path {
 protected:
   void *runSingle();
   void *runPoll();
+  void *runIoUring();
 
   static void *runWrapper(void *arg);
 
+  // Read from the single source according to the wait mode.
+  int readSingle(PathSource::Ptr ps);
+
+  // Wait for the pfds list according to the wait mode.
+  int waitPoll();
+
   void startPoll();
+  void stopPoll();
+
+  // Handle a readable file descriptor of the pfds list.
+  void readPollFD(unsigned i);
 
   static int id;
 
@@ -62,9 +80,30 @@ public:
     ALL // The path is triggered only after all sources have received at least 1 sample.
   } mode; // Determines when this path is triggered.
 
+  // The I/O engine which is used to wait for the sources of the path.
+  enum class IoEngine {
+    POLL,    // Use poll(2) to wait for all sources.
+    IO_URING // Use poll requests submitted to an io_uring.
+  } io_engine;
+
+  // Determines how the path waits for new samples of its sources.
+  enum class WaitMode {
+    BLOCK,   // Sleep until samples are available.
+    SPIN,    // Busy-poll the sources without ever sleeping.
+    ADAPTIVE // Busy-poll for spin_budget seconds before sleeping.
+  } wait_mode;
+
+  double spin_budget; // Seconds to busy-poll in adaptive wait mode.
+  double spin_time;   // Total seconds spent busy-polling.
+  double sleep_time;  // Total seconds spent sleeping in non-block wait modes.
+
   uuid_t uuid;
 
   std::vector<struct pollfd> pfds;
+  struct io_uring *ring; // Only used if io_engine == IoEngine::IO_URING
+
+  Executor *executor; // The shared executor which runs this path (optional)
+  int epoll_fd;       // Aggregates the pfds for the executor
 
   struct Pool pool;
   struct Sample *last_sample;
@@ -87,6 +126,14 @@ public:
   bool builtin;             // This path should use built-in hooks by default.
   int original_sequence_no; // Use original source sequence number when multiplexing
   unsigned queuelen;        // The queue length for each path_destination::queue
+  int pool_cache;           // Magazine size of the sample pool cache (0 = off)
+
+  bool trace;       // Record the latency of each pipeline stage.
+  Stats::Ptr stats; // Histograms of the stage latencies and wait times.
+#ifdef __x86_64__
+  struct Tsc tsc; // Used for timestamping stages if the TSC is invariant.
+#endif
+  double trace_period; // Seconds per tick of traceNow().
 
   pthread_t tid;  // The thread id for this path.
   json_t *config; // A JSON object containing the configuration of the path.
@@ -148,6 +195,13 @@ public:
   // Stop a path.
   void stop();
 
+  /* Handle all sources of the path which are ready without blocking.
+   *
+   * This is used by the executor, after the epoll_fd of the path
+   * became readable.
+   */
+  void runOnce();
+
   // Get a list of signals which is emitted by the path.
   SignalList::Ptr getOutputSignals(bool after_hooks = true);
 
@@ -178,6 +232,29 @@ public:
   const uuid_t &getUuid() const { return uuid; }
 
   json_t *toJson() const;
+
+  // Sum the hit and miss counters of the pool caches of this path.
+  void getPoolCacheCounters(size_t &hits, size_t &misses) const;
+
+  static const char *waitModeToString(WaitMode m);
+
+  // Get a timestamp for tracing the pipeline stages.
+  uint64_t traceNow() const;
+
+  /* Record the latency of a pipeline stage.
+   *
+   * The latency is added to the stats of the path and of node n
+   * (if the node has stats).
+   */
+  void traceStage(enum Stats::Metric m, Node *n, uint64_t start,
+                  uint64_t end) const;
+
+  /* Record the time spent busy-polling or sleeping in a non-block wait mode.
+   *
+   * The time is added to the totals and to the stats of the path and of its
+   * source nodes (if the nodes have stats).
+   */
+  void recordWait(enum Stats::Metric m, double delta);
 };
 
 } // namespace node
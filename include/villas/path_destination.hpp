@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <villas/queue.h>
 
@@ -32,12 +33,21 @@ protected:
 
   struct CQueue queue;
 
+  /* Enqueue timestamps of the samples in the queue.
+   *
+   * Only used if tracing is enabled for the path. As the queue is only
+   * accessed by the path, we can keep them in a separate ring in the
+   * same order as the samples.
+   */
+  std::vector<uint64_t> stamps;
+  size_t stamps_head, stamps_tail;
+
 public:
   PathDestination(Path *p, Node *n);
 
   ~PathDestination();
 
-  int prepare(int queuelen);
+  int prepare(int queuelen, int flags = 0);
 
   void check();
 
@@ -46,6 +56,9 @@ public:
 
   void write();
 
+  // Release all samples which have not been written yet.
+  void drain();
+
   Node *getNode() const { return node; }
 };
 
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <sys/types.h>
 
 #include <villas/common.hpp>
@@ -31,6 +33,12 @@ struct Pool {
   size_t alignment; // Alignment of a block in bytes
 
   struct CQueue queue; // The queue which is used to keep track of free blocks
+
+  size_t magazine_size; // Blocks per thread-local magazine (0 = no cache)
+  uint64_t cache_id;    // Identifies the thread-local magazines of this pool
+
+  std::atomic<size_t> cache_hits;   // Number of operations served by a magazine
+  std::atomic<size_t> cache_misses; // Number of exchanges with the queue
 };
 
 #define pool_buffer(p) ((char *)(p) + (p)->buffer_off)
@@ -68,5 +76,37 @@ void *pool_get(struct Pool *p);
 // Release a memory block back to the pool.
 int pool_put(struct Pool *p, void *buf);
 
+/* Enable a per-thread magazine cache in front of the pool.
+ *
+ * Each thread which allocates or releases blocks keeps two magazines of
+ * \p magazine_size blocks. Blocks are only exchanged with the shared queue
+ * of the pool if both magazines are empty (or full).
+ * This avoids cacheline bouncing if blocks are allocated and released by
+ * different threads.
+ *
+ * Note: Up to 2 * \p magazine_size blocks per thread are kept out of the
+ *       shared queue. The pool must be sized accordingly for the
+ *       \p threads which access it. This includes threads which only
+ *       release blocks, e.g. the threads of nodes which free the samples
+ *       of another pool. Magazines are only returned when such a thread
+ *       calls pool_cache_flush() or exits.
+ *
+ * The hit and miss counters of the pool are updated at least every
+ * \p magazine_size operations of a thread.
+ *
+ * Must be called before the pool is used.
+ *
+ * @retval 0 The cache has been enabled.
+ * @retval <>0 The pool is not large enough for the given magazine size.
+ */
+int pool_cache_enable(struct Pool *p, size_t magazine_size,
+                      unsigned threads = 1) __attribute__((warn_unused_result));
+
+/* Return the magazines of the calling thread to the shared queue.
+ *
+ * This also updates the hit and miss counters of the pool.
+ */
+void pool_cache_flush(struct Pool *p);
+
 } // namespace node
 } // namespace villas
@@ -53,7 +53,15 @@ struct CQueue_cell {
   off_t data_off; // Pointer relative to the queue struct
 };
 
-// A lock-free multiple-producer, multiple-consumer (MPMC) queue.
+enum class QueueFlags {
+  SPSC = (1 << 0) // Single-producer, single-consumer mode without CAS
+};
+
+/* A lock-free multiple-producer, multiple-consumer (MPMC) queue.
+ *
+ * If initialized with QueueFlags::SPSC, the queue operates as a
+ * single-producer, single-consumer ring buffer instead.
+ */
 struct CQueue {
   std::atomic<enum State> state;
 
@@ -61,21 +69,29 @@ struct CQueue {
 
   size_t buffer_mask;
   off_t buffer_off; // Relative pointer to struct CQueue_cell[]
+  int flags;
 
   cacheline_pad_t _pad1; // Producer area: only producers read & write
 
   std::atomic<size_t> tail; // Queue tail pointer
+  size_t cached_head;       // Producer copy of head (SPSC only)
 
   cacheline_pad_t _pad2; // Consumer area: only consumers read & write
 
   std::atomic<size_t> head; // Queue head pointer
+  size_t cached_tail;       // Consumer copy of tail (SPSC only)
 
   cacheline_pad_t _pad3; // TODO: Why needed?
 };
 
-// Initialize MPMC queue
+/* Initialize MPMC queue
+ *
+ * @param flags A bitmask of QueueFlags.
+ *              With QueueFlags::SPSC, the caller guarantees that at most
+ *              one thread pushes and at most one thread pulls at a time.
+ */
 int queue_init(struct CQueue *q, size_t size,
-               struct memory::Type *mem = memory::default_type)
+               struct memory::Type *mem = memory::default_type, int flags = 0)
     __attribute__((warn_unused_result));
 
 // Desroy MPMC queue and release memory
@@ -93,6 +109,9 @@ int queue_push(struct CQueue *q, void *ptr);
 int queue_pull(struct CQueue *q, void **ptr);
 
 /* Enqueue up to \p cnt pointers of the \p ptr array into the queue.
+ *
+ * A contiguous range of cells is reserved with a single CAS on the tail
+ * pointer. The cells are then published in order.
  *
  * @return The number of pointers actually enqueued.
  *         This number can be smaller then \p cnt in case the queue is filled.
@@ -100,6 +119,9 @@ int queue_pull(struct CQueue *q, void **ptr);
 int queue_push_many(struct CQueue *q, void *ptr[], size_t cnt);
 
 /* Dequeue up to \p cnt pointers from the queue and place them into the \p ptr array.
+ *
+ * A contiguous range of cells is reserved with a single CAS on the head
+ * pointer. The cells are then released in order.
  *
  * @return The number of pointers actually dequeued.
  *         This number can be smaller than \p cnt in case the queue contained less than
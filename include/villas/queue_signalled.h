@@ -47,6 +47,11 @@ struct CQueueSignalled {
 
 #define queue_signalled_available(q) queue_available(&((q)->queue))
 
+/* Initialize signalled queue
+ *
+ * @param flags A bitmask of QueueSignalledFlags and QueueFlags.
+ *              The latter are passed on to the underlying queue.
+ */
 int queue_signalled_init(
     struct CQueueSignalled *qs, size_t size = DEFAULT_QUEUE_LENGTH,
     struct memory::Type *mem = memory::default_type,
@@ -68,6 +73,11 @@ int queue_signalled_push_many(struct CQueueSignalled *qs, void *ptr[],
 int queue_signalled_pull_many(struct CQueueSignalled *qs, void *ptr[],
                               size_t cnt) __attribute__((warn_unused_result));
 
+// Pull up to cnt elements without waiting. Returns 0 if the queue is empty.
+int queue_signalled_try_pull_many(struct CQueueSignalled *qs, void *ptr[],
+                                  size_t cnt)
+    __attribute__((warn_unused_result));
+
 int queue_signalled_close(struct CQueueSignalled *qs)
     __attribute__((warn_unused_result));
 
@@ -52,6 +52,8 @@ enum class SampleFlags {
   NEW_SIMULATION =
       (1 << 17), // This sample is the first of a new simulation case
 
+  FROZEN = (1 << 18), // This sample is shared and must not be modified.
+
   ALL = -1
 };
 
@@ -121,6 +123,27 @@ int sample_decref(struct Sample *s);
 
 int sample_copy(struct Sample *dst, const struct Sample *src);
 
+/* Mark a sample as immutable.
+ *
+ * Frozen samples can be shared between multiple owners by incrementing
+ * their reference count instead of cloning them. An owner which needs to
+ * modify a frozen sample must call sample_make_writable() first.
+ */
+void sample_freeze(struct Sample *s);
+
+#define sample_is_frozen(s) ((s)->flags & (int)SampleFlags::FROZEN)
+
+/* Get a writable version of a sample (copy-on-write).
+ *
+ * If the sample is not frozen, it is returned as is.
+ * If the caller holds the only reference, the sample is thawed in place.
+ * Otherwise a private clone is returned and the reference of the caller
+ * to the original sample is released.
+ *
+ * @retval nullptr Pool underrun. The caller still owns \p s.
+ */
+struct Sample *sample_make_writable(struct Sample *s);
+
 // Dump all details about a sample to debug log
 void sample_dump(villas::Logger logger, struct Sample *s);
 
@@ -133,6 +156,14 @@ int sample_copy_many(struct Sample *const dsts[],
                      const struct Sample *const srcs[], int cnt);
 int sample_incref_many(struct Sample *const smps[], int cnt);
 int sample_decref_many(struct Sample *const smps[], int cnt);
+void sample_freeze_many(struct Sample *const smps[], int cnt);
+
+/* Replace frozen samples in \p smps by writable versions.
+ *
+ * @return The number of samples which are writable.
+ *         Stops at the first sample which could not be cloned.
+ */
+int sample_make_writable_many(struct Sample *smps[], int cnt);
 
 enum SignalType sample_format(const struct Sample *s, unsigned idx);
 
@@ -48,7 +48,12 @@ union SignalData {
   // Set data from double
   void set(enum SignalType type, double val);
 
-  // Print value of a signal to a character buffer.
+  /* Print value of a signal to a character buffer.
+   *
+   * Real numbers are printed with a fixed number of decimal places. A
+   * negative precision selects the shortest representation which is parsed
+   * back to the same value.
+   */
   int printString(enum SignalType type, char *buf, size_t len,
                   int precision = 5) const;
 
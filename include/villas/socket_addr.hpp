@@ -17,6 +17,10 @@
 #if defined(LIBNL3_ROUTE_FOUND) && defined(__linux__)
 #define WITH_SOCKET_LAYER_ETH
 
+#ifdef HAS_XDP
+#define WITH_SOCKET_LAYER_XDP
+#endif // HAS_XDP
+
 #include <linux/if_packet.h>
 #include <netinet/ether.h>
 #endif // LIBNL3_ROUTE_FOUND
@@ -35,7 +39,7 @@ union sockaddr_union {
 namespace villas {
 namespace node {
 
-enum class SocketLayer { ETH, IP, UDP, UNIX };
+enum class SocketLayer { ETH, IP, UDP, UNIX, XDP };
 
 /* Generate printable socket address depending on the address family
  *
@@ -51,6 +55,7 @@ char *socket_print_addr(struct sockaddr *saddr);
  *
  * A IPv4 address has the follwing format: [hostname/ip]:[port/protocol]
  * A link layer address has the following format: [mac]%[interface]:[ethertype]
+ * The XDP layer uses link layer addresses as well.
  *
  * TODO: Add support for autodetection of address type
  *
@@ -50,7 +50,18 @@ public:
     // RTP metrics
     RTP_LOSS_FRACTION, // Fraction lost since last RTP SR/RR.
     RTP_PKTS_LOST,     // Cumul. no. pkts lost.
-    RTP_JITTER         // Interarrival jitter.
+    RTP_JITTER,        // Interarrival jitter.
+
+    // Path stage latencies (only recorded if tracing is enabled for the path)
+    STAGE_READ,  // Time spent in Node::read() of a path source.
+    STAGE_REMAP, // Time spent in remapping samples of a path source.
+    STAGE_HOOKS, // Time spent in the hooks of a path.
+    STAGE_QUEUE, // Time samples spent in the queue of a path destination.
+    STAGE_WRITE, // Time spent in Node::write() of a path destination.
+
+    // Path wait times (only recorded in the spin and adaptive wait modes)
+    WAIT_SPIN, // Time spent busy-polling the sources of a path.
+    WAIT_SLEEP // Time spent sleeping until the sources of a path are ready.
   };
 
   enum class Type { LAST, HIGHEST, LOWEST, MEAN, VAR, STDDEV, TOTAL };
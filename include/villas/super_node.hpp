@@ -20,6 +20,7 @@ extern "C" {
 #include <villas/api.hpp>
 #include <villas/common.hpp>
 #include <villas/config_class.hpp>
+#include <villas/executor.hpp>
 #include <villas/kernel/if.hpp>
 #include <villas/log.hpp>
 #include <villas/node.hpp>
@@ -56,6 +57,8 @@ protected:
   Web web;
 #endif
 
+  Executor executor; // Shared worker threads for paths (optional)
+
   int priority;     // Process priority (lower is better)
   int affinity;     // Process affinity of the server and all created threads
   int hugepages;    // Number of hugepages to reserve.
@@ -143,6 +146,8 @@ public:
 
   int getAffinity() const { return affinity; }
 
+  Executor &getExecutor() { return executor; }
+
   Logger getLogger() { return logger; }
 
   // Destroy configuration object.
@@ -0,0 +1,334 @@
+/* A shared pool of worker threads which executes paths.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <exception>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/executor.hpp>
+#include <villas/kernel/rt.hpp>
+#include <villas/node/exceptions.hpp>
+#include <villas/path.hpp>
+#include <villas/utils.hpp>
+
+#define EXECUTOR_MAX_EVENTS 64
+
+using namespace villas;
+using namespace villas::node;
+
+Executor::Executor()
+    : state(State::INITIALIZED), enabled(false), num_workers(0), affinity(0),
+      running(false), logger(Log::get("executor")) {}
+
+Executor::~Executor() {
+  assert(state != State::STARTED);
+
+  for (auto &w : workers) {
+    close(w->epoll_fd);
+    close(w->event_fd);
+  }
+}
+
+int Executor::parse(json_t *json) {
+  int ret, en = -1;
+
+  json_error_t err;
+
+  ret = json_unpack_ex(json, &err, 0, "{ s?: b, s?: i, s?: i }", "enabled",
+                       &en, "workers", &num_workers, "affinity", &affinity);
+  if (ret)
+    throw ConfigError(json, err, "node-config-executor",
+                      "Failed to parse executor configuration");
+
+  enabled = en != 0;
+
+  state = State::PARSED;
+
+  return 0;
+}
+
+void Executor::check() {
+  if (num_workers < 0)
+    throw RuntimeError("Setting 'workers' of executor must be positive");
+}
+
+void Executor::prepare(int default_affinity) {
+  int ret;
+
+  if (!affinity)
+    affinity = default_affinity;
+
+  if (!num_workers) {
+    if (affinity)
+      num_workers = __builtin_popcount(affinity);
+    else
+      num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+
+  for (int i = 0; i < num_workers; i++) {
+    auto w = std::make_unique<Worker>();
+
+    w->index = i;
+    w->sleeping = false;
+    w->steps = 0;
+    w->steals = 0;
+
+    w->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (w->epoll_fd < 0)
+      throw SystemError("Failed to create epoll instance for executor");
+
+    w->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (w->event_fd < 0)
+      throw SystemError("Failed to create eventfd for executor");
+
+    // A null pointer marks wake-ups
+    struct epoll_event ev = {.events = EPOLLIN, .data = {.ptr = nullptr}};
+
+    ret = epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, w->event_fd, &ev);
+    if (ret)
+      throw SystemError("Failed to add eventfd to epoll instance");
+
+    workers.push_back(std::move(w));
+  }
+
+  state = State::PREPARED;
+}
+
+void Executor::add(Path *p) {
+  assert(state == State::PREPARED || state == State::STARTED);
+
+  std::lock_guard<std::mutex> guard(tasks_mutex);
+
+  auto t = std::make_unique<Task>();
+
+  t->path = p;
+  t->home = workers[tasks.size() % workers.size()].get();
+  t->busy = false;
+  t->removed = false;
+
+  arm(t.get(), EPOLL_CTL_ADD);
+
+  p->logger->debug("Path {} is executed by worker {}", p->toString(),
+                   t->home->index);
+
+  tasks.push_back(std::move(t));
+}
+
+void Executor::remove(Path *p) {
+  int ret;
+
+  std::lock_guard<std::mutex> guard(tasks_mutex);
+
+  for (auto &t : tasks) {
+    if (t->path != p || t->removed)
+      continue;
+
+    /* Workers check the flag after they marked the task as busy.
+     * Hence, no worker executes or re-arms the task once it is idle. */
+    t->removed = true;
+
+    while (t->busy)
+      std::this_thread::yield();
+
+    ret = epoll_ctl(t->home->epoll_fd, EPOLL_CTL_DEL, p->epoll_fd, nullptr);
+    if (ret)
+      throw SystemError("Failed to remove path {}", p->toString());
+
+    p->logger->debug("Path {} has been removed from worker {}", p->toString(),
+                     t->home->index);
+  }
+}
+
+void Executor::start() {
+  assert(state == State::PREPARED);
+
+  logger->info("Starting executor with {} workers for {} paths: affinity={:#x}",
+               workers.size(), tasks.size(), affinity);
+
+  running = true;
+
+  // Pin the workers round-robin to the CPUs of the affinity mask
+  std::vector<int> cpus;
+  for (unsigned i = 0; i < sizeof(affinity) * 8; i++) {
+    if ((unsigned)affinity & (1U << i))
+      cpus.push_back(i);
+  }
+
+  for (auto &w : workers) {
+    w->thread = std::thread(&Executor::run, this, w.get());
+
+    if (!cpus.empty()) {
+      int cpu = cpus[w->index % cpus.size()];
+
+      kernel::rt::setThreadAffinity(w->thread.native_handle(), 1U << cpu);
+    }
+  }
+
+  state = State::STARTED;
+}
+
+void Executor::stop() {
+  if (state != State::STARTED)
+    return;
+
+  running = false;
+
+  for (auto &w : workers)
+    wake(w.get());
+
+  for (auto &w : workers) {
+    w->thread.join();
+
+    logger->info("Worker {}: steps={}, steals={}", w->index, w->steps,
+                 w->steals);
+  }
+
+  state = State::STOPPED;
+}
+
+void Executor::arm(Task *t, int op) {
+  int ret;
+
+  struct epoll_event ev = {.events = EPOLLIN | EPOLLONESHOT,
+                           .data = {.ptr = t}};
+
+  ret = epoll_ctl(t->home->epoll_fd, op, t->path->epoll_fd, &ev);
+  if (ret)
+    throw SystemError("Failed to arm path {}", t->path->toString());
+}
+
+void Executor::wake(Worker *w) {
+  int ret;
+  uint64_t incr = 1;
+
+  ret = write(w->event_fd, &incr, sizeof(incr));
+  if (ret < 0 && errno != EAGAIN)
+    throw SystemError("Failed to wake up worker");
+}
+
+void Executor::push(Worker *w, Task *t) {
+  std::lock_guard<std::mutex> guard(w->mutex);
+
+  w->tasks.push_back(t);
+}
+
+Executor::Task *Executor::pop(Worker *w) {
+  std::lock_guard<std::mutex> guard(w->mutex);
+
+  if (w->tasks.empty())
+    return nullptr;
+
+  auto *t = w->tasks.front();
+  w->tasks.pop_front();
+
+  return t;
+}
+
+Executor::Task *Executor::steal(Worker *w) {
+  for (unsigned i = 1; i < workers.size(); i++) {
+    auto *v = workers[(w->index + i) % workers.size()].get();
+
+    std::lock_guard<std::mutex> guard(v->mutex);
+
+    if (v->tasks.empty())
+      continue;
+
+    auto *t = v->tasks.back();
+    v->tasks.pop_back();
+
+    w->steals++;
+
+    return t;
+  }
+
+  return nullptr;
+}
+
+int Executor::collect(Worker *w, int timeout) {
+  int ret, cnt = 0;
+  uint64_t val;
+
+  struct epoll_event evs[EXECUTOR_MAX_EVENTS];
+
+  if (timeout)
+    w->sleeping = true;
+
+  ret = epoll_wait(w->epoll_fd, evs, EXECUTOR_MAX_EVENTS, timeout);
+
+  w->sleeping = false;
+
+  if (ret < 0) {
+    if (errno == EINTR)
+      return 0;
+
+    throw SystemError("Failed to wait for paths");
+  }
+
+  for (int i = 0; i < ret; i++) {
+    auto *t = (Task *)evs[i].data.ptr;
+    if (!t) {
+      while (read(w->event_fd, &val, sizeof(val)) > 0)
+        ;
+
+      continue;
+    }
+
+    push(w, t);
+    cnt++;
+  }
+
+  // Let a sleeping worker steal the tasks which we can not handle right now
+  if (cnt > 1) {
+    for (auto &v : workers) {
+      if (v.get() != w && v->sleeping) {
+        wake(v.get());
+        break;
+      }
+    }
+  }
+
+  return cnt;
+}
+
+void Executor::run(Worker *w) {
+  while (running) {
+    auto *t = pop(w);
+
+    if (!t && collect(w, 0) > 0)
+      t = pop(w);
+
+    if (!t)
+      t = steal(w);
+
+    if (!t) {
+      collect(w, -1);
+      continue;
+    }
+
+    // Stale references to removed tasks are dropped
+    t->busy = true;
+
+    if (!t->removed) {
+      try {
+        t->path->runOnce();
+        w->steps++;
+
+        arm(t, EPOLL_CTL_MOD);
+      } catch (const std::exception &e) {
+        // The path is not re-armed and hence no longer executed
+        t->path->logger->error("Path {} failed and is no longer executed: {}",
+                               t->path->toString(), e.what());
+      }
+    }
+
+    t->busy = false;
+  }
+}
@@ -0,0 +1,634 @@
+/* Natively compiled signal expressions.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include <fmt/format.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/expression.hpp>
+#include <villas/sample.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+namespace {
+
+using Instruction = Expression::Instruction;
+using OpCode = Expression::OpCode;
+
+struct Node;
+using NodePtr = std::unique_ptr<Node>;
+
+// A node of the abstract syntax tree with at most two operands.
+struct Node {
+  Instruction ins;
+  std::vector<NodePtr> args;
+
+  Node(OpCode op) : ins() { ins.op = op; }
+};
+
+struct Token {
+  enum class Type { NUMBER, NAME, STRING, SYMBOL, END } type;
+
+  std::string text;
+  double value;
+};
+
+struct Function {
+  const char *name;
+  double (*func1)(double);
+  double (*func2)(double, double);
+};
+
+// Functions of the Lua math library which are supported natively.
+const Function functions[] = {
+    {"abs", [](double x) { return std::fabs(x); }, nullptr},
+    {"ceil", [](double x) { return std::ceil(x); }, nullptr},
+    {"floor", [](double x) { return std::floor(x); }, nullptr},
+    {"sqrt", [](double x) { return std::sqrt(x); }, nullptr},
+    {"exp", [](double x) { return std::exp(x); }, nullptr},
+    {"log", [](double x) { return std::log(x); }, nullptr},
+    {"sin", [](double x) { return std::sin(x); }, nullptr},
+    {"cos", [](double x) { return std::cos(x); }, nullptr},
+    {"tan", [](double x) { return std::tan(x); }, nullptr},
+    {"asin", [](double x) { return std::asin(x); }, nullptr},
+    {"acos", [](double x) { return std::acos(x); }, nullptr},
+    {"atan", [](double x) { return std::atan(x); }, nullptr},
+    {"deg", [](double x) { return x * (180.0 / M_PI); }, nullptr},
+    {"rad", [](double x) { return x * (M_PI / 180.0); }, nullptr},
+    {"fmod", nullptr, [](double x, double y) { return std::fmod(x, y); }},
+};
+
+// Same semantics as luai_nummod() of Lua 5.3
+inline double mod(double a, double b) {
+  double m = std::fmod(a, b);
+
+  if (m > 0 ? b < 0 : (m < 0 && b != m))
+    m += b;
+
+  return m;
+}
+
+inline double calculate(const Instruction &ins, double a, double b) {
+  switch (ins.op) {
+  case OpCode::NEG:
+    return -a;
+
+  case OpCode::ADD:
+    return a + b;
+
+  case OpCode::SUB:
+    return a - b;
+
+  case OpCode::MUL:
+    return a * b;
+
+  case OpCode::DIV:
+    return a / b;
+
+  case OpCode::MOD:
+    return mod(a, b);
+
+  case OpCode::POW:
+    return std::pow(a, b);
+
+  case OpCode::MIN:
+    return b < a ? b : a;
+
+  case OpCode::MAX:
+    return b > a ? b : a;
+
+  case OpCode::CALL1:
+    return ins.func1(a);
+
+  case OpCode::CALL2:
+    return ins.func2(a, b);
+
+  default:
+    return a;
+  }
+}
+
+class Parser {
+
+protected:
+  const std::string &str;
+  size_t pos;
+
+  Token tok;
+
+  SignalList::Ptr signals;
+  bool useNames;
+
+  void next() {
+    while (pos < str.size() && isspace(str[pos]))
+      pos++;
+
+    if (pos >= str.size()) {
+      tok = {Token::Type::END, "", 0};
+      return;
+    }
+
+    const char *start = str.c_str() + pos;
+    char c = *start;
+
+    if (isdigit(c) || (c == '.' && isdigit(start[1]))) {
+      char *end;
+
+      double value = strtod(start, &end);
+      if (isalnum(*end) || *end == '_' || *end == '.')
+        throw RuntimeError("Malformed number in expression: {}", str);
+
+      tok = {Token::Type::NUMBER, std::string(start, end - start), value};
+      pos += end - start;
+    } else if (isalpha(c) || c == '_') {
+      size_t len = 1;
+      while (isalnum(start[len]) || start[len] == '_')
+        len++;
+
+      tok = {Token::Type::NAME, std::string(start, len), 0};
+      pos += len;
+    } else if (c == '"' || c == '\'') {
+      size_t len = 1;
+      while (start[len] && start[len] != c) {
+        if (start[len] == '\\' || start[len] == '\n')
+          throw RuntimeError("Unsupported string literal in expression: {}",
+                             str);
+        len++;
+      }
+
+      if (!start[len])
+        throw RuntimeError("Unfinished string literal in expression: {}", str);
+
+      tok = {Token::Type::STRING, std::string(start + 1, len - 1), 0};
+      pos += len + 1;
+    } else if (strchr("+-*/%^()[].,", c) && !(c == '/' && start[1] == '/') &&
+               !(c == '-' && start[1] == '-') &&
+               !(c == '.' && start[1] == '.')) {
+      tok = {Token::Type::SYMBOL, std::string(1, c), 0};
+      pos++;
+    } else
+      throw RuntimeError("Unsupported token '{}' in expression: {}", start,
+                         str);
+  }
+
+  bool accept(char c) {
+    if (tok.type != Token::Type::SYMBOL || tok.text[0] != c)
+      return false;
+
+    next();
+
+    return true;
+  }
+
+  void expect(char c) {
+    if (!accept(c))
+      throw RuntimeError("Expected '{}' in expression: {}", c, str);
+  }
+
+  std::string expectName() {
+    if (tok.type != Token::Type::NAME)
+      throw RuntimeError("Expected a name in expression: {}", str);
+
+    auto name = tok.text;
+    next();
+
+    return name;
+  }
+
+  unsigned expectIndex() {
+    if (tok.type != Token::Type::NUMBER || tok.value < 0 ||
+        tok.value != std::floor(tok.value))
+      throw RuntimeError("Expected an index in expression: {}", str);
+
+    unsigned index = tok.value;
+    next();
+
+    return index;
+  }
+
+  static NodePtr makeConstant(double value) {
+    auto n = std::make_unique<Node>(OpCode::CONST);
+
+    n->ins.value = value;
+
+    return n;
+  }
+
+  static NodePtr makeOperation(OpCode op, NodePtr a, NodePtr b = nullptr) {
+    auto n = std::make_unique<Node>(op);
+
+    n->args.push_back(std::move(a));
+    if (b)
+      n->args.push_back(std::move(b));
+
+    return fold(std::move(n));
+  }
+
+  // Replace operations on constants by their result.
+  static NodePtr fold(NodePtr n) {
+    for (auto &arg : n->args) {
+      if (arg->ins.op != OpCode::CONST)
+        return n;
+    }
+
+    double a = n->args[0]->ins.value;
+    double b = n->args.size() > 1 ? n->args[1]->ins.value : a;
+
+    return makeConstant(calculate(n->ins, a, b));
+  }
+
+  NodePtr parseAdditive() {
+    auto n = parseMultiplicative();
+
+    while (true) {
+      if (accept('+'))
+        n = makeOperation(OpCode::ADD, std::move(n), parseMultiplicative());
+      else if (accept('-'))
+        n = makeOperation(OpCode::SUB, std::move(n), parseMultiplicative());
+      else
+        return n;
+    }
+  }
+
+  NodePtr parseMultiplicative() {
+    auto n = parseUnary();
+
+    while (true) {
+      if (accept('*'))
+        n = makeOperation(OpCode::MUL, std::move(n), parseUnary());
+      else if (accept('/'))
+        n = makeOperation(OpCode::DIV, std::move(n), parseUnary());
+      else if (accept('%'))
+        n = makeOperation(OpCode::MOD, std::move(n), parseUnary());
+      else
+        return n;
+    }
+  }
+
+  NodePtr parseUnary() {
+    if (accept('-'))
+      return makeOperation(OpCode::NEG, parseUnary());
+
+    return parsePower();
+  }
+
+  // Exponentiation is right associative and binds stronger than unary minus
+  NodePtr parsePower() {
+    auto n = parsePrimary();
+
+    if (accept('^'))
+      n = makeOperation(OpCode::POW, std::move(n), parseUnary());
+
+    return n;
+  }
+
+  NodePtr parsePrimary() {
+    if (tok.type == Token::Type::NUMBER) {
+      auto n = makeConstant(tok.value);
+      next();
+
+      return n;
+    }
+
+    if (accept('(')) {
+      auto n = parseAdditive();
+      expect(')');
+
+      return n;
+    }
+
+    auto name = expectName();
+    if (name == "smp")
+      return parseSample();
+    else if (name == "math")
+      return parseMath();
+
+    throw RuntimeError("Unsupported identifier '{}' in expression: {}", name,
+                       str);
+  }
+
+  NodePtr parseSample() {
+    expect('.');
+
+    auto field = expectName();
+    if (field == "sequence")
+      return std::make_unique<Node>(OpCode::LOAD_SEQUENCE);
+    else if (field == "flags")
+      return std::make_unique<Node>(OpCode::LOAD_FLAGS);
+    else if (field == "ts_origin" || field == "ts_received") {
+      auto n = std::make_unique<Node>(OpCode::LOAD_TS);
+
+      // Timestamps are tables of seconds [0] and nanoseconds [1]
+      expect('[');
+      n->ins.index = expectIndex();
+      expect(']');
+
+      if (n->ins.index > 1)
+        throw RuntimeError("Invalid timestamp field in expression: {}", str);
+
+      if (field == "ts_received")
+        n->ins.index += 2;
+
+      return n;
+    } else if (field == "data")
+      return parseData();
+
+    throw RuntimeError("Unsupported sample field '{}' in expression: {}",
+                       field, str);
+  }
+
+  NodePtr parseData() {
+    if (accept('.'))
+      return loadSignal(expectName());
+
+    expect('[');
+
+    NodePtr n;
+    if (tok.type == Token::Type::STRING) {
+      n = loadSignal(tok.text);
+      next();
+    } else if (!useNames)
+      n = loadSignal(expectIndex());
+    else
+      throw RuntimeError("Signals are referenced by name: {}", str);
+
+    expect(']');
+
+    return n;
+  }
+
+  // The Lua table of a sample holds the last pushable signal of each name
+  NodePtr loadSignal(const std::string &name) {
+    if (!useNames)
+      throw RuntimeError("Signals are not referenced by name: {}", str);
+
+    for (unsigned i = signals->size(); i > 0; i--) {
+      auto sig = signals->getByIndex(i - 1);
+
+      if (sig->name == name && (sig->type == SignalType::FLOAT ||
+                                sig->type == SignalType::INTEGER ||
+                                sig->type == SignalType::BOOLEAN))
+        return loadSignal(i - 1);
+    }
+
+    throw RuntimeError("Unknown signal '{}' in expression: {}", name, str);
+  }
+
+  NodePtr loadSignal(unsigned index) {
+    auto sig = signals->getByIndex(index);
+    if (!sig)
+      throw RuntimeError("Unknown signal {} in expression: {}", index, str);
+
+    NodePtr n;
+    switch (sig->type) {
+    case SignalType::FLOAT:
+      n = std::make_unique<Node>(OpCode::LOAD_FLOAT);
+      break;
+
+    case SignalType::INTEGER:
+      n = std::make_unique<Node>(OpCode::LOAD_INTEGER);
+      break;
+
+    default:
+      throw RuntimeError("Signal {} has unsupported type {}: {}", index,
+                         signalTypeToString(sig->type), str);
+    }
+
+    n->ins.index = index;
+
+    return n;
+  }
+
+  NodePtr parseMath() {
+    expect('.');
+
+    auto name = expectName();
+    if (name == "pi")
+      return makeConstant(M_PI);
+    else if (name == "huge")
+      return makeConstant(HUGE_VAL);
+
+    std::vector<NodePtr> args;
+
+    expect('(');
+    if (!accept(')')) {
+      do
+        args.push_back(parseAdditive());
+      while (accept(','));
+
+      expect(')');
+    }
+
+    // math.min() and math.max() are reduced to a chain of binary operations
+    if ((name == "min" || name == "max") && !args.empty()) {
+      auto n = std::move(args[0]);
+
+      for (unsigned i = 1; i < args.size(); i++)
+        n = makeOperation(name == "min" ? OpCode::MIN : OpCode::MAX,
+                          std::move(n), std::move(args[i]));
+
+      return n;
+    }
+
+    for (auto &f : functions) {
+      if (name != f.name)
+        continue;
+
+      if (f.func1 && args.size() == 1) {
+        auto n = std::make_unique<Node>(OpCode::CALL1);
+        n->ins.func1 = f.func1;
+        n->args = std::move(args);
+
+        return fold(std::move(n));
+      } else if (f.func2 && args.size() == 2) {
+        auto n = std::make_unique<Node>(OpCode::CALL2);
+        n->ins.func2 = f.func2;
+        n->args = std::move(args);
+
+        return fold(std::move(n));
+      }
+    }
+
+    throw RuntimeError("Unsupported function math.{}() with {} arguments: {}",
+                       name, args.size(), str);
+  }
+
+public:
+  Parser(const std::string &s, SignalList::Ptr sigs, bool names)
+      : str(s), pos(0), signals(sigs), useNames(names) {
+    next();
+  }
+
+  NodePtr parse() {
+    auto n = parseAdditive();
+
+    if (tok.type != Token::Type::END)
+      throw RuntimeError("Unexpected token '{}' in expression: {}", tok.text,
+                         str);
+
+    return n;
+  }
+};
+
+} // namespace
+
+std::string Expression::Instruction::toString() const {
+  switch (op) {
+  case OpCode::CONST:
+    return fmt::format("r{} = {}", dst, value);
+
+  case OpCode::LOAD_FLOAT:
+  case OpCode::LOAD_INTEGER:
+    return fmt::format("r{} = data[{}]", dst, index);
+
+  case OpCode::LOAD_SEQUENCE:
+    return fmt::format("r{} = sequence", dst);
+
+  case OpCode::LOAD_FLAGS:
+    return fmt::format("r{} = flags", dst);
+
+  case OpCode::LOAD_TS:
+    return fmt::format("r{} = {}[{}]", dst,
+                       index < 2 ? "ts_origin" : "ts_received", index % 2);
+
+  case OpCode::NEG:
+    return fmt::format("r{} = -r{}", dst, a);
+
+  case OpCode::ADD:
+    return fmt::format("r{} = r{} + r{}", dst, a, b);
+
+  case OpCode::SUB:
+    return fmt::format("r{} = r{} - r{}", dst, a, b);
+
+  case OpCode::MUL:
+    return fmt::format("r{} = r{} * r{}", dst, a, b);
+
+  case OpCode::DIV:
+    return fmt::format("r{} = r{} / r{}", dst, a, b);
+
+  case OpCode::MOD:
+    return fmt::format("r{} = r{} % r{}", dst, a, b);
+
+  case OpCode::POW:
+    return fmt::format("r{} = r{} ^ r{}", dst, a, b);
+
+  case OpCode::MIN:
+    return fmt::format("r{} = min(r{}, r{})", dst, a, b);
+
+  case OpCode::MAX:
+    return fmt::format("r{} = max(r{}, r{})", dst, a, b);
+
+  case OpCode::CALL1:
+    return fmt::format("r{} = call(r{})", dst, a);
+
+  case OpCode::CALL2:
+    return fmt::format("r{} = call(r{}, r{})", dst, a, b);
+  }
+
+  return "unknown";
+}
+
+Expression::Expression(const std::string &expr, SignalList::Ptr signals,
+                       bool useNames)
+    : expression(expr), registers(0) {
+  Parser parser(expression, signals, useNames);
+
+  auto root = parser.parse();
+
+  // Emit the operands of each node into consecutive registers
+  std::function<void(const Node &, unsigned)> emit = [&](const Node &n,
+                                                         unsigned reg) {
+    if (reg > UINT8_MAX)
+      throw RuntimeError("Expression is nested too deeply: {}", expression);
+
+    if (reg >= registers)
+      registers = reg + 1;
+
+    Instruction ins = n.ins;
+    ins.dst = ins.a = ins.b = reg;
+
+    if (n.args.size() > 0)
+      emit(*n.args[0], reg);
+
+    if (n.args.size() > 1) {
+      emit(*n.args[1], reg + 1);
+      ins.b = reg + 1;
+    }
+
+    program.push_back(ins);
+  };
+
+  emit(*root, 0);
+}
+
+double Expression::evaluate(const struct Sample *smp) const {
+  double r[registers];
+
+  for (auto &ins : program) {
+    switch (ins.op) {
+    case OpCode::CONST:
+      r[ins.dst] = ins.value;
+      break;
+
+    case OpCode::LOAD_FLOAT:
+    case OpCode::LOAD_INTEGER:
+      if (!(smp->flags & (int)SampleFlags::HAS_DATA) ||
+          ins.index >= smp->length)
+        throw RuntimeError("Signal {} is missing in sample for expression: {}",
+                           ins.index, expression);
+
+      r[ins.dst] = ins.op == OpCode::LOAD_FLOAT ? smp->data[ins.index].f
+                                                : smp->data[ins.index].i;
+      break;
+
+    case OpCode::LOAD_SEQUENCE:
+      if (!(smp->flags & (int)SampleFlags::HAS_SEQUENCE))
+        throw RuntimeError("Sequence is missing in sample for expression: {}",
+                           expression);
+
+      r[ins.dst] = smp->sequence;
+      break;
+
+    case OpCode::LOAD_FLAGS:
+      r[ins.dst] = smp->flags;
+      break;
+
+    case OpCode::LOAD_TS: {
+      auto flag = ins.index < 2 ? SampleFlags::HAS_TS_ORIGIN
+                                : SampleFlags::HAS_TS_RECEIVED;
+      auto &ts = ins.index < 2 ? smp->ts.origin : smp->ts.received;
+
+      if (!(smp->flags & (int)flag))
+        throw RuntimeError("Timestamp is missing in sample for expression: {}",
+                           expression);
+
+      r[ins.dst] = ins.index % 2 ? ts.tv_nsec : ts.tv_sec;
+      break;
+    }
+
+    default:
+      r[ins.dst] = calculate(ins, r[ins.a], r[ins.b]);
+    }
+  }
+
+  return r[0];
+}
+
+std::string Expression::toString() const {
+  std::string str;
+
+  for (auto it = program.begin(); it != program.end(); ++it)
+    str += (it == program.begin() ? "" : "; ") + it->toString();
+
+  return str;
+}
@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <villas/exceptions.hpp>
 #include <villas/format.hpp>
@@ -52,7 +53,9 @@ Format *FormatFactory::make(const std::string &format) {
   return ff->make();
 }
 
-Format::Format(int fl) : flags(fl), real_precision(17), signals(nullptr) {
+Format::Format(int fl)
+    : flags(fl), real_precision(17),
+      stream{nullptr, -1, 0, 0, false, false, false, 0}, signals(nullptr) {
   in.buflen = out.buflen = DEFAULT_FORMAT_BUFFER_LENGTH;
 
   in.buffer = new char[in.buflen];
@@ -98,12 +101,210 @@ int Format::print(FILE *f, const struct Sample *const smps[], unsigned cnt) {
   return ret;
 }
 
-int Format::scan(FILE *f, struct Sample *const smps[], unsigned cnt) {
-  size_t bytes, rbytes;
+int Format::sprintv(char *buf, size_t len, size_t *wbytes, struct iovec iov[],
+                    size_t *iovcnt, const struct Sample *const smps[],
+                    unsigned cnt) {
+  int ret;
+  size_t bytes = 0;
+
+  if (*iovcnt < 1)
+    return -1;
+
+  ret = sprint(buf, len, &bytes, smps, cnt);
+  if (ret < 0)
+    return ret;
+
+  iov[0].iov_base = buf;
+  iov[0].iov_len = MIN(bytes, len);
+  *iovcnt = 1;
+
+  if (wbytes)
+    *wbytes = bytes;
 
-  bytes = fread(in.buffer, 1, in.buflen, f);
+  return ret;
+}
+
+#ifdef __GLIBC__
+/* The scanner reads from the file descriptor directly, as fread() would
+ * block until the whole buffer has been filled. Data which stdio has already
+ * read ahead is taken over from the private fields of glibc's FILE.
+ */
+static size_t stdio_readahead(FILE *f) {
+  if (f->_IO_read_ptr < f->_IO_read_end)
+    return f->_IO_read_end - f->_IO_read_ptr;
 
-  return sscan(in.buffer, bytes, &rbytes, smps, cnt);
+  return 0;
+}
+
+static off_t stream_tell(FILE *f) { return lseek(fileno(f), 0, SEEK_CUR); }
+
+static ssize_t stream_read(FILE *f, char *buf, size_t len) {
+  ssize_t bytes;
+
+  do {
+    bytes = read(fileno(f), buf, len);
+  } while (bytes < 0 && errno == EINTR);
+
+  return bytes;
+}
+#else
+/* Other C libraries do not expose the read-ahead of stdio.
+ * Hence, the scanner reads via stdio.
+ */
+static size_t stdio_readahead(FILE *f) { return 0; }
+
+static off_t stream_tell(FILE *f) { return ftello(f); }
+
+static ssize_t stream_read(FILE *f, char *buf, size_t len) {
+  size_t bytes = fread(buf, 1, len, f);
+  if (bytes == 0 && ferror(f)) {
+    clearerr(f);
+    return -1;
+  }
+
+  return bytes;
+}
+#endif // __GLIBC__
+
+void Format::syncStream(FILE *f) {
+  // We detect a rewind() or fseek() by comparing the position of the stream
+  off_t offset = stream_tell(f);
+  if (f == stream.file && offset == stream.offset)
+    return;
+
+  if (in.buflen < DEFAULT_FORMAT_STREAM_BUFFER_LENGTH) {
+    delete[] in.buffer;
+
+    in.buflen = DEFAULT_FORMAT_STREAM_BUFFER_LENGTH;
+    in.buffer = new char[in.buflen];
+  }
+
+  stream.file = f;
+  stream.offset = offset;
+  stream.head = 0;
+  stream.tail = 0;
+  stream.eof = false;
+  stream.truncated = false;
+  stream.skip = 0;
+
+  /* Take over the data which has already been buffered by stdio, e.g. if
+   * the caller has read a header line with fgets(). This does not block,
+   * as fread() is served from the buffer. */
+  size_t buffered = stdio_readahead(f);
+  if (buffered > 0) {
+    if (buffered + 1 > in.buflen) {
+      delete[] in.buffer;
+
+      in.buflen = buffered + 1;
+      in.buffer = new char[in.buflen];
+    }
+
+    stream.tail = fread(in.buffer, 1, buffered, f);
+  }
+
+  in.buffer[stream.tail] = '\0';
+}
+
+ssize_t Format::fillStream(FILE *f) {
+  ssize_t bytes;
+
+  /* Move the remaining incomplete record to the beginning of the buffer.
+   * We only get here if the buffer does not contain any complete record,
+   * so this copies at most a single record per refill. */
+  if (stream.head > 0) {
+    memmove(in.buffer, in.buffer + stream.head, stream.tail - stream.head);
+
+    stream.tail -= stream.head;
+    stream.head = 0;
+  }
+
+  // Grow the buffer if a single record does not fit
+  if (stream.tail + 1 >= in.buflen) {
+    auto *buffer = new char[2 * in.buflen];
+
+    memcpy(buffer, in.buffer, stream.tail);
+    delete[] in.buffer;
+
+    in.buffer = buffer;
+    in.buflen *= 2;
+  }
+
+  bytes = stream_read(f, in.buffer + stream.tail, in.buflen - stream.tail - 1);
+  if (bytes < 0)
+    return errno == EAGAIN ? 0 : -1;
+
+  stream.eof = bytes == 0;
+  stream.tail += bytes;
+
+  if (stream.offset >= 0)
+    stream.offset += bytes;
+
+  in.buffer[stream.tail] = '\0';
+
+  return bytes;
+}
+
+bool Format::eof(FILE *f) const {
+  // Without glibc, stdio reaches the end before the scanner does
+  if (f != stream.file)
+    return feof(f);
+
+  if (!stream.eof)
+    return false;
+
+  // The stream might have been rewound in the meantime
+  if (stream_tell(f) != stream.offset)
+    return false;
+
+  return stream.head == stream.tail || stream.truncated;
+}
+
+int Format::scan(FILE *f, struct Sample *const smps[], unsigned cnt) {
+  int ret;
+  ssize_t bytes;
+  size_t rbytes;
+
+  if (cnt == 0)
+    return 0;
+
+  syncStream(f);
+
+  stream.active = true;
+
+  while (true) {
+    if (stream.tail > stream.head) {
+      ret = sscan(in.buffer + stream.head, stream.tail - stream.head, &rbytes,
+                  smps, cnt);
+      if (ret > 0) {
+        stream.head += rbytes;
+        break;
+      } else if (ret == 0 && rbytes > 0) {
+        stream.head += rbytes; // Only skipped records
+        continue;
+      } else if (ret < 0 && ret != NEED_MORE) {
+        // We can not resynchronize, so we drop the buffered data
+        stream.head = stream.tail;
+        break;
+      }
+    }
+
+    // The buffer is empty or ends with an incomplete record
+    bytes = fillStream(f);
+    if (bytes < 0) {
+      ret = -1;
+      break;
+    } else if (bytes == 0) {
+      stream.truncated = stream.tail > stream.head;
+      ret = 0;
+      break;
+    }
+
+    stream.truncated = false;
+  }
+
+  stream.active = false;
+
+  return ret;
 }
 
 void Format::parse(json_t *json) {
@@ -115,20 +316,24 @@ void Format::parse(json_t *json) {
   int sequence = -1;
   int data = -1;
   int offset = -1;
+  int precision = real_precision;
 
   ret = json_unpack_ex(json, &err, 0,
                        "{ s?: b, s?: b, s?: b, s?: b, s?: b, s?: i }",
                        "ts_origin", &ts_origin, "ts_received", &ts_received,
                        "sequence", &sequence, "data", &data, "offset", &offset,
-                       "real_precision", &real_precision);
+                       "real_precision", &precision);
   if (ret)
     throw ConfigError(json, err, "node-config-format",
                       "Failed to parse format configuration");
 
-  if (real_precision < 0 || real_precision > 31)
+  // A precision of -1 selects the shortest round-trip representation
+  if (precision < -1 || precision > 31)
     throw ConfigError(json, err, "node-config-format-precision",
                       "The valid range for the real_precision setting is "
-                      "between 0 and 31 (inclusive)");
+                      "between -1 and 31 (inclusive)");
+
+  real_precision = precision;
 
   if (ts_origin == 0)
     flags &= ~(int)SampleFlags::HAS_TS_ORIGIN;
@@ -0,0 +1,818 @@
+/* Apache Arrow IPC stream format.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <arrow/util/compression.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/formats/arrow.hpp>
+#include <villas/sample.hpp>
+#include <villas/signal.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+namespace {
+
+// An Arrow output stream which writes to a stdio stream.
+class StdioOutputStream : public arrow::io::OutputStream {
+
+protected:
+  FILE *file;
+  int64_t position;
+  bool is_closed;
+
+public:
+  StdioOutputStream(FILE *f) : file(f), position(0), is_closed(false) {}
+
+  using arrow::io::OutputStream::Write;
+
+  arrow::Status Write(const void *data, int64_t nbytes) override {
+    if (fwrite(data, 1, nbytes, file) != (size_t)nbytes)
+      return arrow::Status::IOError("Failed to write to stream: ",
+                                    strerror(errno));
+
+    position += nbytes;
+
+    return arrow::Status::OK();
+  }
+
+  // The stdio stream is owned and closed by the caller
+  arrow::Status Close() override {
+    is_closed = true;
+
+    return arrow::Status::OK();
+  }
+
+  bool closed() const override { return is_closed; }
+
+  arrow::Result<int64_t> Tell() const override { return position; }
+};
+
+/* An Arrow input stream which reads from a file descriptor.
+ *
+ * Unlike arrow::io::ReadableFile, this also supports pipes.
+ */
+class FdInputStream : public arrow::io::InputStream {
+
+protected:
+  int fd;
+  int64_t position;
+  bool is_closed;
+
+public:
+  FdInputStream(int f) : fd(f), position(0), is_closed(false) {}
+
+  arrow::Result<int64_t> Read(int64_t nbytes, void *out) override {
+    int64_t total = 0;
+
+    // Short reads are only allowed at the end of the stream
+    while (total < nbytes) {
+      ssize_t bytes = read(fd, (char *)out + total, nbytes - total);
+      if (bytes < 0) {
+        if (errno == EINTR)
+          continue;
+
+        return arrow::Status::IOError("Failed to read from stream: ",
+                                      strerror(errno));
+      } else if (bytes == 0)
+        break;
+
+      total += bytes;
+    }
+
+    position += total;
+
+    return total;
+  }
+
+  arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(nbytes));
+    ARROW_ASSIGN_OR_RAISE(auto bytes, Read(nbytes, buffer->mutable_data()));
+    ARROW_RETURN_NOT_OK(buffer->Resize(bytes, false));
+
+    return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+  }
+
+  // The file descriptor is owned and closed by the caller
+  arrow::Status Close() override {
+    is_closed = true;
+
+    return arrow::Status::OK();
+  }
+
+  bool closed() const override { return is_closed; }
+
+  arrow::Result<int64_t> Tell() const override { return position; }
+};
+
+} // namespace
+
+static std::shared_ptr<arrow::DataType> toArrowType(enum SignalType type) {
+  switch (type) {
+  case SignalType::FLOAT:
+    return arrow::float64();
+
+  case SignalType::INTEGER:
+    return arrow::int64();
+
+  case SignalType::BOOLEAN:
+    return arrow::boolean();
+
+  case SignalType::COMPLEX:
+    return arrow::struct_({arrow::field("real", arrow::float32(), false),
+                           arrow::field("imag", arrow::float32(), false)});
+
+  default:
+    return nullptr;
+  }
+}
+
+static int64_t toNanoseconds(const struct timespec &ts) {
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static struct timespec fromNanoseconds(int64_t ns) {
+  struct timespec ts;
+
+  ts.tv_sec = ns / 1000000000LL;
+  ts.tv_nsec = ns % 1000000000LL;
+
+  if (ts.tv_nsec < 0) {
+    ts.tv_sec--;
+    ts.tv_nsec += 1000000000LL;
+  }
+
+  return ts;
+}
+
+ArrowFormat::ArrowFormat(int fl)
+    : BinaryFormat(fl), batch_size(1024),
+      compression(arrow::Compression::UNCOMPRESSED) {
+  output.file = nullptr;
+  output.pending = 0;
+
+  replay.map = nullptr;
+  replay.maplen = 0;
+  replay.start = 0;
+  replay.batches = 0;
+  replay.row = 0;
+}
+
+ArrowFormat::~ArrowFormat() { closeReplay(); }
+
+void ArrowFormat::start() {
+  arrow::FieldVector fields;
+
+  auto ts_type = arrow::timestamp(arrow::TimeUnit::NANO);
+
+  if (flags & (int)SampleFlags::HAS_TS_ORIGIN)
+    fields.push_back(arrow::field("ts_origin", ts_type));
+
+  if (flags & (int)SampleFlags::HAS_TS_RECEIVED)
+    fields.push_back(arrow::field("ts_received", ts_type));
+
+  if (flags & (int)SampleFlags::HAS_SEQUENCE)
+    fields.push_back(arrow::field("sequence", arrow::uint64()));
+
+  if (flags & (int)SampleFlags::HAS_DATA) {
+    for (unsigned i = 0; i < signals->size(); i++) {
+      auto sig = signals->getByIndex(i);
+
+      auto type = toArrowType(sig->type);
+      if (!type)
+        throw RuntimeError("Signal type {} is not supported by arrow format",
+                           signalTypeToString(sig->type));
+
+      auto name = sig->name.empty() ? fmt::format("signal{}", i) : sig->name;
+      auto metadata =
+          sig->unit.empty()
+              ? nullptr
+              : arrow::key_value_metadata({"unit"}, {sig->unit});
+
+      fields.push_back(arrow::field(name, type, true, metadata));
+    }
+  }
+
+  schema = arrow::schema(fields);
+
+  auto builder = arrow::RecordBatchBuilder::Make(
+      schema, arrow::default_memory_pool(), batch_size);
+  if (!builder.ok())
+    throw RuntimeError("Failed to create record batch builder: {}",
+                       builder.status().ToString());
+
+  output.builder = std::move(builder).ValueUnsafe();
+  output.pending = 0;
+}
+
+void ArrowFormat::parse(json_t *json) {
+  int ret;
+  json_error_t err;
+
+  int bs = -1;
+  const char *comp = nullptr;
+
+  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: s }", "batch_size", &bs,
+                       "compression", &comp);
+  if (ret)
+    throw ConfigError(json, err, "node-config-format-arrow",
+                      "Failed to parse format configuration");
+
+  if (bs == 0)
+    throw ConfigError(json, "node-config-format-arrow-batch-size",
+                      "The batch size must be larger than zero");
+  else if (bs > 0)
+    batch_size = bs;
+
+  if (comp) {
+    // The IPC format supports only a subset of the codecs
+    if (!strcmp(comp, "none"))
+      compression = arrow::Compression::UNCOMPRESSED;
+    else if (!strcmp(comp, "lz4"))
+      compression = arrow::Compression::LZ4_FRAME;
+    else if (!strcmp(comp, "zstd"))
+      compression = arrow::Compression::ZSTD;
+    else
+      throw ConfigError(json, "node-config-format-arrow-compression",
+                        "Invalid compression: {}", comp);
+
+    if (!arrow::util::Codec::IsAvailable(compression))
+      throw ConfigError(json, "node-config-format-arrow-compression",
+                        "Compression {} is not supported by libarrow", comp);
+  }
+
+  Format::parse(json);
+}
+
+arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchWriter>>
+ArrowFormat::makeWriter(std::shared_ptr<arrow::io::OutputStream> sink) {
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+
+  if (compression != arrow::Compression::UNCOMPRESSED) {
+    ARROW_ASSIGN_OR_RAISE(options.codec,
+                          arrow::util::Codec::Create(compression));
+  }
+
+  return arrow::ipc::MakeStreamWriter(sink, schema, options);
+}
+
+arrow::Status ArrowFormat::appendSample(arrow::RecordBatchBuilder *builder,
+                                        const struct Sample *smp) {
+  int col = 0;
+
+  if (flags & (int)SampleFlags::HAS_TS_ORIGIN) {
+    auto *b = builder->GetFieldAs<arrow::TimestampBuilder>(col++);
+
+    ARROW_RETURN_NOT_OK(smp->flags & (int)SampleFlags::HAS_TS_ORIGIN
+                            ? b->Append(toNanoseconds(smp->ts.origin))
+                            : b->AppendNull());
+  }
+
+  if (flags & (int)SampleFlags::HAS_TS_RECEIVED) {
+    auto *b = builder->GetFieldAs<arrow::TimestampBuilder>(col++);
+
+    ARROW_RETURN_NOT_OK(smp->flags & (int)SampleFlags::HAS_TS_RECEIVED
+                            ? b->Append(toNanoseconds(smp->ts.received))
+                            : b->AppendNull());
+  }
+
+  if (flags & (int)SampleFlags::HAS_SEQUENCE) {
+    auto *b = builder->GetFieldAs<arrow::UInt64Builder>(col++);
+
+    ARROW_RETURN_NOT_OK(smp->flags & (int)SampleFlags::HAS_SEQUENCE
+                            ? b->Append(smp->sequence)
+                            : b->AppendNull());
+  }
+
+  if (flags & (int)SampleFlags::HAS_DATA) {
+    for (unsigned i = 0; i < signals->size(); i++) {
+      auto *b = builder->GetField(col++);
+
+      // Missing values are stored as nulls
+      if (i >= smp->length) {
+        ARROW_RETURN_NOT_OK(b->AppendNull());
+        continue;
+      }
+
+      const auto &data = smp->data[i];
+
+      switch ((*signals)[i]->type) {
+      case SignalType::FLOAT:
+        ARROW_RETURN_NOT_OK(
+            static_cast<arrow::DoubleBuilder *>(b)->Append(data.f));
+        break;
+
+      case SignalType::INTEGER:
+        ARROW_RETURN_NOT_OK(
+            static_cast<arrow::Int64Builder *>(b)->Append(data.i));
+        break;
+
+      case SignalType::BOOLEAN:
+        ARROW_RETURN_NOT_OK(
+            static_cast<arrow::BooleanBuilder *>(b)->Append(data.b));
+        break;
+
+      case SignalType::COMPLEX: {
+        auto *sb = static_cast<arrow::StructBuilder *>(b);
+        auto *real = static_cast<arrow::FloatBuilder *>(sb->field_builder(0));
+        auto *imag = static_cast<arrow::FloatBuilder *>(sb->field_builder(1));
+
+        ARROW_RETURN_NOT_OK(sb->Append());
+        ARROW_RETURN_NOT_OK(real->Append(std::real(data.z)));
+        ARROW_RETURN_NOT_OK(imag->Append(std::imag(data.z)));
+        break;
+      }
+
+      default:
+        return arrow::Status::NotImplemented("Unsupported signal type");
+      }
+    }
+  }
+
+  return arrow::Status::OK();
+}
+
+arrow::Result<ArrowFormat::Columns>
+ArrowFormat::resolveColumns(const std::shared_ptr<arrow::Schema> &sch) const {
+  Columns cols = {-1, -1, -1, {}};
+
+  auto ts_type = arrow::timestamp(arrow::TimeUnit::NANO);
+
+  for (int i = 0; i < sch->num_fields(); i++) {
+    auto field = sch->field(i);
+    auto &name = field->name();
+
+    if (name == "ts_origin" || name == "ts_received") {
+      if (!field->type()->Equals(ts_type))
+        return arrow::Status::TypeError("Column ", name, " has invalid type ",
+                                        field->type()->ToString());
+
+      (name == "ts_origin" ? cols.ts_origin : cols.ts_received) = i;
+    } else if (name == "sequence") {
+      if (!field->type()->Equals(arrow::uint64()))
+        return arrow::Status::TypeError("Column ", name, " has invalid type ",
+                                        field->type()->ToString());
+
+      cols.sequence = i;
+    } else {
+      // All other columns are mapped to the signals in the order of appearance
+      unsigned j = cols.data.size();
+      if (j >= signals->size())
+        continue;
+
+      auto sig = signals->getByIndex(j);
+      if (!field->type()->Equals(toArrowType(sig->type)))
+        return arrow::Status::TypeError(
+            "Column ", name, " has type ", field->type()->ToString(),
+            ", expected ", signalTypeToString(sig->type), " for signal ",
+            sig->name, " (index ", j, ")");
+
+      cols.data.push_back(i);
+    }
+  }
+
+  return cols;
+}
+
+void ArrowFormat::unpackSample(
+    const std::vector<std::shared_ptr<arrow::Array>> &arrays,
+    const Columns &cols, int64_t row, struct Sample *smp) {
+  smp->signals = signals;
+  smp->flags = 0;
+  smp->length = 0;
+
+  if (cols.ts_origin >= 0) {
+    auto *a = static_cast<const arrow::TimestampArray *>(
+        arrays[cols.ts_origin].get());
+
+    if (!a->IsNull(row)) {
+      smp->ts.origin = fromNanoseconds(a->Value(row));
+      smp->flags |= (int)SampleFlags::HAS_TS_ORIGIN;
+    }
+  }
+
+  if (cols.ts_received >= 0) {
+    auto *a = static_cast<const arrow::TimestampArray *>(
+        arrays[cols.ts_received].get());
+
+    if (!a->IsNull(row)) {
+      smp->ts.received = fromNanoseconds(a->Value(row));
+      smp->flags |= (int)SampleFlags::HAS_TS_RECEIVED;
+    }
+  }
+
+  if (cols.sequence >= 0) {
+    auto *a =
+        static_cast<const arrow::UInt64Array *>(arrays[cols.sequence].get());
+
+    if (!a->IsNull(row)) {
+      smp->sequence = a->Value(row);
+      smp->flags |= (int)SampleFlags::HAS_SEQUENCE;
+    }
+  }
+
+  for (unsigned i = 0; i < cols.data.size() && i < smp->capacity; i++) {
+    auto *a = arrays[cols.data[i]].get();
+    auto &data = smp->data[i];
+
+    // The values of a sample end with the first null
+    if (a->IsNull(row))
+      break;
+
+    switch ((*signals)[i]->type) {
+    case SignalType::FLOAT:
+      data.f = static_cast<const arrow::DoubleArray *>(a)->Value(row);
+      break;
+
+    case SignalType::INTEGER:
+      data.i = static_cast<const arrow::Int64Array *>(a)->Value(row);
+      break;
+
+    case SignalType::BOOLEAN:
+      data.b = static_cast<const arrow::BooleanArray *>(a)->Value(row);
+      break;
+
+    case SignalType::COMPLEX: {
+      auto *sa = static_cast<const arrow::StructArray *>(a);
+      auto *real = static_cast<const arrow::FloatArray *>(sa->field(0).get());
+      auto *imag = static_cast<const arrow::FloatArray *>(sa->field(1).get());
+
+      data.z = std::complex<float>(real->Value(row), imag->Value(row));
+      break;
+    }
+
+    default:
+      break;
+    }
+
+    smp->length++;
+  }
+
+  if (smp->length > 0)
+    smp->flags |= (int)SampleFlags::HAS_DATA;
+}
+
+arrow::Status
+ArrowFormat::writeSamples(std::shared_ptr<arrow::io::OutputStream> sink,
+                          const struct Sample *const smps[], unsigned cnt) {
+  ARROW_ASSIGN_OR_RAISE(auto builder,
+                        arrow::RecordBatchBuilder::Make(
+                            schema, arrow::default_memory_pool(), cnt));
+
+  for (unsigned i = 0; i < cnt; i++)
+    ARROW_RETURN_NOT_OK(appendSample(builder.get(), smps[i]));
+
+  ARROW_ASSIGN_OR_RAISE(auto batch, builder->Flush());
+  ARROW_ASSIGN_OR_RAISE(auto writer, makeWriter(sink));
+
+  ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
+
+  return writer->Close();
+}
+
+arrow::Result<unsigned>
+ArrowFormat::readSamples(std::shared_ptr<arrow::io::InputStream> source,
+                         struct Sample *const smps[], unsigned cnt) {
+  std::shared_ptr<arrow::RecordBatch> batch;
+  unsigned i = 0;
+
+  ARROW_ASSIGN_OR_RAISE(auto reader,
+                        arrow::ipc::RecordBatchStreamReader::Open(source));
+  ARROW_ASSIGN_OR_RAISE(auto cols, resolveColumns(reader->schema()));
+
+  while (i < cnt) {
+    ARROW_RETURN_NOT_OK(reader->ReadNext(&batch));
+    if (!batch)
+      break;
+
+    auto arrays = batch->columns();
+
+    for (int64_t row = 0; row < batch->num_rows() && i < cnt; row++)
+      unpackSample(arrays, cols, row, smps[i++]);
+  }
+
+  return i;
+}
+
+int ArrowFormat::sprint(char *buf, size_t len, size_t *wbytes,
+                        const struct Sample *const smps[], unsigned cnt) {
+  // Each buffer contains a complete IPC stream including the schema
+  auto sink = std::make_shared<arrow::io::FixedSizeBufferWriter>(
+      std::make_shared<arrow::MutableBuffer>((uint8_t *)buf, len));
+
+  auto status = writeSamples(sink, smps, cnt);
+  if (!status.ok()) {
+    logger->warn("Failed to serialize samples: {}", status.ToString());
+    return -1;
+  }
+
+  if (wbytes)
+    *wbytes = sink->Tell().ValueOr(0);
+
+  return cnt;
+}
+
+int ArrowFormat::sscan(const char *buf, size_t len, size_t *rbytes,
+                       struct Sample *const smps[], unsigned cnt) {
+  // The record batches reference the buffer without copying it
+  auto source = std::make_shared<arrow::io::BufferReader>(
+      std::make_shared<arrow::Buffer>((const uint8_t *)buf, len));
+
+  auto ret = readSamples(source, smps, cnt);
+  if (!ret.ok()) {
+    logger->warn("Failed to parse samples: {}", ret.status().ToString());
+    return -1;
+  }
+
+  if (rbytes)
+    *rbytes = source->Tell().ValueOr(len);
+
+  return *ret;
+}
+
+arrow::Status ArrowFormat::writeBatch() {
+  if (output.pending == 0)
+    return arrow::Status::OK();
+
+  ARROW_ASSIGN_OR_RAISE(auto batch, output.builder->Flush());
+
+  output.pending = 0;
+
+  return output.writer->WriteRecordBatch(*batch);
+}
+
+int ArrowFormat::print(FILE *f, const struct Sample *const smps[],
+                       unsigned cnt) {
+  arrow::Status status;
+
+  if (f != output.file || !output.writer) {
+    if (output.file)
+      finish(output.file);
+
+    auto writer = makeWriter(std::make_shared<StdioOutputStream>(f));
+    if (!writer.ok()) {
+      logger->warn("Failed to start stream: {}", writer.status().ToString());
+      return -1;
+    }
+
+    output.writer = *writer;
+    output.file = f;
+  }
+
+  for (unsigned i = 0; i < cnt; i++) {
+    status = appendSample(output.builder.get(), smps[i]);
+    if (!status.ok())
+      goto error;
+
+    if (++output.pending >= batch_size) {
+      status = writeBatch();
+      if (!status.ok())
+        goto error;
+    }
+  }
+
+  return cnt;
+
+error:
+  logger->warn("Failed to write samples: {}", status.ToString());
+  return -1;
+}
+
+int ArrowFormat::finish(FILE *f) {
+  if (f != output.file || !output.writer)
+    return 0;
+
+  // Write the remaining samples and the end-of-stream marker
+  auto status = writeBatch();
+  if (status.ok())
+    status = output.writer->Close();
+
+  output.writer.reset();
+  output.file = nullptr;
+
+  if (!status.ok()) {
+    logger->warn("Failed to finish stream: {}", status.ToString());
+    return -1;
+  }
+
+  return 0;
+}
+
+void ArrowFormat::closeReplay() {
+  replay.arrays.clear();
+  replay.batch.reset();
+  replay.reader.reset();
+  replay.source.reset();
+
+  if (replay.map) {
+    munmap(replay.map, replay.maplen);
+
+    replay.map = nullptr;
+    replay.maplen = 0;
+  }
+}
+
+arrow::Status ArrowFormat::openReplay(FILE *f) {
+  struct stat st;
+  int fd = fileno(f);
+
+  closeReplay();
+
+  if (fstat(fd, &st))
+    return arrow::Status::IOError("Failed to stat stream: ", strerror(errno));
+
+  off_t offset = lseek(fd, 0, SEEK_CUR);
+
+  if (S_ISREG(st.st_mode)) {
+    if (st.st_size > 0) {
+      replay.map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (replay.map == MAP_FAILED) {
+        replay.map = nullptr;
+        return arrow::Status::IOError("Failed to map file: ", strerror(errno));
+      }
+
+      replay.maplen = st.st_size;
+    }
+
+    auto source = std::make_shared<arrow::io::BufferReader>(
+        std::make_shared<arrow::Buffer>((const uint8_t *)replay.map,
+                                        replay.maplen));
+
+    ARROW_RETURN_NOT_OK(source->Seek(std::min<int64_t>(offset, st.st_size)));
+
+    replay.source = source;
+
+    /* The file descriptor is moved behind the mapped data. This allows us
+     * to detect a rewind() or fseek() of the stream. */
+    offset = lseek(fd, 0, SEEK_END);
+  } else {
+    // Pipes are read sequentially
+    ARROW_ASSIGN_OR_RAISE(replay.source,
+                          arrow::io::BufferedInputStream::Create(
+                              1 << 16, arrow::default_memory_pool(),
+                              std::make_shared<FdInputStream>(fd)));
+  }
+
+  stream.file = f;
+  stream.offset = offset;
+  stream.head = 0;
+  stream.tail = 0;
+  stream.eof = false;
+  stream.truncated = false;
+
+  replay.row = 0;
+  replay.batches = 0;
+  ARROW_ASSIGN_OR_RAISE(replay.start, replay.source->Tell());
+
+  return arrow::Status::OK();
+}
+
+arrow::Status ArrowFormat::remapReplay() {
+  struct stat st;
+  int fd = fileno(stream.file);
+
+  if (fstat(fd, &st))
+    return arrow::Status::IOError("Failed to stat stream: ", strerror(errno));
+
+  if (!S_ISREG(st.st_mode) || (size_t)st.st_size <= replay.maplen)
+    return arrow::Status::OK();
+
+  /* The file has grown. As we can not resume the current IPC stream without
+   * its schema, we restart it and skip the batches which we already read. */
+  bool in_stream = replay.reader != nullptr;
+  auto start = replay.start;
+  auto batches = replay.batches;
+
+  ARROW_ASSIGN_OR_RAISE(auto position, replay.source->Tell());
+  ARROW_RETURN_NOT_OK(openReplay(stream.file));
+
+  auto *source = static_cast<arrow::io::BufferReader *>(replay.source.get());
+  if (!in_stream)
+    return source->Seek(position);
+
+  ARROW_RETURN_NOT_OK(source->Seek(start));
+
+  replay.start = start;
+
+  ARROW_ASSIGN_OR_RAISE(
+      replay.reader, arrow::ipc::RecordBatchStreamReader::Open(replay.source));
+  ARROW_ASSIGN_OR_RAISE(replay.columns,
+                        resolveColumns(replay.reader->schema()));
+
+  for (replay.batches = 0; replay.batches < batches; replay.batches++)
+    ARROW_RETURN_NOT_OK(replay.reader->ReadNext(&replay.batch));
+
+  replay.batch.reset();
+
+  return arrow::Status::OK();
+}
+
+arrow::Status ArrowFormat::nextBatch() {
+  bool remapped = false;
+
+  replay.arrays.clear();
+  replay.batch.reset();
+  replay.row = 0;
+
+  while (true) {
+    if (!replay.reader) {
+      // Appending to a file starts a new IPC stream
+      ARROW_ASSIGN_OR_RAISE(auto next, replay.source->Peek(1));
+      if (next.empty()) {
+        if (!remapped) {
+          remapped = true;
+          ARROW_RETURN_NOT_OK(remapReplay());
+          continue;
+        }
+
+        stream.eof = true;
+        return arrow::Status::OK();
+      }
+
+      ARROW_ASSIGN_OR_RAISE(replay.start, replay.source->Tell());
+      ARROW_ASSIGN_OR_RAISE(
+          replay.reader,
+          arrow::ipc::RecordBatchStreamReader::Open(replay.source));
+      ARROW_ASSIGN_OR_RAISE(replay.columns,
+                            resolveColumns(replay.reader->schema()));
+
+      replay.batches = 0;
+    }
+
+    ARROW_RETURN_NOT_OK(replay.reader->ReadNext(&replay.batch));
+    if (replay.batch) {
+      replay.batches++;
+
+      if (replay.batch->num_rows() == 0)
+        continue;
+
+      replay.arrays = replay.batch->columns();
+
+      return arrow::Status::OK();
+    }
+
+    // The end of a stream might be followed by further appended streams
+    if (!remapped) {
+      remapped = true;
+      ARROW_RETURN_NOT_OK(remapReplay());
+      if (replay.reader)
+        continue;
+    }
+
+    replay.reader.reset();
+  }
+}
+
+int ArrowFormat::scan(FILE *f, struct Sample *const smps[], unsigned cnt) {
+  arrow::Status status;
+  unsigned i = 0;
+
+  if (f != stream.file || lseek(fileno(f), 0, SEEK_CUR) != stream.offset) {
+    status = openReplay(f);
+    if (!status.ok())
+      goto error;
+  } else if (stream.eof && !stream.truncated)
+    stream.eof = false; // Check if more data has been appended
+
+  while (i < cnt && !stream.eof) {
+    if (replay.batch && replay.row < replay.batch->num_rows()) {
+      unpackSample(replay.arrays, replay.columns, replay.row++, smps[i++]);
+      continue;
+    }
+
+    status = nextBatch();
+    if (!status.ok())
+      goto error;
+  }
+
+  return i;
+
+error:
+  logger->warn("Failed to read samples: {}", status.ToString());
+
+  // We can not resynchronize, so we stop at the broken record
+  stream.eof = true;
+  stream.truncated = true;
+
+  return i > 0 ? (int)i : -1;
+}
+
+// Register format
+static char n[] = "arrow";
+static char d[] = "Apache Arrow IPC stream";
+static FormatPlugin<ArrowFormat, n, d,
+                    (int)SampleFlags::HAS_TS_ORIGIN |
+                        (int)SampleFlags::HAS_TS_RECEIVED |
+                        (int)SampleFlags::HAS_SEQUENCE |
+                        (int)SampleFlags::HAS_DATA>
+    p;
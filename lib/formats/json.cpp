@@ -5,6 +5,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <cinttypes>
+#include <cstring>
+
 #include <villas/compat.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/formats/json.hpp>
@@ -14,6 +17,322 @@
 using namespace villas;
 using namespace villas::node;
 
+namespace {
+
+// Appends to a fixed-size buffer and fails once it is exhausted.
+class JsonWriter {
+
+protected:
+  char *buf;
+  size_t len;
+  size_t off;
+
+  const char *item_sep; // Separator between array and object items
+  const char *key_sep;  // Separator between object keys and values
+
+  bool ok;
+
+public:
+  JsonWriter(char *b, size_t l, bool compact)
+      : buf(b), len(l), off(0), item_sep(compact ? "," : ", "),
+        key_sep(compact ? ":" : ": "), ok(true) {}
+
+  bool isOk() const { return ok; }
+
+  size_t getLength() const { return off; }
+
+  void put(const char *str, size_t n) {
+    if (!ok || off + n > len) {
+      ok = false;
+      return;
+    }
+
+    memcpy(buf + off, str, n);
+    off += n;
+  }
+
+  void put(const char *str) { put(str, strlen(str)); }
+
+  void put(char c) { put(&c, 1); }
+
+  void item(bool first) {
+    if (!first)
+      put(item_sep);
+  }
+
+  void key(const char *k, bool first) {
+    item(first);
+
+    put('"');
+    put(k);
+    put('"');
+    put(key_sep);
+  }
+
+  void integer(int64_t i) {
+    char tmp[32];
+    int n = snprintf(tmp, sizeof(tmp), "%" PRIi64, i);
+
+    put(tmp, n);
+  }
+
+  // Formats reals in the same way as jansson does
+  void real(double d, int precision) {
+    char tmp[64];
+
+    if (!std::isfinite(d)) {
+      ok = false; // Not representable in JSON
+      return;
+    }
+
+    int n = snprintf(tmp, sizeof(tmp), "%.*g", precision, d);
+
+    // Make sure that the number is parsed as a real
+    if (!strpbrk(tmp, ".eE")) {
+      tmp[n++] = '.';
+      tmp[n++] = '0';
+      tmp[n] = '\0';
+    }
+
+    // Remove leading '+' and zeros from the exponent
+    char *start = strchr(tmp, 'e');
+    if (start) {
+      char *end = ++start + 1;
+
+      if (*start == '-')
+        start++;
+
+      while (*end == '0')
+        end++;
+
+      if (end != start) {
+        memmove(start, end, n - (end - tmp) + 1);
+        n -= end - start;
+      }
+    }
+
+    put(tmp, n);
+  }
+
+  void timestamp(const char *k, const struct timespec &ts, bool first) {
+    key(k, first);
+    put('[');
+    integer(ts.tv_sec);
+    put(item_sep);
+    integer(ts.tv_nsec);
+    put(']');
+  }
+};
+
+// A minimal pull parser which reads values on-demand.
+class JsonReader {
+
+protected:
+  const char *buf;
+  size_t len;
+  size_t off;
+
+public:
+  JsonReader(const char *b, size_t l) : buf(b), len(l), off(0) {}
+
+  size_t getOffset() const { return off; }
+
+  char peek() {
+    while (off < len && isspace((unsigned char)buf[off]))
+      off++;
+
+    return off < len ? buf[off] : '\0';
+  }
+
+  bool expect(char c) {
+    if (peek() != c)
+      return false;
+
+    off++;
+    return true;
+  }
+
+  // Continue with the next item or stop at the closing bracket / brace.
+  bool next(char close, bool *more) {
+    char c = peek();
+
+    if (c == close) {
+      off++;
+      *more = false;
+      return true;
+    } else if (c == ',') {
+      off++;
+      *more = true;
+      return true;
+    }
+
+    return false;
+  }
+
+  // Parses strings without escape sequences.
+  bool string(const char **str, size_t *n) {
+    if (!expect('"'))
+      return false;
+
+    const char *start = buf + off;
+    const char *end = (const char *)memchr(start, '"', len - off);
+    if (!end || memchr(start, '\\', end - start))
+      return false;
+
+    *str = start;
+    *n = end - start;
+    off += *n + 1;
+
+    return true;
+  }
+
+  bool key(const char **k, size_t *n) { return string(k, n) && expect(':'); }
+
+  bool number(double *d, int64_t *i, bool *is_real) {
+    char tmp[64];
+    size_t n = 0;
+
+    *is_real = false;
+
+    peek();
+    while (off < len && n < sizeof(tmp) - 1) {
+      char c = buf[off];
+
+      if (c == '.' || c == 'e' || c == 'E')
+        *is_real = true;
+      else if (!isdigit((unsigned char)c) && c != '-' && c != '+')
+        break;
+
+      tmp[n++] = c;
+      off++;
+    }
+
+    if (n == 0 || n == sizeof(tmp) - 1)
+      return false;
+
+    tmp[n] = '\0';
+
+    char *end;
+    if (*is_real)
+      *d = strtod(tmp, &end);
+    else {
+      errno = 0;
+      *i = strtoll(tmp, &end, 10);
+      *d = *i;
+
+      if (errno == ERANGE)
+        return false;
+    }
+
+    return end == tmp + n;
+  }
+
+  bool integer(int64_t *i) {
+    double d;
+    bool is_real;
+
+    return number(&d, i, &is_real) && !is_real;
+  }
+
+  bool literal(const char *lit) {
+    size_t n = strlen(lit);
+
+    peek();
+    if (off + n > len || strncmp(buf + off, lit, n))
+      return false;
+
+    off += n;
+    return true;
+  }
+
+  bool boolean(bool *b) {
+    if (literal("true"))
+      *b = true;
+    else if (literal("false"))
+      *b = false;
+    else
+      return false;
+
+    return true;
+  }
+
+  bool timestamp(struct timespec *ts) {
+    int64_t sec, nsec;
+
+    if (!expect('[') || !integer(&sec) || !expect(',') || !integer(&nsec) ||
+        !expect(']'))
+      return false;
+
+    ts->tv_sec = sec;
+    ts->tv_nsec = nsec;
+
+    return true;
+  }
+
+  // Skip over a value of arbitrary type.
+  bool skip() {
+    const char *str;
+    size_t n;
+    bool more;
+    double d;
+    int64_t i;
+    bool is_real;
+
+    switch (peek()) {
+    case '"':
+      // Skip strings with escape sequences as well
+      for (off++; off < len && buf[off] != '"'; off++) {
+        if (buf[off] == '\\')
+          off++;
+      }
+
+      return off++ < len;
+
+    case '{':
+      off++;
+      if (peek() == '}') {
+        off++;
+        return true;
+      }
+
+      do {
+        if (!key(&str, &n) || !skip() || !next('}', &more))
+          return false;
+      } while (more);
+
+      return true;
+
+    case '[':
+      off++;
+      if (peek() == ']') {
+        off++;
+        return true;
+      }
+
+      do {
+        if (!skip() || !next(']', &more))
+          return false;
+      } while (more);
+
+      return true;
+
+    case 't':
+      return literal("true");
+
+    case 'f':
+      return literal("false");
+
+    case 'n':
+      return literal("null");
+
+    default:
+      return number(&d, &i, &is_real);
+    }
+  }
+};
+
+} // namespace
+
 enum SignalType JsonFormat::detect(const json_t *val) {
   int type = json_typeof(val);
 
@@ -288,12 +607,374 @@ int JsonFormat::unpackSamples(json_t *json_smps, struct Sample *const smps[],
   return i;
 }
 
+bool JsonFormat::isDirectSupported() const {
+  // Pretty-printing and sorting of keys is left to jansson
+  return direct &&
+         !(dump_flags & (JSON_INDENT(JSON_MAX_INDENT) | JSON_SORT_KEYS));
+}
+
+int JsonFormat::sprintDirect(char *buf, size_t len, size_t *wbytes,
+                             const struct Sample *const smps[], unsigned cnt,
+                             bool array) {
+  JsonWriter w(buf, len, dump_flags & JSON_COMPACT);
+
+  int precision = real_precision > 0 ? real_precision : 17;
+
+  if (array)
+    w.put('[');
+
+  for (unsigned i = 0; i < cnt; i++) {
+    const struct Sample *smp = smps[i];
+    bool first = true;
+
+    if (smp->length > 0 &&
+        (!smp->signals || smp->length > smp->signals->size()))
+      return -1;
+
+    w.item(i == 0);
+    w.put('{');
+
+    bool has_origin = (flags & smp->flags) & (int)SampleFlags::HAS_TS_ORIGIN;
+    bool has_received =
+        (flags & smp->flags) & (int)SampleFlags::HAS_TS_RECEIVED;
+
+    if (has_origin || has_received) {
+      w.key("ts", first);
+      w.put('{');
+
+      if (has_origin)
+        w.timestamp("origin", smp->ts.origin, true);
+
+      if (has_received)
+        w.timestamp("received", smp->ts.received, !has_origin);
+
+      w.put('}');
+      first = false;
+    }
+
+    bool new_simulation =
+        (flags & smp->flags) & (int)SampleFlags::NEW_SIMULATION;
+    bool new_frame = (flags & smp->flags) & (int)SampleFlags::NEW_FRAME;
+
+    if (new_simulation || new_frame) {
+      w.key("flags", first);
+      w.put('[');
+
+      if (new_simulation)
+        w.put("\"new_simulation\"");
+
+      if (new_frame) {
+        w.item(!new_simulation);
+        w.put("\"new_frame\"");
+      }
+
+      w.put(']');
+      first = false;
+    }
+
+    if ((flags & smp->flags) & (int)SampleFlags::HAS_SEQUENCE) {
+      w.key("sequence", first);
+      w.integer(smp->sequence);
+      first = false;
+    }
+
+    if (flags & (int)SampleFlags::HAS_DATA) {
+      w.key("data", first);
+      w.put('[');
+
+      for (unsigned j = 0; j < smp->length; j++) {
+        const auto &sig = (*smp->signals)[j];
+
+        w.item(j == 0);
+
+        switch (sig->type) {
+        case SignalType::FLOAT:
+          w.real(smp->data[j].f, precision);
+          break;
+
+        case SignalType::INTEGER:
+          w.integer(smp->data[j].i);
+          break;
+
+        case SignalType::BOOLEAN:
+          w.put(smp->data[j].b ? "true" : "false");
+          break;
+
+        case SignalType::COMPLEX:
+          w.put('{');
+          w.key("real", true);
+          w.real(std::real(smp->data[j].z), precision);
+          w.key("imag", false);
+          w.real(std::imag(smp->data[j].z), precision);
+          w.put('}');
+          break;
+
+        default:
+          return -1;
+        }
+      }
+
+      w.put(']');
+    }
+
+    w.put('}');
+  }
+
+  if (array)
+    w.put(']');
+
+  // Let jansson handle buffer overruns and non-finite values
+  if (!w.isOk())
+    return -1;
+
+  if (wbytes)
+    *wbytes = w.getLength();
+
+  return cnt;
+}
+
+int JsonFormat::sscanDirect(const char *buf, size_t len, size_t *rbytes,
+                            struct Sample *const smps[], unsigned cnt) {
+  JsonReader r(buf, len);
+  const char *key;
+  size_t keylen;
+  unsigned i = 0;
+  bool more;
+
+  if (!r.expect('['))
+    return -1;
+
+  more = r.peek() != ']';
+  if (!more)
+    r.expect(']');
+
+  while (more) {
+    if (i >= cnt) {
+      if (!r.skip() || !r.next(']', &more))
+        return -1;
+
+      continue;
+    }
+
+    struct Sample *smp = smps[i];
+    bool has_data = false;
+
+    smp->signals = signals;
+    smp->flags = 0;
+    smp->length = 0;
+
+    if (!r.expect('{'))
+      return -1;
+
+    bool more_keys = r.peek() != '}';
+    if (!more_keys)
+      r.expect('}');
+
+    while (more_keys) {
+      if (!r.key(&key, &keylen))
+        return -1;
+
+      if (keylen == 2 && !strncmp(key, "ts", 2)) {
+        bool more_ts;
+
+        if (!r.expect('{'))
+          return -1;
+
+        more_ts = r.peek() != '}';
+        if (!more_ts)
+          r.expect('}');
+
+        while (more_ts) {
+          if (!r.key(&key, &keylen))
+            return -1;
+
+          if (keylen == 6 && !strncmp(key, "origin", 6)) {
+            if (!r.timestamp(&smp->ts.origin))
+              return -1;
+
+            smp->flags |= (int)SampleFlags::HAS_TS_ORIGIN;
+          } else if (keylen == 8 && !strncmp(key, "received", 8)) {
+            if (!r.timestamp(&smp->ts.received))
+              return -1;
+
+            smp->flags |= (int)SampleFlags::HAS_TS_RECEIVED;
+          } else if (!r.skip())
+            return -1;
+
+          if (!r.next('}', &more_ts))
+            return -1;
+        }
+      } else if (keylen == 5 && !strncmp(key, "flags", 5)) {
+        bool more_flags;
+        const char *flag;
+        size_t flaglen;
+
+        if (!r.expect('['))
+          return -1;
+
+        more_flags = r.peek() != ']';
+        if (!more_flags)
+          r.expect(']');
+
+        while (more_flags) {
+          if (!r.string(&flag, &flaglen))
+            return -1;
+
+          if (flaglen == 9 && !strncmp(flag, "new_frame", 9))
+            smp->flags |= (int)SampleFlags::NEW_FRAME;
+          else
+            smp->flags &= ~(int)SampleFlags::NEW_FRAME;
+
+          if (flaglen == 14 && !strncmp(flag, "new_simulation", 14))
+            smp->flags |= (int)SampleFlags::NEW_SIMULATION;
+          else
+            smp->flags &= ~(int)SampleFlags::NEW_SIMULATION;
+
+          if (!r.next(']', &more_flags))
+            return -1;
+        }
+      } else if (keylen == 8 && !strncmp(key, "sequence", 8)) {
+        int64_t sequence;
+
+        if (!r.integer(&sequence))
+          return -1;
+
+        if (sequence >= 0) {
+          smp->sequence = sequence;
+          smp->flags |= (int)SampleFlags::HAS_SEQUENCE;
+        }
+      } else if (keylen == 4 && !strncmp(key, "data", 4)) {
+        bool more_values;
+
+        if (!r.expect('['))
+          return -1;
+
+        more_values = r.peek() != ']';
+        if (!more_values)
+          r.expect(']');
+
+        for (unsigned j = 0; more_values; j++) {
+          if (j >= smp->capacity) {
+            if (!r.skip())
+              return -1;
+          } else {
+            double d;
+            int64_t v;
+            bool is_real;
+
+            // Type mismatches are reported by the jansson-based implementation
+            if (j >= signals->size())
+              return -1;
+
+            auto *data = &smp->data[j];
+
+            switch ((*signals)[j]->type) {
+            case SignalType::FLOAT:
+              if (!r.number(&d, &v, &is_real) || !is_real)
+                return -1;
+
+              data->f = d;
+              break;
+
+            case SignalType::INTEGER:
+              if (!r.integer(&data->i))
+                return -1;
+              break;
+
+            case SignalType::BOOLEAN:
+              if (!r.boolean(&data->b))
+                return -1;
+              break;
+
+            case SignalType::COMPLEX: {
+              double real = 0, imag = 0;
+              bool has_real = false, has_imag = false, more_parts;
+
+              if (!r.expect('{'))
+                return -1;
+
+              more_parts = r.peek() != '}';
+              if (!more_parts)
+                r.expect('}');
+
+              while (more_parts) {
+                if (!r.key(&key, &keylen))
+                  return -1;
+
+                if (keylen == 4 && !strncmp(key, "real", 4)) {
+                  if (!r.number(&real, &v, &is_real))
+                    return -1;
+
+                  has_real = true;
+                } else if (keylen == 4 && !strncmp(key, "imag", 4)) {
+                  if (!r.number(&imag, &v, &is_real))
+                    return -1;
+
+                  has_imag = true;
+                } else if (!r.skip())
+                  return -1;
+
+                if (!r.next('}', &more_parts))
+                  return -1;
+              }
+
+              if (!has_real || !has_imag)
+                return -1;
+
+              data->z = std::complex<float>(real, imag);
+              break;
+            }
+
+            default:
+              return -1;
+            }
+
+            smp->length++;
+          }
+
+          if (!r.next(']', &more_values))
+            return -1;
+        }
+
+        has_data = true;
+      } else if (!r.skip())
+        return -1;
+
+      if (!r.next('}', &more_keys))
+        return -1;
+    }
+
+    // The data member is mandatory
+    if (!has_data)
+      return -1;
+
+    if (smp->length > 0)
+      smp->flags |= (int)SampleFlags::HAS_DATA;
+
+    i++;
+
+    if (!r.next(']', &more))
+      return -1;
+  }
+
+  if (rbytes)
+    *rbytes = r.getOffset();
+
+  return i;
+}
+
 int JsonFormat::sprint(char *buf, size_t len, size_t *wbytes,
                        const struct Sample *const smps[], unsigned cnt) {
   int ret;
   json_t *json;
   size_t wr;
 
+  if (isDirectSupported()) {
+    ret = sprintDirect(buf, len, wbytes, smps, cnt);
+    if (ret >= 0)
+      return ret;
+  }
+
   ret = packSamples(&json, smps, cnt);
   if (ret < 0)
     return ret;
@@ -314,6 +995,12 @@ int JsonFormat::sscan(const char *buf, size_t len, size_t *rbytes,
   json_t *json;
   json_error_t err;
 
+  if (isDirectSupported()) {
+    ret = sscanDirect(buf, len, rbytes, smps, cnt);
+    if (ret >= 0)
+      return ret;
+  }
+
   json = json_loadb(buf, len, 0, &err);
   if (!json)
     return -1;
@@ -338,6 +1025,18 @@ int JsonFormat::print(FILE *f, const struct Sample *const smps[],
   json_t *json;
 
   for (i = 0; i < cnt; i++) {
+    if (isDirectSupported()) {
+      size_t wbytes;
+
+      ret = sprintDirect(out.buffer, out.buflen - 1, &wbytes, &smps[i], 1,
+                         false);
+      if (ret >= 0) {
+        out.buffer[wbytes++] = '\n';
+        fwrite(out.buffer, wbytes, 1, f);
+        continue;
+      }
+    }
+
     ret = packSample(&json, smps[i]);
     if (ret)
       return ret;
@@ -388,13 +1087,12 @@ void JsonFormat::parse(json_t *json) {
   int ensure_ascii = 0;
   int escape_slash = 0;
   int sort_keys = 0;
+  int dir = direct;
 
-  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: b, s?: b, s?: b, s?: b }",
-                       "indent", &indent, "compact", &compact, "ensure_ascii",
-                       &ensure_ascii, "escape_slash", &escape_slash,
-                       "sort_keys", &sort_keys
-
-  );
+  ret = json_unpack_ex(
+      json, &err, 0, "{ s?: i, s?: b, s?: b, s?: b, s?: b, s?: b }", "indent",
+      &indent, "compact", &compact, "ensure_ascii", &ensure_ascii,
+      "escape_slash", &escape_slash, "sort_keys", &sort_keys, "direct", &dir);
   if (ret)
     throw ConfigError(json, err, "node-config-format-json",
                       "Failed to parse format configuration");
@@ -403,6 +1101,8 @@ void JsonFormat::parse(json_t *json) {
     throw ConfigError(json, "node-config-format-json-indent",
                       "The maximum indentation level is {}", JSON_MAX_INDENT);
 
+  direct = dir;
+
   dump_flags = 0;
 
   if (indent)
@@ -422,7 +1122,7 @@ void JsonFormat::parse(json_t *json) {
 
   Format::parse(json);
 
-  if (real_precision)
+  if (real_precision > 0)
     dump_flags |= JSON_REAL_PRECISION(real_precision);
 }
 
@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <cstring>
+
 #include <villas/exceptions.hpp>
 #include <villas/formats/line.hpp>
 
@@ -84,39 +86,61 @@ int LineFormat::print(FILE *f, const struct Sample *const smps[],
 }
 
 int LineFormat::scan(FILE *f, struct Sample *const smps[], unsigned cnt) {
-  int ret;
-  unsigned i;
+  int ret = 0;
+  unsigned i = 0;
   ssize_t bytes;
 
-  if (skip_first_line) {
-    if (!first_line_skipped) {
-      bytes = getdelim(&in.buffer, &in.buflen, delimiter, f);
+  syncStream(f);
+
+  while (i < cnt) {
+    size_t rbytes, len;
+    char *ptr, *line = in.buffer + stream.head;
+
+    auto *end = (char *)memchr(line, delimiter, stream.tail - stream.head);
+    if (end)
+      len = end - line + 1;
+    else {
+      // Do not block if we already have some samples
+      if (i > 0)
+        break;
+
+      // Incomplete line: read more data
+      bytes = fillStream(f);
       if (bytes < 0)
-        return -1; // An error or eof occured
+        return -1;
+      else if (bytes > 0)
+        continue;
 
-      first_line_skipped = true;
+      /* The end of the stream has been reached or no data is available.
+       * The last line might not be terminated by a delimiter. */
+      if (!stream.eof || stream.head == stream.tail)
+        break;
+
+      len = stream.tail - stream.head;
     }
-  }
 
-  for (i = 0; i < cnt && !feof(f); i++) {
-    size_t rbytes;
-    char *ptr;
+    stream.head += len;
 
-  skip:
-    bytes = getdelim(&in.buffer, &in.buflen, delimiter, f);
-    if (feof(f))
-      break;
-    else if (bytes < 0)
-      return -1; // An error or eof occured
+    if (skip_first_line && !first_line_skipped) {
+      first_line_skipped = true;
+      continue;
+    }
+
+    /* Terminate the line as getdelim() would do. This might temporarily
+     * overwrite the first character of the next line or the terminating
+     * null character of the buffer. */
+    char next = line[len];
+    line[len] = '\0';
 
     // Skip whitespaces, empty and comment lines
-    for (ptr = in.buffer; isspace(*ptr); ptr++)
+    for (ptr = line; isspace(*ptr); ptr++)
       ;
 
-    if (ptr[0] == '\0' || ptr[0] == comment)
-      goto skip;
+    if (ptr[0] != '\0' && ptr[0] != comment)
+      ret = sscan(line, len, &rbytes, &smps[i++], 1);
+
+    line[len] = next;
 
-    ret = sscan(in.buffer, bytes, &rbytes, &smps[i], 1);
     if (ret < 0)
       return ret;
   }
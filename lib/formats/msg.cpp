@@ -6,9 +6,11 @@
  */
 
 #include <arpa/inet.h>
+#include <endian.h>
 
 #include <villas/formats/msg.hpp>
 #include <villas/formats/msg_format.hpp>
+#include <villas/formats/msg_kernels.hpp>
 #include <villas/list.hpp>
 #include <villas/sample.hpp>
 #include <villas/signal.hpp>
@@ -20,13 +22,19 @@ using namespace villas::node;
 void villas::node::msg_ntoh(struct Message *m) {
   msg_hdr_ntoh(m);
 
-  for (int i = 0; i < m->length; i++)
-    m->data[i].i = ntohl(m->data[i].i);
+#if BYTE_ORDER == LITTLE_ENDIAN
+  auto *words = (uint32_t *)MSG_DATA_OFFSET(m);
+
+  msg_kernels()->bswap32(words, words, m->length);
+#endif
 }
 
 void villas::node::msg_hton(struct Message *m) {
-  for (int i = 0; i < m->length; i++)
-    m->data[i].i = htonl(m->data[i].i);
+#if BYTE_ORDER == LITTLE_ENDIAN
+  auto *words = (uint32_t *)MSG_DATA_OFFSET(m);
+
+  msg_kernels()->bswap32(words, words, m->length);
+#endif
 
   msg_hdr_hton(m);
 }
@@ -56,29 +64,77 @@ int villas::node::msg_verify(const struct Message *m) {
     return 0;
 }
 
-int villas::node::msg_to_sample(const struct Message *msg, struct Sample *smp,
-                                const SignalList::Ptr sigs,
-                                uint8_t *source_index) {
-  int ret;
-  unsigned i;
+/* Get the end of the run of signals starting at index i which share the same
+ * type.
+ *
+ * Runs are converted at once by the vectorized kernels.
+ */
+static unsigned msg_run_end(const SignalList &sigs, unsigned i,
+                            unsigned len) {
+  auto type = sigs[i]->type;
 
-  ret = msg_verify(msg);
-  if (ret)
-    return ret;
+  unsigned j;
+  for (j = i + 1; j < len && sigs[j]->type == type; j++)
+    ;
+
+  return j;
+}
+
+// Convert the values of \p smp into 32 bit words in host byteorder.
+static int msg_pack_values(uint32_t *words, const struct Sample *smp,
+                           const SignalList &sigs) {
+  unsigned i, j;
 
-  unsigned len = MIN(msg->length, smp->capacity);
-  for (i = 0; i < MIN(len, sigs->size()); i++) {
-    auto sig = sigs->getByIndex(i);
-    if (!sig)
+  auto *k = msg_kernels();
+  auto *values = (float *)words;
+
+  for (i = 0; i < smp->length; i = j) {
+    j = msg_run_end(sigs, i, smp->length);
+
+    switch (sigs[i]->type) {
+    case SignalType::FLOAT:
+      k->f64_to_f32(values + i, &smp->data[i].f, j - i);
+      break;
+
+    case SignalType::INTEGER:
+      for (unsigned l = i; l < j; l++)
+        words[l] = smp->data[l].i;
+      break;
+
+    default:
       return -1;
+    }
+  }
+
+  return 0;
+}
 
-    switch (sig->type) {
+/* Convert \p len 32 bit words in host byteorder into the values of \p smp.
+ *
+ * @return The number of values which have been stored in \p smp or a negative
+ *         number on error.
+ */
+static int msg_unpack_values(const uint32_t *words, unsigned len,
+                             struct Sample *smp, const SignalList &sigs) {
+  unsigned i, j;
+
+  auto *k = msg_kernels();
+  auto *values = (const float *)words;
+
+  len = MIN(len, smp->capacity);
+  len = MIN(len, sigs.size());
+
+  for (i = 0; i < len; i = j) {
+    j = msg_run_end(sigs, i, len);
+
+    switch (sigs[i]->type) {
     case SignalType::FLOAT:
-      smp->data[i].f = msg->data[i].f;
+      k->f32_to_f64(&smp->data[i].f, values + i, j - i);
       break;
 
     case SignalType::INTEGER:
-      smp->data[i].i = msg->data[i].i;
+      for (unsigned l = i; l < j; l++)
+        smp->data[l].i = words[l];
       break;
 
     default:
@@ -86,9 +142,26 @@ int villas::node::msg_to_sample(const struct Message *msg, struct Sample *smp,
     }
   }
 
+  return i;
+}
+
+int villas::node::msg_to_sample(const struct Message *msg, struct Sample *smp,
+                                const SignalList::Ptr sigs,
+                                uint8_t *source_index) {
+  int ret;
+
+  ret = msg_verify(msg);
+  if (ret)
+    return ret;
+
+  ret = msg_unpack_values((const uint32_t *)MSG_DATA_OFFSET(msg), msg->length,
+                          smp, *sigs);
+  if (ret < 0)
+    return ret;
+
   smp->flags = (int)SampleFlags::HAS_TS_ORIGIN |
                (int)SampleFlags::HAS_SEQUENCE | (int)SampleFlags::HAS_DATA;
-  smp->length = i;
+  smp->length = ret;
   smp->sequence = msg->sequence;
   MSG_TS(msg, smp->ts.origin);
 
@@ -102,6 +175,9 @@ int villas::node::msg_from_sample(struct Message *msg_in,
                                   const struct Sample *smp,
                                   const SignalList::Ptr sigs,
                                   uint8_t source_index) {
+  if (smp->length > sigs->size())
+    return -1;
+
   msg_in->type = MSG_TYPE_DATA;
   msg_in->version = MSG_VERSION;
   msg_in->reserved1 = 0;
@@ -111,23 +187,179 @@ int villas::node::msg_from_sample(struct Message *msg_in,
   msg_in->ts.sec = smp->ts.origin.tv_sec;
   msg_in->ts.nsec = smp->ts.origin.tv_nsec;
 
-  for (unsigned i = 0; i < smp->length; i++) {
-    auto sig = sigs->getByIndex(i);
-    if (!sig)
-      return -1;
+  return msg_pack_values((uint32_t *)MSG_DATA_OFFSET(msg_in), smp, *sigs);
+}
 
-    switch (sig->type) {
-    case SignalType::FLOAT:
-      msg_in->data[i].f = smp->data[i].f;
+void villas::node::msg_batch_ntoh(struct MessageBatch *b) {
+  b->count = ntohs(b->count);
+  b->length = ntohs(b->length);
+  b->sequence = ntohl(b->sequence);
+  b->ts.sec = ntohl(b->ts.sec);
+  b->ts.nsec = ntohl(b->ts.nsec);
+
+#if BYTE_ORDER == LITTLE_ENDIAN
+  // Offsets and values are swapped at once
+  auto *words = (uint32_t *)((char *)b + sizeof(struct MessageBatch));
+
+  msg_kernels()->bswap32(words, words, b->count * (1 + (size_t)b->length));
+#endif
+}
+
+void villas::node::msg_batch_hton(struct MessageBatch *b) {
+#if BYTE_ORDER == LITTLE_ENDIAN
+  auto *words = (uint32_t *)((char *)b + sizeof(struct MessageBatch));
+
+  msg_kernels()->bswap32(words, words, b->count * (1 + (size_t)b->length));
+#endif
+
+  b->count = htons(b->count);
+  b->length = htons(b->length);
+  b->sequence = htonl(b->sequence);
+  b->ts.sec = htonl(b->ts.sec);
+  b->ts.nsec = htonl(b->ts.nsec);
+}
+
+void villas::node::msg_batch_letoh(struct MessageBatch *b) {
+  b->count = le16toh(b->count);
+  b->length = le16toh(b->length);
+  b->sequence = le32toh(b->sequence);
+  b->ts.sec = le32toh(b->ts.sec);
+  b->ts.nsec = le32toh(b->ts.nsec);
+
+#if BYTE_ORDER == BIG_ENDIAN
+  auto *words = (uint32_t *)((char *)b + sizeof(struct MessageBatch));
+
+  msg_kernels()->bswap32(words, words, b->count * (1 + (size_t)b->length));
+#endif
+}
+
+void villas::node::msg_batch_htole(struct MessageBatch *b) {
+#if BYTE_ORDER == BIG_ENDIAN
+  auto *words = (uint32_t *)((char *)b + sizeof(struct MessageBatch));
+
+  msg_kernels()->bswap32(words, words, b->count * (1 + (size_t)b->length));
+#endif
+
+  b->count = htole16(b->count);
+  b->length = htole16(b->length);
+  b->sequence = htole32(b->sequence);
+  b->ts.sec = htole32(b->ts.sec);
+  b->ts.nsec = htole32(b->ts.nsec);
+}
+
+int villas::node::msg_batch_verify(const struct MessageBatch *b) {
+  if (b->version != MSG_BATCH_VERSION)
+    return -1;
+  else if (b->type != MSG_TYPE_DATA)
+    return -2;
+  else if (b->reserved1 != 0 || b->reserved2 != 0)
+    return -3;
+  else if (b->ts.nsec >= 1000000000)
+    return -4;
+  else
+    return 0;
+}
+
+unsigned villas::node::msg_batch_count(const struct Sample *const smps[],
+                                       unsigned cnt) {
+  const struct Sample *first = smps[0];
+  unsigned n;
+
+  for (n = 1; n < MIN(cnt, (unsigned)UINT16_MAX); n++) {
+    const struct Sample *smp = smps[n];
+
+    if (smp->length != first->length ||
+        (uint32_t)smp->sequence != (uint32_t)(first->sequence + n))
       break;
 
-    case SignalType::INTEGER:
-      msg_in->data[i].i = smp->data[i].i;
+    int64_t offset =
+        (int64_t)(smp->ts.origin.tv_sec - first->ts.origin.tv_sec) *
+            1000000000 +
+        (smp->ts.origin.tv_nsec - first->ts.origin.tv_nsec);
+    if (offset < 0 || offset > UINT32_MAX)
       break;
+  }
 
-    default:
-      return -1;
-    }
+  return n;
+}
+
+int villas::node::msg_batch_to_samples(const struct MessageBatch *b,
+                                       unsigned first,
+                                       struct Sample *const smps[],
+                                       unsigned cnt, const SignalList::Ptr sigs,
+                                       uint8_t *source_index) {
+  int ret;
+
+  ret = msg_batch_verify(b);
+  if (ret)
+    return ret;
+
+  auto *words = (const uint32_t *)MSG_BATCH_DATA_OFFSET(b);
+
+  if (first > b->count)
+    return -1;
+
+  cnt = MIN(cnt, b->count - first);
+
+  for (unsigned i = 0; i < cnt; i++) {
+    struct Sample *smp = smps[i];
+    unsigned k = first + i;
+
+    ret = msg_unpack_values(words + k * b->length, b->length, smp, *sigs);
+    if (ret < 0)
+      return ret;
+
+    uint64_t nsec = (uint64_t)b->ts.nsec + b->offsets[k];
+
+    smp->flags = (int)SampleFlags::HAS_TS_ORIGIN |
+                 (int)SampleFlags::HAS_SEQUENCE | (int)SampleFlags::HAS_DATA;
+    smp->length = ret;
+    smp->sequence = (uint32_t)(b->sequence + k);
+    smp->ts.origin.tv_sec = b->ts.sec + nsec / 1000000000;
+    smp->ts.origin.tv_nsec = nsec % 1000000000;
+    smp->signals = sigs;
+  }
+
+  if (source_index)
+    *source_index = b->source_index;
+
+  return cnt;
+}
+
+int villas::node::msg_batch_from_samples(struct MessageBatch *b,
+                                         const struct Sample *const smps[],
+                                         unsigned cnt,
+                                         const SignalList::Ptr sigs,
+                                         uint8_t source_index) {
+  int ret;
+  const struct Sample *first = smps[0];
+
+  if (first->length > sigs->size())
+    return -1;
+
+  b->type = MSG_TYPE_DATA;
+  b->version = MSG_BATCH_VERSION;
+  b->reserved1 = 0;
+  b->reserved2 = 0;
+  b->source_index = source_index;
+  b->count = (uint16_t)cnt;
+  b->length = (uint16_t)first->length;
+  b->sequence = (uint32_t)first->sequence;
+  b->ts.sec = first->ts.origin.tv_sec;
+  b->ts.nsec = first->ts.origin.tv_nsec;
+
+  auto *words = (uint32_t *)MSG_BATCH_DATA_OFFSET(b);
+
+  for (unsigned i = 0; i < cnt; i++) {
+    const struct Sample *smp = smps[i];
+
+    b->offsets[i] =
+        (smp->ts.origin.tv_sec - first->ts.origin.tv_sec) * 1000000000 +
+        (smp->ts.origin.tv_nsec - first->ts.origin.tv_nsec);
+
+    ret = msg_pack_values(words + i * b->length, smp, *sigs);
+    if (ret)
+      return ret;
   }
 
   return 0;
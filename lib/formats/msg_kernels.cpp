@@ -0,0 +1,205 @@
+/* Vectorized kernels for converting message payloads.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <villas/formats/msg_kernels.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace villas::node;
+
+// Scalar reference implementation
+static void bswap32_scalar(uint32_t *dst, const uint32_t *src, size_t cnt) {
+  for (size_t i = 0; i < cnt; i++)
+    dst[i] = __builtin_bswap32(src[i]);
+}
+
+static void f32_to_f64_scalar(double *dst, const float *src, size_t cnt) {
+  for (size_t i = 0; i < cnt; i++)
+    dst[i] = src[i];
+}
+
+static void f64_to_f32_scalar(float *dst, const double *src, size_t cnt) {
+  for (size_t i = 0; i < cnt; i++)
+    dst[i] = src[i];
+}
+
+static const struct MsgKernels kernels_scalar = {
+    .name = "scalar",
+    .bswap32 = bswap32_scalar,
+    .f32_to_f64 = f32_to_f64_scalar,
+    .f64_to_f32 = f64_to_f32_scalar,
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+// SSE2 for conversions and SSSE3 for the byte shuffle
+__attribute__((target("ssse3"))) static void
+bswap32_sse(uint32_t *dst, const uint32_t *src, size_t cnt) {
+  const __m128i mask =
+      _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(v, mask));
+  }
+
+  bswap32_scalar(dst + i, src + i, cnt - i);
+}
+
+__attribute__((target("sse2"))) static void
+f32_to_f64_sse(double *dst, const float *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    __m128 v = _mm_loadu_ps(src + i);
+    _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+    _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+
+  f32_to_f64_scalar(dst + i, src + i, cnt - i);
+}
+
+__attribute__((target("sse2"))) static void
+f64_to_f32_sse(float *dst, const double *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+    _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+  }
+
+  f64_to_f32_scalar(dst + i, src + i, cnt - i);
+}
+
+static const struct MsgKernels kernels_sse = {
+    .name = "sse",
+    .bswap32 = bswap32_sse,
+    .f32_to_f64 = f32_to_f64_sse,
+    .f64_to_f32 = f64_to_f32_sse,
+};
+
+__attribute__((target("avx2"))) static void
+bswap32_avx2(uint32_t *dst, const uint32_t *src, size_t cnt) {
+  const __m256i mask = _mm256_set_epi8(
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, // High lane
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3  // Low lane
+  );
+
+  size_t i = 0;
+  for (; i + 8 <= cnt; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(v, mask));
+  }
+
+  bswap32_scalar(dst + i, src + i, cnt - i);
+}
+
+__attribute__((target("avx2"))) static void
+f32_to_f64_avx2(double *dst, const float *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 8 <= cnt; i += 8) {
+    __m256 v = _mm256_loadu_ps(src + i);
+    _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    _mm256_storeu_pd(dst + i + 4,
+                     _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+  }
+
+  f32_to_f64_scalar(dst + i, src + i, cnt - i);
+}
+
+__attribute__((target("avx2"))) static void
+f64_to_f32_avx2(float *dst, const double *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 8 <= cnt; i += 8) {
+    __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+    __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+    _mm256_storeu_ps(dst + i, _mm256_set_m128(hi, lo));
+  }
+
+  f64_to_f32_scalar(dst + i, src + i, cnt - i);
+}
+
+static const struct MsgKernels kernels_avx2 = {
+    .name = "avx2",
+    .bswap32 = bswap32_avx2,
+    .f32_to_f64 = f32_to_f64_avx2,
+    .f64_to_f32 = f64_to_f32_avx2,
+};
+#elif defined(__aarch64__)
+// Advanced SIMD is mandatory on AArch64, hence no runtime check is required
+static void bswap32_neon(uint32_t *dst, const uint32_t *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    uint8x16_t v = vreinterpretq_u8_u32(vld1q_u32(src + i));
+    vst1q_u32(dst + i, vreinterpretq_u32_u8(vrev32q_u8(v)));
+  }
+
+  bswap32_scalar(dst + i, src + i, cnt - i);
+}
+
+static void f32_to_f64_neon(double *dst, const float *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    float32x4_t v = vld1q_f32(src + i);
+    vst1q_f64(dst + i, vcvt_f64_f32(vget_low_f32(v)));
+    vst1q_f64(dst + i + 2, vcvt_high_f64_f32(v));
+  }
+
+  f32_to_f64_scalar(dst + i, src + i, cnt - i);
+}
+
+static void f64_to_f32_neon(float *dst, const double *src, size_t cnt) {
+  size_t i = 0;
+  for (; i + 4 <= cnt; i += 4) {
+    float32x2_t lo = vcvt_f32_f64(vld1q_f64(src + i));
+    vst1q_f32(dst + i, vcvt_high_f32_f64(lo, vld1q_f64(src + i + 2)));
+  }
+
+  f64_to_f32_scalar(dst + i, src + i, cnt - i);
+}
+
+static const struct MsgKernels kernels_neon = {
+    .name = "neon",
+    .bswap32 = bswap32_neon,
+    .f32_to_f64 = f32_to_f64_neon,
+    .f64_to_f32 = f64_to_f32_neon,
+};
+#endif
+
+std::vector<const struct MsgKernels *> villas::node::msg_kernels_supported() {
+  std::vector<const struct MsgKernels *> supported = {&kernels_scalar};
+
+#if defined(__x86_64__) || defined(__i386__)
+  // Might be called by static constructors before main()
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("ssse3"))
+    supported.push_back(&kernels_sse);
+
+  if (__builtin_cpu_supports("avx2"))
+    supported.push_back(&kernels_avx2);
+#elif defined(__aarch64__)
+  supported.push_back(&kernels_neon);
+#endif
+
+  return supported;
+}
+
+static const struct MsgKernels *selected = nullptr;
+
+const struct MsgKernels *villas::node::msg_kernels() {
+  static const struct MsgKernels *fastest = msg_kernels_supported().back();
+
+  return selected ? selected : fastest;
+}
+
+void villas::node::msg_kernels_set(const struct MsgKernels *k) {
+  selected = k;
+}
@@ -62,7 +62,8 @@ int OpalAsyncIPFormat::sscan(const char *buf, size_t len, size_t *rbytes,
   unsigned i;
   auto *ptr = buf;
 
-  if (len % 8 != 0)
+  // A stream might end with a partial payload
+  if (len % 8 != 0 && !stream.active)
     return -1; // Packet size is invalid: Must be multiple of 8 bytes
 
   for (i = 0; i < cnt && ptr - buf + sizeof(struct Payload) < len; i++) {
@@ -70,8 +71,12 @@ int OpalAsyncIPFormat::sscan(const char *buf, size_t len, size_t *rbytes,
     auto *smp = smps[i];
 
     auto rlen = le16toh(pl->msg_len);
-    if (len < ptr - buf + rlen + sizeof(struct Payload))
+    if (len < ptr - buf + rlen + sizeof(struct Payload)) {
+      if (stream.active)
+        break; // Wait for remainder of the payload
+
       return -2;
+    }
 
     smp->sequence = le32toh(pl->msg_id);
     smp->length = rlen / sizeof(double);
@@ -91,6 +96,9 @@ int OpalAsyncIPFormat::sscan(const char *buf, size_t len, size_t *rbytes,
     ptr += rlen + sizeof(struct Payload);
   }
 
+  if (stream.active && ptr == buf && len > 0 && cnt > 0)
+    return NEED_MORE;
+
   if (rbytes)
     *rbytes = ptr - buf;
 
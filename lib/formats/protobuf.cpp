@@ -5,232 +5,571 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <cstring>
+
 #include <villas/exceptions.hpp>
 #include <villas/formats/protobuf.hpp>
 #include <villas/sample.hpp>
 #include <villas/signal.hpp>
 #include <villas/utils.hpp>
 
-// Generated message descriptors by protoc
-#include <villas/formats/villas.pb-c.h>
-
+using namespace villas;
 using namespace villas::node;
 
-static enum SignalType detect(const Villas__Node__Value *val) {
-  switch (val->value_case) {
-  case VILLAS__NODE__VALUE__VALUE_F:
-    return SignalType::FLOAT;
-
-  case VILLAS__NODE__VALUE__VALUE_I:
-    return SignalType::INTEGER;
+/* Wire codec for the messages defined in villas.proto.
+ *
+ * Samples are encoded directly from and decoded directly into struct Sample
+ * without intermediate message objects. The encoder emits the fields in the
+ * same order and encoding as protobuf-c did. The decoder skips unknown fields.
+ */
+namespace {
 
-  case VILLAS__NODE__VALUE__VALUE_B:
-    return SignalType::BOOLEAN;
+enum WireType : uint8_t { VARINT = 0, I64 = 1, LEN = 2, I32 = 5 };
 
-  case VILLAS__NODE__VALUE__VALUE_Z:
-    return SignalType::COMPLEX;
+constexpr uint32_t tag(uint32_t field, WireType type) {
+  return field << 3 | type;
+}
 
-  case VILLAS__NODE__VALUE__VALUE__NOT_SET:
-  default:
-    return SignalType::INVALID;
+namespace message {
+constexpr uint32_t SAMPLES = tag(1, LEN);
+} // namespace message
+
+namespace sample {
+constexpr uint32_t TYPE = tag(1, VARINT);
+constexpr uint32_t SEQUENCE = tag(2, VARINT);
+constexpr uint32_t TS_ORIGIN = tag(3, LEN);
+constexpr uint32_t NEW_FRAME = tag(5, VARINT);
+constexpr uint32_t VALUES = tag(100, LEN);
+
+constexpr uint64_t TYPE_DATA = 1;
+} // namespace sample
+
+namespace timestamp {
+constexpr uint32_t SEC = tag(1, VARINT);
+constexpr uint32_t NSEC = tag(2, VARINT);
+} // namespace timestamp
+
+namespace value {
+constexpr uint32_t F = tag(1, I64);
+constexpr uint32_t I = tag(2, VARINT);
+constexpr uint32_t B = tag(3, VARINT);
+constexpr uint32_t Z = tag(4, LEN);
+} // namespace value
+
+namespace complex {
+constexpr uint32_t REAL = tag(1, I32);
+constexpr uint32_t IMAG = tag(2, I32);
+} // namespace complex
+
+size_t varintSize(uint64_t v) {
+  size_t n = 1;
+
+  while (v >= 0x80) {
+    v >>= 7;
+    n++;
   }
+
+  return n;
 }
 
-int ProtobufFormat::sprint(char *buf, size_t len, size_t *wbytes,
-                           const struct Sample *const smps[], unsigned cnt) {
-  unsigned psz;
+// Size of a length-delimited field with a payload of len bytes
+size_t lenFieldSize(uint32_t t, size_t len) {
+  return varintSize(t) + varintSize(len) + len;
+}
 
-  auto *pb_msg = new Villas__Node__Message;
-  if (!pb_msg)
-    throw MemoryAllocationError();
+class Writer {
 
-  villas__node__message__init(pb_msg);
+protected:
+  uint8_t *ptr;
 
-  pb_msg->n_samples = cnt;
-  pb_msg->samples = new Villas__Node__Sample *[pb_msg->n_samples];
-  if (!pb_msg->samples)
-    throw MemoryAllocationError();
+public:
+  Writer(char *buf) : ptr((uint8_t *)buf) {}
 
-  for (unsigned i = 0; i < pb_msg->n_samples; i++) {
-    Villas__Node__Sample *pb_smp = pb_msg->samples[i] =
-        new Villas__Node__Sample;
-    if (!pb_msg->samples[i])
-      throw MemoryAllocationError();
+  char *position() const { return (char *)ptr; }
 
-    villas__node__sample__init(pb_smp);
+  void varint(uint64_t v) {
+    while (v >= 0x80) {
+      *ptr++ = (uint8_t)v | 0x80;
+      v >>= 7;
+    }
 
-    const struct Sample *smp = smps[i];
+    *ptr++ = (uint8_t)v;
+  }
 
-    pb_smp->type = VILLAS__NODE__SAMPLE__TYPE__DATA;
+  void fixed32(uint32_t v) {
+    for (int i = 0; i < 4; i++, v >>= 8)
+      *ptr++ = (uint8_t)v;
+  }
 
-    if (flags & smp->flags & (int)SampleFlags::HAS_SEQUENCE) {
-      pb_smp->has_sequence = 1;
-      pb_smp->sequence = smp->sequence;
-    }
+  void fixed64(uint64_t v) {
+    for (int i = 0; i < 8; i++, v >>= 8)
+      *ptr++ = (uint8_t)v;
+  }
 
-    if (flags & smp->flags & (int)SampleFlags::HAS_TS_ORIGIN) {
-      pb_smp->ts_origin = new Villas__Node__Timestamp;
-      if (!pb_smp->ts_origin)
-        throw MemoryAllocationError();
+  void field(uint32_t t, uint64_t v) {
+    varint(t);
+    varint(v);
+  }
 
-      villas__node__timestamp__init(pb_smp->ts_origin);
+  void header(uint32_t t, size_t len) {
+    varint(t);
+    varint(len);
+  }
+};
 
-      pb_smp->ts_origin->sec = smp->ts.origin.tv_sec;
-      pb_smp->ts_origin->nsec = smp->ts.origin.tv_nsec;
-    }
+class Reader {
 
-    pb_smp->n_values = smp->length;
-    pb_smp->values = new Villas__Node__Value *[pb_smp->n_values];
-    if (!pb_smp->values)
-      throw MemoryAllocationError();
+protected:
+  const uint8_t *ptr;
+  const uint8_t *end;
 
-    if (smp->flags & (int)SampleFlags::NEW_FRAME) {
-      pb_smp->has_new_frame = 1;
-      pb_smp->new_frame = 1;
+public:
+  Reader(const uint8_t *b, const uint8_t *e) : ptr(b), end(e) {}
+
+  bool done() const { return ptr >= end; }
+
+  bool varint(uint64_t *v) {
+    *v = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (ptr >= end)
+        return false;
+
+      uint8_t b = *ptr++;
+      *v |= (uint64_t)(b & 0x7f) << shift;
+
+      if (!(b & 0x80))
+        return true;
     }
 
-    for (unsigned j = 0; j < pb_smp->n_values; j++) {
-      Villas__Node__Value *pb_val = pb_smp->values[j] = new Villas__Node__Value;
-      if (!pb_val)
-        throw MemoryAllocationError();
+    return false;
+  }
 
-      villas__node__value__init(pb_val);
+  bool fixed32(uint32_t *v) {
+    if (end - ptr < 4)
+      return false;
 
-      enum SignalType fmt = sample_format(smp, j);
-      switch (fmt) {
-      case SignalType::FLOAT:
-        pb_val->value_case = VILLAS__NODE__VALUE__VALUE_F;
-        pb_val->f = smp->data[j].f;
-        break;
+    *v = 0;
+    for (int i = 0; i < 4; i++)
+      *v |= (uint32_t)*ptr++ << (8 * i);
 
-      case SignalType::INTEGER:
-        pb_val->value_case = VILLAS__NODE__VALUE__VALUE_I;
-        pb_val->i = smp->data[j].i;
-        break;
+    return true;
+  }
 
-      case SignalType::BOOLEAN:
-        pb_val->value_case = VILLAS__NODE__VALUE__VALUE_B;
-        pb_val->b = smp->data[j].b;
-        break;
+  bool fixed64(uint64_t *v) {
+    if (end - ptr < 8)
+      return false;
 
-      case SignalType::COMPLEX:
-        pb_val->value_case = VILLAS__NODE__VALUE__VALUE_Z;
-        pb_val->z = new Villas__Node__Complex;
-        if (!pb_val->z)
-          throw MemoryAllocationError();
+    *v = 0;
+    for (int i = 0; i < 8; i++)
+      *v |= (uint64_t)*ptr++ << (8 * i);
 
-        villas__node__complex__init(pb_val->z);
+    return true;
+  }
 
-        pb_val->z->real = std::real(smp->data[j].z);
-        pb_val->z->imag = std::imag(smp->data[j].z);
-        break;
+  // Split off the payload of a length-delimited field
+  bool sub(Reader *r) {
+    uint64_t len;
 
-      case SignalType::INVALID:
-        pb_val->value_case = VILLAS__NODE__VALUE__VALUE__NOT_SET;
-        break;
-      }
+    if (!varint(&len) || len > (uint64_t)(end - ptr))
+      return false;
+
+    *r = Reader(ptr, ptr + len);
+    ptr += len;
+
+    return true;
+  }
+
+  bool skip(uint32_t t) {
+    uint64_t v;
+    Reader r(nullptr, nullptr);
+
+    switch (t & 7) {
+    case VARINT:
+      return varint(&v);
+
+    case I64:
+      return fixed64(&v);
+
+    case LEN:
+      return sub(&r);
+
+    case I32:
+      if (end - ptr < 4)
+        return false;
+
+      ptr += 4;
+      return true;
+
+    default: // Groups are not used by villas.proto
+      return false;
     }
   }
 
-  psz = villas__node__message__get_packed_size(pb_msg);
+  size_t consumed(const char *buf) const { return (const char *)ptr - buf; }
+};
 
-  if (psz > len)
-    goto out;
+size_t timestampSize(const struct timespec *ts) {
+  return varintSize(timestamp::SEC) + varintSize((uint32_t)ts->tv_sec) +
+         varintSize(timestamp::NSEC) + varintSize((uint32_t)ts->tv_nsec);
+}
 
-  villas__node__message__pack(pb_msg, (uint8_t *)buf);
-  villas__node__message__free_unpacked(pb_msg, nullptr);
+size_t valueSize(enum SignalType type, const union SignalData *d) {
+  switch (type) {
+  case SignalType::FLOAT:
+    return varintSize(value::F) + sizeof(double);
 
-  *wbytes = psz;
+  case SignalType::INTEGER:
+    return varintSize(value::I) + varintSize(d->i);
 
-  return cnt;
+  case SignalType::BOOLEAN:
+    return varintSize(value::B) + 1;
 
-out:
-  villas__node__message__free_unpacked(pb_msg, nullptr);
+  case SignalType::COMPLEX:
+    return lenFieldSize(value::Z, 2 * (varintSize(complex::REAL) + 4));
 
-  return -1;
+  case SignalType::INVALID:
+  default:
+    return 0;
+  }
 }
 
-int ProtobufFormat::sscan(const char *buf, size_t len, size_t *rbytes,
-                          struct Sample *const smps[], unsigned cnt) {
-  unsigned i, j;
-  Villas__Node__Message *pb_msg;
+size_t sampleSize(const struct Sample *smp, int flags) {
+  size_t sz = varintSize(sample::TYPE) + varintSize(sample::TYPE_DATA);
 
-  pb_msg = villas__node__message__unpack(nullptr, len, (uint8_t *)buf);
-  if (!pb_msg)
-    return -1;
+  if (flags & smp->flags & (int)SampleFlags::HAS_SEQUENCE)
+    sz += varintSize(sample::SEQUENCE) + varintSize(smp->sequence);
+
+  if (flags & smp->flags & (int)SampleFlags::HAS_TS_ORIGIN)
+    sz += lenFieldSize(sample::TS_ORIGIN, timestampSize(&smp->ts.origin));
+
+  if (smp->flags & (int)SampleFlags::NEW_FRAME)
+    sz += varintSize(sample::NEW_FRAME) + 1;
+
+  for (unsigned j = 0; j < smp->length; j++)
+    sz += lenFieldSize(sample::VALUES,
+                       valueSize(sample_format(smp, j), &smp->data[j]));
+
+  return sz;
+}
+
+int scanValue(Reader *valr, struct Sample *smp, unsigned idx) {
+  enum SignalType fmt = SignalType::INVALID;
+  union SignalData d;
 
-  for (i = 0; i < MIN(pb_msg->n_samples, cnt); i++) {
-    struct Sample *smp = smps[i];
-    Villas__Node__Sample *pb_smp = pb_msg->samples[i];
+  while (!valr->done()) {
+    uint64_t t, v;
+    uint32_t bits[2];
+    bool has_real = false, has_imag = false;
+    Reader zr(nullptr, nullptr);
 
-    smp->flags = 0;
-    smp->signals = signals;
+    if (!valr->varint(&t))
+      return -1;
+
+    switch (t) {
+    case value::F:
+      if (!valr->fixed64(&v))
+        return -1;
+
+      memcpy(&d.f, &v, sizeof(d.f));
+      fmt = SignalType::FLOAT;
+      break;
+
+    case value::I:
+      if (!valr->varint(&v))
+        return -1;
+
+      d.i = v;
+      fmt = SignalType::INTEGER;
+      break;
+
+    case value::B:
+      if (!valr->varint(&v))
+        return -1;
+
+      d.b = v != 0;
+      fmt = SignalType::BOOLEAN;
+      break;
+
+    case value::Z:
+      if (!valr->sub(&zr))
+        return -1;
+
+      while (!zr.done()) {
+        if (!zr.varint(&t))
+          return -1;
+
+        if (t == complex::REAL) {
+          if (!zr.fixed32(&bits[0]))
+            return -1;
+
+          has_real = true;
+        } else if (t == complex::IMAG) {
+          if (!zr.fixed32(&bits[1]))
+            return -1;
+
+          has_imag = true;
+        } else if (!zr.skip(t))
+          return -1;
+      }
+
+      if (!has_real || !has_imag)
+        return -1;
+
+      {
+        float re, im;
+        memcpy(&re, &bits[0], sizeof(re));
+        memcpy(&im, &bits[1], sizeof(im));
+
+        d.z = std::complex<float>(re, im);
+      }
 
-    if (pb_smp->type != VILLAS__NODE__SAMPLE__TYPE__DATA)
-      throw RuntimeError("Parsed non supported message type. Skipping");
+      fmt = SignalType::COMPLEX;
+      break;
 
-    if (pb_smp->has_new_frame && pb_smp->new_frame) {
-      smp->flags |= (int)SampleFlags::NEW_FRAME;
+    default:
+      if (!valr->skip(t))
+        return -1;
     }
+  }
+
+  auto sig = smp->signals->getByIndex(idx);
+  if (!sig)
+    return -1;
+
+  if (sig->type != fmt)
+    throw RuntimeError("Received invalid data type in Protobuf payload: "
+                       "Received {}, expected {} for signal {} (index {}).",
+                       signalTypeToString(fmt), signalTypeToString(sig->type),
+                       sig->name, idx);
+
+  smp->data[idx] = d;
+
+  return 0;
+}
+
+int scanSample(Reader *smpr, struct Sample *smp, SignalList::Ptr signals) {
+  bool has_type = false;
+  unsigned j = 0;
+
+  smp->flags = 0;
+  smp->signals = signals;
+
+  while (!smpr->done()) {
+    uint64_t t, v;
+    Reader sub(nullptr, nullptr);
+
+    if (!smpr->varint(&t))
+      return -1;
+
+    switch (t) {
+    case sample::TYPE:
+      if (!smpr->varint(&v))
+        return -1;
+
+      if (v != sample::TYPE_DATA)
+        throw RuntimeError("Parsed non supported message type. Skipping");
+
+      has_type = true;
+      break;
+
+    case sample::SEQUENCE:
+      if (!smpr->varint(&v))
+        return -1;
 
-    if (pb_smp->has_sequence) {
       smp->flags |= (int)SampleFlags::HAS_SEQUENCE;
-      smp->sequence = pb_smp->sequence;
-    }
+      smp->sequence = v;
+      break;
+
+    case sample::TS_ORIGIN: {
+      bool has_sec = false, has_nsec = false;
+
+      if (!smpr->sub(&sub))
+        return -1;
+
+      while (!sub.done()) {
+        if (!sub.varint(&t))
+          return -1;
+
+        if (t == timestamp::SEC || t == timestamp::NSEC) {
+          if (!sub.varint(&v))
+            return -1;
+
+          if (t == timestamp::SEC) {
+            smp->ts.origin.tv_sec = (uint32_t)v;
+            has_sec = true;
+          } else {
+            smp->ts.origin.tv_nsec = (uint32_t)v;
+            has_nsec = true;
+          }
+        } else if (!sub.skip(t))
+          return -1;
+      }
+
+      if (!has_sec || !has_nsec)
+        return -1;
 
-    if (pb_smp->ts_origin) {
       smp->flags |= (int)SampleFlags::HAS_TS_ORIGIN;
-      smp->ts.origin.tv_sec = pb_smp->ts_origin->sec;
-      smp->ts.origin.tv_nsec = pb_smp->ts_origin->nsec;
+      break;
     }
 
-    for (j = 0; j < MIN(pb_smp->n_values, smp->capacity); j++) {
-      Villas__Node__Value *pb_val = pb_smp->values[j];
+    case sample::NEW_FRAME:
+      if (!smpr->varint(&v))
+        return -1;
 
-      enum SignalType fmt = detect(pb_val);
+      if (v)
+        smp->flags |= (int)SampleFlags::NEW_FRAME;
+      else
+        smp->flags &= ~(int)SampleFlags::NEW_FRAME;
+      break;
 
-      auto sig = smp->signals->getByIndex(j);
-      if (!sig)
+    case sample::VALUES: {
+      if (!smpr->sub(&sub))
         return -1;
 
-      if (sig->type != fmt)
-        throw RuntimeError("Received invalid data type in Protobuf payload: "
-                           "Received {}, expected {} for signal {} (index {}).",
-                           signalTypeToString(fmt),
-                           signalTypeToString(sig->type), sig->name, i);
+      smp->flags |= (int)SampleFlags::HAS_DATA;
+
+      if (j >= smp->capacity)
+        break;
+
+      int ret = scanValue(&sub, smp, j++);
+      if (ret)
+        return ret;
+
+      break;
+    }
+
+    default:
+      if (!smpr->skip(t))
+        return -1;
+    }
+  }
+
+  if (!has_type)
+    return -1;
+
+  smp->length = j;
+
+  return 0;
+}
+
+} // namespace
+
+int ProtobufFormat::sprint(char *buf, size_t len, size_t *wbytes,
+                           const struct Sample *const smps[], unsigned cnt) {
+  Writer w(buf);
+  size_t avail = len;
+
+  // Each sample is checked against the remaining space before it is written
+  for (unsigned i = 0; i < cnt; i++) {
+    const struct Sample *smp = smps[i];
 
-      switch (sig->type) {
-      case SignalType::FLOAT:
-        smp->data[j].f = pb_val->f;
+    size_t ssz = sampleSize(smp, flags);
+    size_t fsz = lenFieldSize(message::SAMPLES, ssz);
+    if (fsz > avail)
+      return -1;
+
+    avail -= fsz;
+
+    w.header(message::SAMPLES, ssz);
+    w.field(sample::TYPE, sample::TYPE_DATA);
+
+    if (flags & smp->flags & (int)SampleFlags::HAS_SEQUENCE)
+      w.field(sample::SEQUENCE, smp->sequence);
+
+    if (flags & smp->flags & (int)SampleFlags::HAS_TS_ORIGIN) {
+      w.header(sample::TS_ORIGIN, timestampSize(&smp->ts.origin));
+      w.field(timestamp::SEC, (uint32_t)smp->ts.origin.tv_sec);
+      w.field(timestamp::NSEC, (uint32_t)smp->ts.origin.tv_nsec);
+    }
+
+    if (smp->flags & (int)SampleFlags::NEW_FRAME)
+      w.field(sample::NEW_FRAME, 1);
+
+    for (unsigned j = 0; j < smp->length; j++) {
+      const union SignalData *d = &smp->data[j];
+      enum SignalType fmt = sample_format(smp, j);
+
+      w.header(sample::VALUES, valueSize(fmt, d));
+
+      switch (fmt) {
+      case SignalType::FLOAT: {
+        uint64_t bits;
+        memcpy(&bits, &d->f, sizeof(bits));
+
+        w.varint(value::F);
+        w.fixed64(bits);
         break;
+      }
 
       case SignalType::INTEGER:
-        smp->data[j].i = pb_val->i;
+        w.field(value::I, d->i);
         break;
 
       case SignalType::BOOLEAN:
-        smp->data[j].b = pb_val->b;
+        w.field(value::B, d->b);
         break;
 
-      case SignalType::COMPLEX:
-        smp->data[j].z = std::complex<float>(pb_val->z->real, pb_val->z->imag);
+      case SignalType::COMPLEX: {
+        float re = std::real(d->z), im = std::imag(d->z);
+        uint32_t bits[2];
+        memcpy(&bits[0], &re, sizeof(bits[0]));
+        memcpy(&bits[1], &im, sizeof(bits[1]));
+
+        w.header(value::Z, 2 * (varintSize(complex::REAL) + 4));
+        w.varint(complex::REAL);
+        w.fixed32(bits[0]);
+        w.varint(complex::IMAG);
+        w.fixed32(bits[1]);
         break;
-
-      default: {
       }
+
+      case SignalType::INVALID:
+        break;
       }
     }
+  }
 
-    if (pb_smp->n_values > 0)
-      smp->flags |= (int)SampleFlags::HAS_DATA;
+  *wbytes = w.position() - buf;
+
+  return cnt;
+}
+
+int ProtobufFormat::sscan(const char *buf, size_t len, size_t *rbytes,
+                          struct Sample *const smps[], unsigned cnt) {
+  unsigned i = 0;
+  Reader msg((const uint8_t *)buf, (const uint8_t *)buf + len);
 
-    smp->length = j;
+  while (!msg.done()) {
+    uint64_t t;
+    Reader smpr(nullptr, nullptr);
+
+    if (!msg.varint(&t))
+      return -1;
+
+    if (t != message::SAMPLES) {
+      if (!msg.skip(t))
+        return -1;
+
+      continue;
+    }
+
+    if (!msg.sub(&smpr))
+      return -1;
+
+    // Surplus samples are checked for validity but not stored
+    if (i >= cnt)
+      continue;
+
+    int ret = scanSample(&smpr, smps[i], signals);
+    if (ret)
+      return ret;
+
+    i++;
   }
 
   if (rbytes)
-    *rbytes = villas__node__message__get_packed_size(pb_msg);
-
-  villas__node__message__free_unpacked(pb_msg, nullptr);
+    *rbytes = msg.consumed(buf);
 
   return i;
 }
@@ -5,8 +5,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <cstring>
+#include <type_traits>
+
 #include <villas/compat.hpp>
 #include <villas/exceptions.hpp>
+#include <villas/formats/msg_kernels.hpp>
 #include <villas/formats/raw.hpp>
 #include <villas/sample.hpp>
 #include <villas/utils.hpp>
@@ -46,8 +50,9 @@ using namespace villas::node;
 // Convert integer of varying width to big/little endian byte order
 #define SWAP_INT_HTOX(o, b, n) (o ? htobe##b(n) : htole##b(n))
 
-int RawFormat::sprint(char *buf, size_t len, size_t *wbytes,
-                      const struct Sample *const smps[], unsigned cnt) {
+int RawFormat::sprintGeneric(char *buf, size_t len, size_t *wbytes,
+                             const struct Sample *const smps[],
+                             unsigned cnt) {
   int o = 0;
   size_t nlen;
 
@@ -267,8 +272,8 @@ out:
   return cnt;
 }
 
-int RawFormat::sscan(const char *buf, size_t len, size_t *rbytes,
-                     struct Sample *const smps[], unsigned cnt) {
+int RawFormat::sscanGeneric(const char *buf, size_t len, size_t *rbytes,
+                            struct Sample *const smps[], unsigned cnt) {
   void *vbuf = (void *)buf; // Avoid warning about invalid pointer cast
 
   int8_t *i8 = (int8_t *)vbuf;
@@ -449,22 +454,24 @@ int RawFormat::sscan(const char *buf, size_t len, size_t *rbytes,
 
       case 32:
         data->z = std::complex<float>(
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 32, f32[o++]),
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 32, f32[o++]));
-
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 32, f32[o]),
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 32, f32[o + 1]));
+        o += 2;
         break;
 
       case 64:
         data->z = std::complex<float>(
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 64, f64[o++]),
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 64, f64[o++]));
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 64, f64[o]),
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 64, f64[o + 1]));
+        o += 2;
         break;
 
 #if HAS_128BIT
       case 128:
         data->z = std::complex<float>(
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 128, f128[o++]),
-            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 128, f128[o++]));
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 128, f128[o]),
+            SWAP_FLOAT_XTOH(endianess == Endianess::BIG, 128, f128[o + 1]));
+        o += 2;
         break;
 #endif
       }
@@ -486,6 +493,451 @@ int RawFormat::sscan(const char *buf, size_t len, size_t *rbytes,
   return 1;
 }
 
+namespace villas {
+namespace node {
+
+/* Codec for a fixed word size, byte-order and header layout.
+ *
+ * The behaviour matches RawFormat::sprintGeneric() and sscanGeneric().
+ * Samples whose signals all have the same type are converted in a single
+ * loop without branches per value.
+ */
+template <typename U, bool big, bool fake> struct RawCodec {
+  static constexpr size_t W = sizeof(U);
+  static constexpr bool SWAP = W > 1 && big != (BYTE_ORDER == BIG_ENDIAN);
+
+  // Floating-point values are only supported for 32 and 64 bit words
+  static constexpr bool HAS_REAL = W == 4 || W == 8;
+
+  using I = std::make_signed_t<U>;
+  using F = std::conditional_t<W == 8, double, float>;
+
+  static_assert(sizeof(union SignalData) == sizeof(double),
+                "Values must be stored contiguously");
+
+  static U swap(U v) {
+    if constexpr (!SWAP)
+      return v;
+    else if constexpr (W == 2)
+      return __builtin_bswap16(v);
+    else if constexpr (W == 4)
+      return __builtin_bswap32(v);
+    else
+      return __builtin_bswap64(v);
+  }
+
+  static void put(char *p, U v) {
+    v = swap(v);
+    memcpy(p, &v, W);
+  }
+
+  static U get(const char *p) {
+    U v;
+    memcpy(&v, p, W);
+    return swap(v);
+  }
+
+  static void putReal(char *p, double d) {
+    if constexpr (HAS_REAL) {
+      F f = d;
+      U v;
+      memcpy(&v, &f, W);
+      put(p, v);
+    } else
+      put(p, (U)-1); // Not supported
+  }
+
+  static double getReal(const char *p) {
+    if constexpr (HAS_REAL) {
+      U v = get(p);
+      F f;
+      memcpy(&f, &v, W);
+      return f;
+    } else
+      return -1; // Not supported
+  }
+
+  // Header fields are sign-extended only for 8 bit words
+  static int64_t getHeader(const char *p) {
+    if constexpr (W == 1)
+      return (I)get(p);
+    else
+      return get(p);
+  }
+
+  static void putReals(char *p, const union SignalData *data, size_t n) {
+    if constexpr (W == 4) {
+      auto *k = msg_kernels();
+
+      k->f64_to_f32((float *)p, &data->f, n);
+      if (SWAP)
+        k->bswap32((uint32_t *)p, (const uint32_t *)p, n);
+    } else {
+      for (size_t j = 0; j < n; j++)
+        putReal(p + j * W, data[j].f);
+    }
+  }
+
+  static void getReals(union SignalData *data, const char *p, size_t n) {
+    if constexpr (W == 4) {
+      auto *k = msg_kernels();
+      uint32_t tmp[256];
+
+      for (size_t j = 0; j < n; j += ARRAY_LEN(tmp)) {
+        size_t m = MIN(n - j, ARRAY_LEN(tmp));
+
+        if (SWAP)
+          k->bswap32(tmp, (const uint32_t *)(p + j * W), m);
+        else
+          memcpy(tmp, p + j * W, m * W);
+
+        k->f32_to_f64(&data[j].f, (const float *)tmp, m);
+      }
+    } else {
+      for (size_t j = 0; j < n; j++)
+        data[j].f = getReal(p + j * W);
+    }
+  }
+
+  static void install(RawFormat *f) {
+    f->codec.sprint = sprint;
+    f->codec.sscan = sscan;
+
+    // 64 bit words in host byte order have the layout of union SignalData
+    if constexpr (W == 8 && !SWAP)
+      f->codec.sprintv = sprintv;
+    else
+      f->codec.sprintv = nullptr;
+  }
+
+  static int sprint(RawFormat *f, char *buf, size_t len, size_t *wbytes,
+                    const struct Sample *const smps[], unsigned cnt) {
+    size_t o = 0;
+
+    for (unsigned i = 0; i < cnt; i++) {
+      const struct Sample *smp = smps[i];
+
+      if constexpr (fake) {
+        if ((o + 3) * W >= len)
+          goto out;
+
+        put(buf + W * o++, smp->sequence);
+        put(buf + W * o++, smp->ts.origin.tv_sec);
+        put(buf + W * o++, smp->ts.origin.tv_nsec);
+      }
+
+      auto type = f->uniformType(smp->signals);
+      size_t n = smp->length;
+
+      if (type != SignalType::INVALID && type != SignalType::COMPLEX &&
+          n <= smp->signals->size() && (o + n) * W < len) {
+        char *p = buf + W * o;
+
+        if (type == SignalType::FLOAT)
+          putReals(p, smp->data, n);
+        else if (type == SignalType::INTEGER) {
+          for (size_t j = 0; j < n; j++)
+            put(p + j * W, smp->data[j].i);
+        } else {
+          for (size_t j = 0; j < n; j++)
+            put(p + j * W, smp->data[j].b ? 1 : 0);
+        }
+
+        o += n;
+        continue;
+      }
+
+      for (unsigned j = 0; j < smp->length; j++) {
+        enum SignalType fmt = sample_format(smp, j);
+        const union SignalData *data = &smp->data[j];
+
+        if ((o + (fmt == SignalType::COMPLEX ? 2 : 1)) * W >= len)
+          goto out;
+
+        switch (fmt) {
+        case SignalType::FLOAT:
+          putReal(buf + W * o++, data->f);
+          break;
+
+        case SignalType::INTEGER:
+          put(buf + W * o++, data->i);
+          break;
+
+        case SignalType::BOOLEAN:
+          put(buf + W * o++, data->b ? 1 : 0);
+          break;
+
+        case SignalType::COMPLEX:
+          putReal(buf + W * o++, std::real(data->z));
+          putReal(buf + W * o++, std::imag(data->z));
+          break;
+
+        case SignalType::INVALID:
+          return -1;
+        }
+      }
+    }
+
+  out:
+    if (wbytes)
+      *wbytes = o * W;
+
+    return cnt;
+  }
+
+  /* Reference the values of samples with only FLOAT or INTEGER signals in
+   * place. Headers and all other samples are printed to the scratch buffer.
+   */
+  static int sprintv(RawFormat *f, char *buf, size_t len, size_t *wbytes,
+                     struct iovec iov[], size_t *iovcnt,
+                     const struct Sample *const smps[], unsigned cnt) {
+    size_t o = 0, n = 0, total = 0;
+    unsigned i;
+
+    for (i = 0; i < cnt; i++) {
+      const struct Sample *smp = smps[i];
+
+      auto type = f->uniformType(smp->signals);
+      bool inplace =
+          (type == SignalType::FLOAT || type == SignalType::INTEGER) &&
+          smp->length <= smp->signals->size();
+
+      char *p = buf + o;
+      size_t bytes = 0;
+
+      if (!inplace) {
+        int ret = sprint(f, p, len - o, &bytes, &smps[i], 1);
+        if (ret < 0)
+          return ret;
+      } else if constexpr (fake) {
+        if (o + 3 * W > len)
+          break;
+
+        put(p, smp->sequence);
+        put(p + W, smp->ts.origin.tv_sec);
+        put(p + 2 * W, smp->ts.origin.tv_nsec);
+
+        bytes = 3 * W;
+      }
+
+      // Extend the previous vector if it ends at the current position
+      bool merge =
+          n > 0 && (char *)iov[n - 1].iov_base + iov[n - 1].iov_len == p;
+      size_t values = inplace ? smp->length * W : 0;
+
+      if (n + (bytes && !merge ? 1 : 0) + (values ? 1 : 0) > *iovcnt)
+        break;
+
+      if (bytes) {
+        if (merge)
+          iov[n - 1].iov_len += bytes;
+        else
+          iov[n++] = {p, bytes};
+
+        o += bytes;
+      }
+
+      if (values)
+        iov[n++] = {(void *)smp->data, values};
+
+      total += bytes + values;
+    }
+
+    *iovcnt = n;
+
+    if (wbytes)
+      *wbytes = total;
+
+    return i;
+  }
+
+  static int sscan(RawFormat *f, const char *buf, size_t len, size_t *rbytes,
+                   struct Sample *const smps[], unsigned cnt) {
+    struct Sample *smp = smps[0];
+
+    size_t o = 0;
+    size_t nlen = len / W;
+
+    if (cnt > 1)
+      return -1;
+
+    if (len % W)
+      return -1; // Invalid RAW Payload length
+
+    if constexpr (fake) {
+      if (nlen < 3)
+        return -1; // Received a packet with no fake header. Skipping...
+
+      smp->sequence = getHeader(buf + W * o++);
+      smp->ts.origin.tv_sec = getHeader(buf + W * o++);
+      smp->ts.origin.tv_nsec = getHeader(buf + W * o++);
+
+      smp->flags =
+          (int)SampleFlags::HAS_SEQUENCE | (int)SampleFlags::HAS_TS_ORIGIN;
+    } else {
+      smp->flags = 0;
+      smp->sequence = 0;
+      smp->ts.origin.tv_sec = 0;
+      smp->ts.origin.tv_nsec = 0;
+    }
+
+    smp->signals = f->signals;
+
+    auto type = f->uniformType(smp->signals);
+    size_t n = MIN(smp->capacity, nlen - o);
+    unsigned i = 0;
+
+    if (type != SignalType::INVALID && type != SignalType::COMPLEX &&
+        n <= smp->signals->size()) {
+      const char *p = buf + W * o;
+
+      if (type == SignalType::FLOAT)
+        getReals(smp->data, p, n);
+      else if (type == SignalType::INTEGER) {
+        for (size_t j = 0; j < n; j++)
+          smp->data[j].i = (I)get(p + j * W);
+      } else {
+        for (size_t j = 0; j < n; j++)
+          smp->data[j].b = get(p + j * W);
+      }
+
+      i = n;
+      o += n;
+    } else {
+      for (i = 0; i < smp->capacity && o < nlen; i++) {
+        enum SignalType fmt = sample_format(smp, i);
+        union SignalData *data = &smp->data[i];
+
+        switch (fmt) {
+        case SignalType::FLOAT:
+          data->f = getReal(buf + W * o++);
+          break;
+
+        case SignalType::INTEGER:
+          data->i = (I)get(buf + W * o++);
+          break;
+
+        case SignalType::BOOLEAN:
+          data->b = get(buf + W * o++);
+          break;
+
+        case SignalType::COMPLEX:
+          if (o + 2 > nlen)
+            return -1; // Truncated payload
+
+          data->z = std::complex<float>(getReal(buf + W * o),
+                                        getReal(buf + W * (o + 1)));
+          o += 2;
+          break;
+
+        case SignalType::INVALID:
+          return -1; // Unsupported format in RAW payload
+        }
+      }
+    }
+
+    smp->length = i;
+
+    if (rbytes)
+      *rbytes = o * W;
+
+    return 1;
+  }
+};
+
+} // namespace node
+} // namespace villas
+
+template <typename U>
+static void installCodec(RawFormat *f, bool big, bool fake) {
+  if (big) {
+    if (fake)
+      RawCodec<U, true, true>::install(f);
+    else
+      RawCodec<U, true, false>::install(f);
+  } else {
+    if (fake)
+      RawCodec<U, false, true>::install(f);
+    else
+      RawCodec<U, false, false>::install(f);
+  }
+}
+
+static enum SignalType signals_uniform_type(const SignalList::Ptr &sigs) {
+  if (!sigs || sigs->empty())
+    return SignalType::INVALID;
+
+  auto type = sigs->getByIndex(0)->type;
+
+  for (unsigned i = 1; i < sigs->size(); i++) {
+    if (sigs->getByIndex(i)->type != type)
+      return SignalType::INVALID;
+  }
+
+  return type;
+}
+
+enum SignalType RawFormat::uniformType(const SignalList::Ptr &sigs) const {
+  if (sigs == signals)
+    return uniform_type;
+
+  return signals_uniform_type(sigs);
+}
+
+void RawFormat::start() {
+  bool big = endianess == Endianess::BIG;
+
+  uniform_type = signals_uniform_type(signals);
+
+  switch (bits) {
+  case 8:
+    installCodec<uint8_t>(this, big, fake);
+    break;
+
+  case 16:
+    installCodec<uint16_t>(this, big, fake);
+    break;
+
+  case 32:
+    installCodec<uint32_t>(this, big, fake);
+    break;
+
+  case 64:
+    installCodec<uint64_t>(this, big, fake);
+    break;
+
+  default:
+    codec.sprint = nullptr;
+    codec.sscan = nullptr;
+    codec.sprintv = nullptr;
+  }
+}
+
+int RawFormat::sprint(char *buf, size_t len, size_t *wbytes,
+                      const struct Sample *const smps[], unsigned cnt) {
+  if (codec.sprint)
+    return codec.sprint(this, buf, len, wbytes, smps, cnt);
+
+  return sprintGeneric(buf, len, wbytes, smps, cnt);
+}
+
+int RawFormat::sprintv(char *buf, size_t len, size_t *wbytes,
+                       struct iovec iov[], size_t *iovcnt,
+                       const struct Sample *const smps[], unsigned cnt) {
+  if (codec.sprintv)
+    return codec.sprintv(this, buf, len, wbytes, iov, iovcnt, smps, cnt);
+
+  return Format::sprintv(buf, len, wbytes, iov, iovcnt, smps, cnt);
+}
+
+int RawFormat::sscan(const char *buf, size_t len, size_t *rbytes,
+                     struct Sample *const smps[], unsigned cnt) {
+  if (codec.sscan)
+    return codec.sscan(this, buf, len, rbytes, smps, cnt);
+
+  return sscanGeneric(buf, len, rbytes, smps, cnt);
+}
+
 void RawFormat::parse(json_t *json) {
   int ret;
   json_error_t err;
@@ -7,6 +7,7 @@
 
 #include <arpa/inet.h>
 #include <cstring>
+#include <endian.h>
 
 #include <villas/exceptions.hpp>
 #include <villas/formats/msg.hpp>
@@ -18,6 +19,45 @@
 using namespace villas;
 using namespace villas::node;
 
+int VillasBinaryFormat::sprintBatch(char *buf, size_t len, size_t *wbytes,
+                                    const struct Sample *const smps[],
+                                    unsigned cnt) {
+  int ret;
+  unsigned i = 0, n;
+  char *ptr = buf;
+
+  for (i = 0; i < cnt; i += n) {
+    struct MessageBatch *b = (struct MessageBatch *)ptr;
+    const struct Sample *smp = smps[i];
+
+    size_t avail = buf + len - ptr;
+    if (avail < MSG_BATCH_LEN(1, smp->length))
+      break;
+
+    // Limit the batch to the remaining space of the buffer
+    size_t per_sample = sizeof(uint32_t) + MSG_DATA_LEN(smp->length);
+
+    n = msg_batch_count(&smps[i], cnt - i);
+    n = MIN(n, (avail - sizeof(struct MessageBatch)) / per_sample);
+
+    ret = msg_batch_from_samples(b, &smps[i], n, smp->signals, source_index);
+    if (ret)
+      return ret;
+
+    if (web)
+      msg_batch_htole(b);
+    else
+      msg_batch_hton(b);
+
+    ptr += MSG_BATCH_LEN(n, smp->length);
+  }
+
+  if (wbytes)
+    *wbytes = ptr - buf;
+
+  return i;
+}
+
 int VillasBinaryFormat::sprint(char *buf, size_t len, size_t *wbytes,
                                const struct Sample *const smps[],
                                unsigned cnt) {
@@ -25,6 +65,9 @@ int VillasBinaryFormat::sprint(char *buf, size_t len, size_t *wbytes,
   unsigned i = 0;
   char *ptr = buf;
 
+  if (version.load(std::memory_order_relaxed) == MSG_BATCH_VERSION)
+    return sprintBatch(buf, len, wbytes, smps, cnt);
+
   for (i = 0; i < cnt; i++) {
     struct Message *msg = (struct Message *)ptr;
     const struct Sample *smp = smps[i];
@@ -50,14 +93,81 @@ int VillasBinaryFormat::sprint(char *buf, size_t len, size_t *wbytes,
   return i;
 }
 
+int VillasBinaryFormat::sscanBatch(const char *buf, size_t len, size_t *rbytes,
+                                   struct Sample *const smps[], unsigned cnt,
+                                   bool head, uint8_t *sid) {
+  int ret;
+  struct MessageBatch *b = (struct MessageBatch *)buf;
+
+  // Samples of this batch have already been returned by the previous call
+  unsigned first = head && stream.active ? stream.skip : 0;
+
+  // Check if header is still in buffer bounaries
+  if (len < sizeof(struct MessageBatch))
+    return stream.active ? NEED_MORE : -2;
+
+  // The batch has already been converted if it has been returned partially
+  bool host = first > 0;
+
+  unsigned count, values;
+  if (host) {
+    count = b->count;
+    values = b->length;
+  } else if (web) {
+    count = le16toh(b->count);
+    values = le16toh(b->length);
+  } else {
+    count = ntohs(b->count);
+    values = ntohs(b->length);
+  }
+
+  if (count == 0)
+    return -4; // Invalid batch received
+
+  // Check if remainder of the batch is in buffer boundaries
+  if (MSG_BATCH_LEN(count, values) > len)
+    return stream.active ? NEED_MORE : -3;
+
+  // Leave the batch for the next call if it can not be returned completely
+  if (count - first > cnt && stream.active && !head)
+    return 0;
+
+  if (!host) {
+    if (web)
+      msg_batch_letoh(b);
+    else
+      msg_batch_ntoh(b);
+  }
+
+  ret = msg_batch_to_samples(b, first, smps, cnt, signals, sid);
+  if (ret < 0)
+    return ret; // Invalid batch received
+
+  if (negotiate)
+    version.store(MSG_BATCH_VERSION, std::memory_order_relaxed);
+
+  // The remaining samples of a stream are returned by the next call
+  if (stream.active && first + ret < count) {
+    stream.skip = first + ret;
+    *rbytes = 0;
+  } else {
+    stream.skip = 0;
+    *rbytes = MSG_BATCH_LEN(count, values);
+  }
+
+  return ret;
+}
+
 int VillasBinaryFormat::sscan(const char *buf, size_t len, size_t *rbytes,
                               struct Sample *const smps[], unsigned cnt) {
   int ret, values;
   unsigned i, j;
   const char *ptr = buf;
   uint8_t sid; // source_index
+  size_t rlen;
 
-  if (len % 4 != 0)
+  // A stream might end with a partial message
+  if (len % 4 != 0 && !stream.active)
     return -1; // Packet size is invalid: Must be multiple of 4 bytes
 
   for (i = 0, j = 0; i < cnt; i++) {
@@ -70,15 +180,43 @@ int VillasBinaryFormat::sscan(const char *buf, size_t len, size_t *rbytes,
     if (ptr == buf + len)
       break;
 
+    if (msg->version == MSG_BATCH_VERSION) {
+      ret = sscanBatch(ptr, buf + len - ptr, &rlen, &smps[j], cnt - i, i == 0,
+                       &sid);
+      if (ret == NEED_MORE)
+        break; // Wait for remainder of the batch
+      else if (ret < 0)
+        return ret;
+      else if (ret == 0)
+        break; // Batch is left for the next call
+
+      if (validate_source_index && sid != source_index) {
+        // source index mismatch: we skip these samples
+      } else
+        j += ret;
+
+      i += ret - 1;
+      ptr += rlen;
+      continue;
+    }
+
     // Check if header is still in buffer bounaries
-    if (ptr + sizeof(struct Message) > buf + len)
+    if (ptr + sizeof(struct Message) > buf + len) {
+      if (stream.active)
+        break; // Wait for remainder of the message
+
       return -2; // Invalid msg received
+    }
 
     values = web ? msg->length : ntohs(msg->length);
 
     // Check if remainder of message is in buffer boundaries
-    if (ptr + MSG_LEN(values) > buf + len)
+    if (ptr + MSG_LEN(values) > buf + len) {
+      if (stream.active)
+        break; // Wait for remainder of the message
+
       return -3; // Invalid msg receive
+    }
 
     if (web) {
       // TODO: convert from little endian
@@ -89,14 +227,20 @@ int VillasBinaryFormat::sscan(const char *buf, size_t len, size_t *rbytes,
     if (ret)
       return ret; // Invalid msg received
 
+    if (negotiate)
+      version.store(MSG_VERSION, std::memory_order_relaxed);
+
     if (validate_source_index && sid != source_index) {
       // source index mismatch: we skip this sample
     } else
       j++;
 
-    ptr += MSG_LEN(smp->length);
+    ptr += MSG_LEN(values);
   }
 
+  if (stream.active && i == 0 && len > 0 && cnt > 0)
+    return NEED_MORE;
+
   if (rbytes)
     *rbytes = ptr - buf;
 
@@ -108,13 +252,32 @@ void VillasBinaryFormat::parse(json_t *json) {
   json_error_t err;
   int sid = -1;
   int vsi = -1;
+  json_t *json_version = nullptr;
 
-  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: b }", "source_index", &sid,
-                       "validate_source_index", &vsi);
+  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: b, s?: o }",
+                       "source_index", &sid, "validate_source_index", &vsi,
+                       "version", &json_version);
   if (ret)
     throw ConfigError(json, err, "node-config-format-villas-binary",
                       "Failed to parse format configuration");
 
+  if (json_version) {
+    if (json_is_string(json_version) &&
+        !strcmp(json_string_value(json_version), "auto")) {
+      version.store(MSG_VERSION, std::memory_order_relaxed);
+      negotiate = true;
+    } else if (json_is_integer(json_version) &&
+               (json_integer_value(json_version) == MSG_VERSION ||
+                json_integer_value(json_version) == MSG_BATCH_VERSION)) {
+      version.store(json_integer_value(json_version),
+                    std::memory_order_relaxed);
+      negotiate = false;
+    } else
+      throw ConfigError(json_version,
+                        "node-config-format-villas-binary-version",
+                        "Version must be either 2, 3 or 'auto'");
+  }
+
   if (vsi >= 0)
     validate_source_index = vsi != 0;
 
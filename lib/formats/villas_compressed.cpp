@@ -0,0 +1,694 @@
+/* Compressed time-series format.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <vector>
+
+#include <villas/exceptions.hpp>
+#include <villas/formats/villas_compressed.hpp>
+#include <villas/sample.hpp>
+#include <villas/signal.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+namespace {
+
+// Writes a stream of bits MSB first.
+class BitWriter {
+
+protected:
+  uint8_t *buf;
+  size_t len;
+  size_t off;
+
+  uint64_t acc;  // Bits which have not been written yet
+  unsigned fill; // Number of valid bits in acc (always < 8 between calls)
+  bool ok;
+
+public:
+  BitWriter(uint8_t *b, size_t l)
+      : buf(b), len(l), off(0), acc(0), fill(0), ok(true) {}
+
+  bool isOk() const { return ok; }
+
+  // Pad to the next byte boundary and return the number of written bytes
+  size_t finish() {
+    if (fill > 0)
+      put(0, 8 - fill);
+
+    return off;
+  }
+
+  void put(uint64_t v, unsigned n) {
+    if (n > 32) {
+      put(v >> 32, n - 32);
+      n = 32;
+    }
+
+    if (n == 0)
+      return;
+
+    acc = (acc << n) | (v & ((1ULL << n) - 1));
+    fill += n;
+
+    while (fill >= 8) {
+      fill -= 8;
+
+      if (off >= len) {
+        ok = false;
+        return;
+      }
+
+      buf[off++] = acc >> fill;
+    }
+  }
+
+  void bit(bool b) { put(b, 1); }
+};
+
+// Reads a stream of bits MSB first.
+class BitReader {
+
+protected:
+  const uint8_t *buf;
+  size_t len;
+  size_t off;
+
+  uint64_t acc;
+  unsigned fill;
+  bool ok;
+
+public:
+  BitReader(const uint8_t *b, size_t l)
+      : buf(b), len(l), off(0), acc(0), fill(0), ok(true) {}
+
+  bool isOk() const { return ok; }
+
+  void fail() { ok = false; }
+
+  uint64_t get(unsigned n) {
+    if (n > 32) {
+      uint64_t hi = get(n - 32);
+
+      return (hi << 32) | get(32);
+    }
+
+    if (n == 0)
+      return 0;
+
+    while (fill < n) {
+      if (off >= len) {
+        ok = false;
+        return 0;
+      }
+
+      acc = (acc << 8) | buf[off++];
+      fill += 8;
+    }
+
+    fill -= n;
+
+    return (acc >> fill) & ((1ULL << n) - 1);
+  }
+
+  bool bit() { return get(1); }
+};
+
+uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+
+int64_t unzigzag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+/* Variable-length code for signed integers which are usually small.
+ *
+ * Based on the delta-of-delta encoding of timestamps in Gorilla, with wider
+ * buckets to cover nanosecond resolution.
+ */
+void putSigned(BitWriter &w, int64_t v) {
+  uint64_t u = zigzag(v);
+
+  if (u == 0)
+    w.put(0b0, 1);
+  else if (u < (1ULL << 7)) {
+    w.put(0b10, 2);
+    w.put(u, 7);
+  } else if (u < (1ULL << 9)) {
+    w.put(0b110, 3);
+    w.put(u, 9);
+  } else if (u < (1ULL << 12)) {
+    w.put(0b1110, 4);
+    w.put(u, 12);
+  } else if (u < (1ULL << 32)) {
+    w.put(0b11110, 5);
+    w.put(u, 32);
+  } else {
+    w.put(0b11111, 5);
+    w.put(u, 64);
+  }
+}
+
+int64_t getSigned(BitReader &r) {
+  static const unsigned widths[] = {7, 9, 12, 32, 64};
+  unsigned prefix = 0;
+
+  while (prefix < 5 && r.bit())
+    prefix++;
+
+  if (prefix == 0)
+    return 0;
+
+  return unzigzag(r.get(widths[prefix - 1]));
+}
+
+/* State of the XOR compression of floating-point values.
+ *
+ * Values are XOR'ed with their predecessor. Only the meaningful bits of the
+ * result are stored, reusing the window of leading and trailing zeros of the
+ * previous value if possible.
+ */
+template <typename T, unsigned N = sizeof(T) * 8> struct XorState {
+  static constexpr unsigned BITS = N == 64 ? 6 : 5;
+
+  T prev = 0;
+  unsigned lead = N;
+  unsigned trail = 0;
+
+  static unsigned clz(T x) {
+    return N == 64 ? __builtin_clzll(x) : __builtin_clz(x);
+  }
+
+  static unsigned ctz(T x) {
+    return N == 64 ? __builtin_ctzll(x) : __builtin_ctz(x);
+  }
+
+  void put(BitWriter &w, T v) {
+    T x = v ^ prev;
+    prev = v;
+
+    if (x == 0) {
+      w.put(0b0, 1);
+      return;
+    }
+
+    unsigned l = clz(x), t = ctz(x);
+
+    if (l >= lead && t >= trail) {
+      w.put(0b10, 2);
+      w.put(x >> trail, N - lead - trail);
+    } else {
+      lead = l;
+      trail = t;
+
+      w.put(0b11, 2);
+      w.put(lead, BITS);
+      w.put(N - lead - trail - 1, BITS);
+      w.put(x >> trail, N - lead - trail);
+    }
+  }
+
+  T get(BitReader &r) {
+    if (!r.bit())
+      return prev;
+
+    if (r.bit()) {
+      lead = r.get(BITS);
+      unsigned sig = r.get(BITS) + 1;
+
+      if (lead + sig > N) {
+        r.fail(); // Corrupted frame
+        return prev;
+      }
+
+      trail = N - lead - sig;
+    }
+
+    prev ^= (T)r.get(N - lead - trail) << trail;
+
+    return prev;
+  }
+};
+
+// Signal types as encoded in the frame
+enum class ColumnType : uint8_t { FLOAT, INTEGER, BOOLEAN, COMPLEX };
+
+bool toColumnType(enum SignalType st, ColumnType *ct) {
+  switch (st) {
+  case SignalType::FLOAT:
+    *ct = ColumnType::FLOAT;
+    return true;
+
+  case SignalType::INTEGER:
+    *ct = ColumnType::INTEGER;
+    return true;
+
+  case SignalType::BOOLEAN:
+    *ct = ColumnType::BOOLEAN;
+    return true;
+
+  case SignalType::COMPLEX:
+    *ct = ColumnType::COMPLEX;
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+uint8_t headerChecksum(const VillasCompressedFormat::Header *hdr) {
+  auto *bytes = (const uint8_t *)hdr;
+  uint8_t sum = 0;
+
+  for (size_t i = 0; i < sizeof(*hdr); i++)
+    sum ^= bytes[i];
+
+  return sum;
+}
+
+int64_t toNanoseconds(const struct timespec &ts) {
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+struct timespec fromNanoseconds(int64_t ns) {
+  struct timespec ts;
+
+  ts.tv_sec = ns / 1000000000LL;
+  ts.tv_nsec = ns % 1000000000LL;
+
+  if (ts.tv_nsec < 0) {
+    ts.tv_sec--;
+    ts.tv_nsec += 1000000000LL;
+  }
+
+  return ts;
+}
+
+} // namespace
+
+int VillasCompressedFormat::sprint(char *buf, size_t len, size_t *wbytes,
+                                   const struct Sample *const smps[],
+                                   unsigned cnt) {
+  auto *hdr = (struct Header *)buf;
+  unsigned columns = 0;
+  uint8_t fields = 0;
+
+  if (len < sizeof(struct Header) || cnt > UINT16_MAX)
+    return -1;
+
+  if (flags & (int)SampleFlags::HAS_SEQUENCE)
+    fields |= SEQUENCE;
+
+  if (flags & (int)SampleFlags::HAS_TS_ORIGIN)
+    fields |= TS_ORIGIN;
+
+  // Fields are only encoded if all samples of the frame have them
+  for (unsigned i = 0; i < cnt; i++) {
+    const struct Sample *smp = smps[i];
+
+    if (!(smp->flags & (int)SampleFlags::HAS_SEQUENCE))
+      fields &= ~SEQUENCE;
+
+    if (!(smp->flags & (int)SampleFlags::HAS_TS_ORIGIN))
+      fields &= ~TS_ORIGIN;
+
+    if (smp->length > columns)
+      columns = smp->length;
+  }
+
+  if (!(flags & (int)SampleFlags::HAS_DATA))
+    columns = 0;
+
+  if (columns > UINT16_MAX)
+    return -1;
+
+  BitWriter w((uint8_t *)buf + sizeof(struct Header),
+              len - sizeof(struct Header));
+
+  // Column types are taken from the longest sample
+  std::vector<ColumnType> types(columns);
+  for (unsigned i = 0; i < cnt && columns > 0; i++) {
+    const struct Sample *smp = smps[i];
+
+    if (smp->length != columns)
+      continue;
+
+    for (unsigned j = 0; j < columns; j++) {
+      auto sig = smp->signals->getByIndex(j);
+      if (!sig || !toColumnType(sig->type, &types[j]))
+        return -1;
+
+      w.put((uint8_t)types[j], 2);
+    }
+
+    break;
+  }
+
+  // Sample lengths are only stored if they differ from the previous one
+  unsigned prev_length = columns;
+  for (unsigned i = 0; i < cnt; i++) {
+    unsigned length = std::min<unsigned>(smps[i]->length, columns);
+
+    if (length == prev_length)
+      w.bit(0);
+    else {
+      w.bit(1);
+      w.put(length, 16);
+    }
+
+    prev_length = length;
+  }
+
+  if (fields & SEQUENCE) {
+    for (unsigned i = 0; i < cnt; i++) {
+      if (i == 0)
+        w.put(smps[i]->sequence, 64);
+      else
+        putSigned(w, smps[i]->sequence - smps[i - 1]->sequence - 1);
+    }
+  }
+
+  if (fields & TS_ORIGIN) {
+    int64_t prev = 0, prev_delta = 0;
+
+    for (unsigned i = 0; i < cnt; i++) {
+      int64_t ts = toNanoseconds(smps[i]->ts.origin);
+      int64_t delta = ts - prev;
+
+      if (i == 0)
+        w.put(ts, 64);
+      else
+        putSigned(w, delta - prev_delta);
+
+      prev = ts;
+      prev_delta = i == 0 ? 0 : delta;
+    }
+  }
+
+  // The values are encoded column by column
+  for (unsigned j = 0; j < columns; j++) {
+    XorState<uint64_t> xf;
+    XorState<uint32_t> xr, xi;
+    int64_t prev_int = 0;
+
+    for (unsigned i = 0; i < cnt; i++) {
+      const struct Sample *smp = smps[i];
+
+      if (j >= smp->length)
+        continue;
+
+      const auto &data = smp->data[j];
+
+      switch (types[j]) {
+      case ColumnType::FLOAT: {
+        uint64_t bits;
+        memcpy(&bits, &data.f, sizeof(bits));
+        xf.put(w, bits);
+        break;
+      }
+
+      case ColumnType::INTEGER:
+        putSigned(w, data.i - prev_int);
+        prev_int = data.i;
+        break;
+
+      case ColumnType::BOOLEAN:
+        w.bit(data.b);
+        break;
+
+      case ColumnType::COMPLEX: {
+        float re = std::real(data.z), im = std::imag(data.z);
+        uint32_t bits_re, bits_im;
+
+        memcpy(&bits_re, &re, sizeof(bits_re));
+        memcpy(&bits_im, &im, sizeof(bits_im));
+
+        xr.put(w, bits_re);
+        xi.put(w, bits_im);
+        break;
+      }
+      }
+    }
+  }
+
+  size_t payload = w.finish();
+  if (!w.isOk())
+    return -1; // The buffer is too small
+
+  hdr->magic[0] = MAGIC[0];
+  hdr->magic[1] = MAGIC[1];
+  hdr->version = VERSION;
+  hdr->fields = fields;
+  hdr->checksum = 0;
+  hdr->count = htons(cnt);
+  hdr->columns = htons(columns);
+  hdr->length = htonl(payload);
+  hdr->checksum = headerChecksum(hdr);
+
+  if (wbytes)
+    *wbytes = sizeof(struct Header) + payload;
+
+  return cnt;
+}
+
+bool VillasCompressedFormat::checkHeader(const struct Header *hdr) const {
+  return hdr->magic[0] == MAGIC[0] && hdr->magic[1] == MAGIC[1] &&
+         hdr->version == VERSION && headerChecksum(hdr) == 0;
+}
+
+int VillasCompressedFormat::decodeFrame(const struct Header *hdr,
+                                        const uint8_t *payload,
+                                        struct Sample *const smps[],
+                                        unsigned cnt, unsigned first) {
+  unsigned count = ntohs(hdr->count);
+  unsigned columns = ntohs(hdr->columns);
+
+  if (first > count)
+    return -1;
+
+  BitReader r(payload, ntohl(hdr->length));
+
+  // The sample of the frame at index i is stored in smps[i - first]
+  auto sample = [&](unsigned i) -> struct Sample * {
+    return i >= first && i - first < cnt ? smps[i - first] : nullptr;
+  };
+
+  // Samples outside of [first, first + cnt) are decoded but dropped
+  std::vector<unsigned> lengths(count);
+  std::vector<ColumnType> types(columns);
+
+  for (unsigned j = 0; j < columns; j++) {
+    types[j] = (ColumnType)r.get(2);
+
+    auto sig = signals->getByIndex(j);
+    ColumnType expected;
+
+    if (sig && (!toColumnType(sig->type, &expected) || expected != types[j]))
+      throw RuntimeError("Received invalid data type in compressed payload "
+                         "for signal {} (index {}).",
+                         sig->name, j);
+  }
+
+  unsigned prev_length = columns;
+  for (unsigned i = 0; i < count; i++) {
+    lengths[i] = r.bit() ? r.get(16) : prev_length;
+    prev_length = lengths[i];
+
+    if (lengths[i] > columns)
+      return -1;
+
+    struct Sample *smp = sample(i);
+    if (smp) {
+      smp->signals = signals;
+      smp->flags = 0;
+      smp->length = std::min(lengths[i], smp->capacity);
+
+      if (smp->length > 0)
+        smp->flags |= (int)SampleFlags::HAS_DATA;
+    }
+  }
+
+  if (hdr->fields & SEQUENCE) {
+    uint64_t seq = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+      seq = i == 0 ? r.get(64) : seq + 1 + getSigned(r);
+
+      struct Sample *smp = sample(i);
+      if (smp) {
+        smp->sequence = seq;
+        smp->flags |= (int)SampleFlags::HAS_SEQUENCE;
+      }
+    }
+  }
+
+  if (hdr->fields & TS_ORIGIN) {
+    int64_t ts = 0, delta = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+      if (i == 0)
+        ts = r.get(64);
+      else {
+        delta += getSigned(r);
+        ts += delta;
+      }
+
+      struct Sample *smp = sample(i);
+      if (smp) {
+        smp->ts.origin = fromNanoseconds(ts);
+        smp->flags |= (int)SampleFlags::HAS_TS_ORIGIN;
+      }
+    }
+  }
+
+  for (unsigned j = 0; j < columns; j++) {
+    XorState<uint64_t> xf;
+    XorState<uint32_t> xr, xi;
+    int64_t prev_int = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+      if (j >= lengths[i])
+        continue;
+
+      union SignalData data;
+
+      switch (types[j]) {
+      case ColumnType::FLOAT: {
+        uint64_t bits = xf.get(r);
+        memcpy(&data.f, &bits, sizeof(bits));
+        break;
+      }
+
+      case ColumnType::INTEGER:
+        prev_int += getSigned(r);
+        data.i = prev_int;
+        break;
+
+      case ColumnType::BOOLEAN:
+        data.b = r.bit();
+        break;
+
+      case ColumnType::COMPLEX: {
+        uint32_t bits_re = xr.get(r), bits_im = xi.get(r);
+        float re, im;
+
+        memcpy(&re, &bits_re, sizeof(re));
+        memcpy(&im, &bits_im, sizeof(im));
+
+        data.z = std::complex<float>(re, im);
+        break;
+      }
+      }
+
+      struct Sample *smp = sample(i);
+      if (smp && j < smp->capacity)
+        smp->data[j] = data;
+    }
+  }
+
+  if (!r.isOk())
+    return -1;
+
+  return std::min(count - first, cnt);
+}
+
+int VillasCompressedFormat::sscan(const char *buf, size_t len, size_t *rbytes,
+                                  struct Sample *const smps[], unsigned cnt) {
+  const char *ptr = buf;
+  unsigned i = 0;
+
+  while (i < cnt && ptr < buf + len) {
+    auto *hdr = (const struct Header *)ptr;
+
+    // Samples of the first frame have already been returned by the previous call
+    unsigned first = stream.active && ptr == buf ? stream.skip : 0;
+    size_t avail = buf + len - ptr;
+
+    // Check if header is still in buffer boundaries
+    if (avail < sizeof(struct Header)) {
+      if (stream.active)
+        break; // Wait for remainder of the frame
+
+      return -1;
+    }
+
+    if (!checkHeader(hdr)) {
+      if (!stream.active)
+        return -1;
+
+      // Resynchronize with the next frame
+      auto *next = (const char *)memmem(ptr + 1, avail - 1, MAGIC, 2);
+      if (!next) {
+        // The last byte could be the start of the next magic number
+        ptr = buf + len - 1;
+        break;
+      }
+
+      logger->warn("Skipped {} bytes of invalid data", next - ptr);
+
+      ptr = next;
+      stream.skip = 0;
+      continue;
+    }
+
+    size_t framelen = sizeof(struct Header) + ntohl(hdr->length);
+
+    // Check if remainder of frame is in buffer boundaries
+    if (framelen > avail) {
+      if (stream.active)
+        break; // Wait for remainder of the frame
+
+      return -1;
+    }
+
+    unsigned count = ntohs(hdr->count);
+
+    // We only split the first frame while streaming
+    if (stream.active && i > 0 && count > cnt - i)
+      break;
+
+    int ret = decodeFrame(hdr, (const uint8_t *)(hdr + 1), smps + i, cnt - i,
+                          first);
+    if (ret < 0) {
+      if (!stream.active)
+        return -1;
+
+      // Skip the magic number of the corrupted frame
+      ptr += 1;
+      stream.skip = 0;
+      continue;
+    }
+
+    i += ret;
+
+    // The remaining samples of the frame are returned by the next call
+    if (stream.active && first + ret < count) {
+      stream.skip = first + ret;
+      break;
+    }
+
+    stream.skip = 0;
+    ptr += framelen;
+  }
+
+  if (stream.active && i == 0 && ptr == buf && len > 0 && cnt > 0)
+    return NEED_MORE;
+
+  if (rbytes)
+    *rbytes = ptr - buf;
+
+  return i;
+}
+
+// Register format
+static char n[] = "villas.compressed";
+static char d[] = "VILLAS binary format with compressed time-series";
+static FormatPlugin<VillasCompressedFormat, n, d,
+                    (int)SampleFlags::HAS_TS_ORIGIN |
+                        (int)SampleFlags::HAS_SEQUENCE |
+                        (int)SampleFlags::HAS_DATA>
+    p;
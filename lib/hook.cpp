@@ -26,7 +26,7 @@ Hook::Hook(Path *p, Node *n, int fl, int prio, bool en)
       state(fl & (int)Hook::Flags::BUILTIN
                 ? State::CHECKED
                 : State::INITIALIZED), // We dont need to parse builtin hooks
-      flags(fl), priority(prio), enabled(en), path(p), node(n),
+      flags(fl), priority(prio), enabled(en), fusable(true), path(p), node(n),
       signals(std::make_shared<SignalList>()), config(nullptr) {}
 
 void Hook::prepare(SignalList::Ptr sigs) {
@@ -39,6 +39,29 @@ void Hook::prepare(SignalList::Ptr sigs) {
   state = State::PREPARED;
 }
 
+int Hook::processBatch(struct Sample *smps[], unsigned cnt,
+                       Reason reasons[]) {
+  unsigned passed = 0;
+
+  for (unsigned i = 0; i < cnt; i++) {
+    reasons[i] = process(smps[i]);
+
+    switch (reasons[i]) {
+    case Reason::ERROR:
+      return -1;
+
+    case Reason::OK:
+      passed++;
+      break;
+
+    default: {
+    }
+    }
+  }
+
+  return passed;
+}
+
 void Hook::parse(json_t *json) {
   int ret;
   json_error_t err;
@@ -47,9 +70,10 @@ void Hook::parse(json_t *json) {
 
   int prio = -1;
   int en = -1;
+  int fu = -1;
 
-  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: b }", "priority", &prio,
-                       "enabled", &en);
+  ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: b, s?: b }", "priority",
+                       &prio, "enabled", &en, "fuse", &fu);
   if (ret)
     throw ConfigError(json, err, "node-config-hook");
 
@@ -59,6 +83,9 @@ void Hook::parse(json_t *json) {
   if (en >= 0)
     enabled = en;
 
+  if (fu >= 0)
+    fusable = fu;
+
   config = json;
 
   state = State::PARSED;
@@ -7,6 +7,7 @@
 
 #include <villas/hook.hpp>
 #include <villas/hook_list.hpp>
+#include <villas/hooks/fused.hpp>
 #include <villas/list.hpp>
 #include <villas/plugin.hpp>
 #include <villas/sample.hpp>
@@ -102,39 +103,130 @@ skip_add:
     if (logger->level() <= spdlog::level::debug)
       sigs->dump(logger);
   }
+
+  this->signals = signals;
+
+  compile();
+}
+
+void HookList::compile() {
+  FusedHook::Ptr fh;
+
+  plan.clear();
+
+  // Runs of a single hook are not worth fusing
+  auto flush = [&]() {
+    if (!fh)
+      return;
+
+    if (fh->getHooks().size() > 1) {
+      fh->compile();
+      plan.push_back(fh);
+    } else
+      plan.insert(plan.end(), fh->getHooks().begin(), fh->getHooks().end());
+
+    fh.reset();
+  };
+
+  auto sigs = signals;
+  for (auto h : *this) {
+    if (sigs && h->isFusable()) {
+      if (!fh)
+        fh = std::make_shared<FusedHook>(nullptr, nullptr, sigs);
+
+      if (fh->add(h)) {
+        sigs = h->getSignals();
+        continue;
+      }
+    }
+
+    // Hooks which can not be fused act as a barrier
+    flush();
+    plan.push_back(h);
+
+    sigs = h->getSignals();
+  }
+
+  flush();
+
+  planSize = size();
 }
 
 int HookList::process(struct Sample *smps[], unsigned cnt) {
-  unsigned current, processed = 0;
+  unsigned processed = 0, active = cnt;
 
-  if (size() == 0)
+  if (size() == 0 || cnt == 0)
     return cnt;
 
-  for (current = 0; current < cnt; current++) {
-    struct Sample *smp = smps[current];
+  // Hooks might have been added after prepare()
+  if (planSize != size())
+    compile();
+
+  // Samples which are passed to the next hook and their original position
+  struct Sample *smps_active[cnt];
+  unsigned positions[cnt];
+  bool skipped[cnt];
+
+  Hook::Reason reasons[cnt];
+
+  for (unsigned i = 0; i < cnt; i++) {
+    smps_active[i] = smps[i];
+    positions[i] = i;
+    skipped[i] = false;
+  }
+
+  for (auto h : plan) {
+    if (active == 0)
+      break;
 
-    for (auto h : *this) {
-      auto ret = h->process(smp);
-      smp->signals = h->getSignals();
-      switch (ret) {
+    int passed = h->processBatch(smps_active, active, reasons);
+    if (passed < 0)
+      return -1;
+
+    auto sigs = h->getSignals();
+
+    if ((unsigned)passed == active) {
+      for (unsigned i = 0; i < active; i++)
+        smps_active[i]->signals = sigs;
+
+      continue;
+    }
+
+    unsigned next = 0;
+    for (unsigned i = 0; i < active; i++) {
+      struct Sample *smp = smps_active[i];
+
+      smp->signals = sigs;
+
+      switch (reasons[i]) {
       case Hook::Reason::ERROR:
         return -1;
 
       case Hook::Reason::OK:
-        continue;
+        smps_active[next] = smp;
+        positions[next] = positions[i];
+        next++;
+        break;
 
       case Hook::Reason::SKIP_SAMPLE:
-        goto skip;
+        skipped[positions[i]] = true;
+        break;
 
       case Hook::Reason::STOP_PROCESSING:
-        goto stop;
+        break;
       }
     }
 
-  stop:
+    active = next;
+  }
+
+  // Move samples which have not been skipped to the front
+  for (unsigned current = 0; current < cnt; current++) {
+    if (skipped[current])
+      continue;
+
     SWAP(smps[processed], smps[current]);
     processed++;
-  skip: {}
   }
 
   return processed;
@@ -191,4 +283,42 @@ void HookList::dump(Logger logger, std::string subject) const {
   unsigned i = 0;
   for (auto h : *this)
     logger->debug("      {}: {}", i++, h->getFactory()->getName());
+
+  logger->debug("Execution plan of {}:", subject);
+
+  i = 0;
+  for (auto h : plan) {
+    auto fh = std::dynamic_pointer_cast<FusedHook>(h);
+    if (!fh) {
+      auto hf = h->getFactory();
+
+      logger->debug("      {}: {}", i++, hf ? hf->getName() : "internal");
+      continue;
+    }
+
+    logger->debug("      {}: {}", i++, fh->toString());
+
+    for (auto &k : fh->getKernels())
+      logger->debug("         {}", k.toString());
+  }
+}
+
+json_t *HookList::planToJson() const {
+  json_t *json_plan = json_array();
+
+  for (auto h : plan) {
+    auto fh = std::dynamic_pointer_cast<FusedHook>(h);
+    if (fh) {
+      json_array_append_new(json_plan, fh->toJson());
+      continue;
+    }
+
+    auto hf = h->getFactory();
+
+    json_array_append_new(
+        json_plan, json_pack("{ s: s }", "type",
+                             hf ? hf->getName().c_str() : "internal"));
+  }
+
+  return json_plan;
 }
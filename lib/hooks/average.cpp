@@ -53,38 +53,65 @@ public:
   }
 
   virtual Hook::Reason process(struct Sample *smp) {
-    double avg, sum = 0;
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
+    double sums[cnt];
     int n = 0;
 
     assert(state == State::STARTED);
 
+    if (cnt == 0)
+      return 0;
+
+    for (unsigned i = 0; i < cnt; i++)
+      sums[i] = 0;
+
+    // All samples of a vector share the same signal list
     for (unsigned index : signalIndices) {
-      switch (sample_format(smp, index)) {
+      switch (sample_format(smps[0], index)) {
       case SignalType::INTEGER:
-        sum += smp->data[index].i;
+        for (unsigned i = 0; i < cnt; i++)
+          sums[i] += smps[i]->data[index].i;
         break;
 
       case SignalType::FLOAT:
-        sum += smp->data[index].f;
+        for (unsigned i = 0; i < cnt; i++)
+          sums[i] += smps[i]->data[index].f;
         break;
 
       case SignalType::INVALID:
       case SignalType::COMPLEX:
       case SignalType::BOOLEAN:
-        return Hook::Reason::ERROR; // not supported
+        for (unsigned i = 0; i < cnt; i++)
+          reasons[i] = Reason::ERROR; // not supported
+
+        return -1;
       }
 
       n++;
     }
 
-    avg = sum / n;
+    for (unsigned i = 0; i < cnt; i++) {
+      double avg = sums[i] / n;
 
-    if (offset >= smp->length)
-      return Reason::ERROR;
+      if (offset >= smps[i]->length) {
+        reasons[i] = Reason::ERROR;
+        return -1;
+      }
 
-    sample_data_insert(smp, (union SignalData *)&avg, offset, 1);
+      sample_data_insert(smps[i], (union SignalData *)&avg, offset, 1);
+
+      reasons[i] = Reason::OK;
+    }
 
-    return Reason::OK;
+    return cnt;
   }
 };
 
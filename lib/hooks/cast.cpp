@@ -6,6 +6,7 @@
  */
 
 #include <villas/hook.hpp>
+#include <villas/hooks/fused.hpp>
 #include <villas/sample.hpp>
 
 namespace villas {
@@ -75,17 +76,46 @@ public:
     state = State::PARSED;
   }
 
+  virtual bool fuseInto(FusedHook &fh) const {
+    for (auto index : signalIndices) {
+      if (!fh.addCast(index, signals->getByIndex(index)->type))
+        return false;
+    }
+
+    return true;
+  }
+
   virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
     assert(state == State::STARTED);
 
+    if (cnt == 0)
+      return 0;
+
+    // All samples of a vector share the same signal list
     for (auto index : signalIndices) {
-      auto orig_sig = smp->signals->getByIndex(index);
-      auto new_sig = signals->getByIndex(index);
+      auto orig_type = smps[0]->signals->getByIndex(index)->type;
+      auto new_type = signals->getByIndex(index)->type;
+
+      if (orig_type == new_type)
+        continue;
 
-      smp->data[index] = smp->data[index].cast(orig_sig->type, new_sig->type);
+      for (unsigned i = 0; i < cnt; i++)
+        smps[i]->data[index] = smps[i]->data[index].cast(orig_type, new_type);
     }
 
-    return Reason::OK;
+    for (unsigned i = 0; i < cnt; i++)
+      reasons[i] = Reason::OK;
+
+    return cnt;
   }
 };
 
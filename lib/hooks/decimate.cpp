@@ -47,6 +47,27 @@ Hook::Reason DecimateHook::process(struct Sample *smp) {
   return Reason::OK;
 }
 
+int DecimateHook::processBatch(struct Sample *smps[], unsigned cnt,
+                               Reason reasons[]) {
+  unsigned passed = 0;
+
+  assert(state == State::STARTED);
+
+  for (unsigned i = 0; i < cnt; i++) {
+    if (renumber)
+      smps[i]->sequence /= ratio;
+
+    if (ratio && counter++ % ratio != 0)
+      reasons[i] = Reason::SKIP_SAMPLE;
+    else {
+      reasons[i] = Reason::OK;
+      passed++;
+    }
+  }
+
+  return passed;
+}
+
 // Register hook
 static char n[] = "decimate";
 static char d[] = "Downsamping by integer factor";
@@ -0,0 +1,316 @@
+/* Fused elementwise hooks.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include <villas/hooks/fused.hpp>
+#include <villas/sample.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+std::string FusedHook::Operation::toString() const {
+  switch (type) {
+  case Type::SCALE:
+    return fmt::format("scale({}, {})", a, b);
+
+  case Type::ROUND:
+    return fmt::format("round({})", a);
+
+  case Type::LIMIT:
+    return fmt::format("limit({}, {})", a, b);
+
+  case Type::CAST:
+    return fmt::format("cast({}, {})", signalTypeToString(from),
+                       signalTypeToString(to));
+  }
+
+  return "unknown";
+}
+
+std::string FusedHook::Kernel::toString() const {
+  std::string str = "signals";
+
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+    str += fmt::format("{}{}", it == indices.begin() ? " " : ", ", *it);
+
+  for (auto it = operations.begin(); it != operations.end(); ++it)
+    str += (it == operations.begin() ? ": " : " -> ") + it->toString();
+
+  return str;
+}
+
+json_t *FusedHook::Kernel::toJson() const {
+  json_t *json_indices = json_array();
+  json_t *json_operations = json_array();
+
+  for (auto index : indices)
+    json_array_append_new(json_indices, json_integer(index));
+
+  for (auto &op : operations)
+    json_array_append_new(json_operations, json_string(op.toString().c_str()));
+
+  return json_pack("{ s: o, s: o }", "signals", json_indices, "operations",
+                   json_operations);
+}
+
+FusedHook::FusedHook(Path *p, Node *n, SignalList::Ptr sigs)
+    : Hook(p, n, 0, 0) {
+  for (auto sig : *sigs)
+    types.push_back(sig->type);
+
+  // A fused hook has no configuration and follows the state of its hooks
+  state = State::STARTED;
+}
+
+bool FusedHook::add(Hook::Ptr h) {
+  if (!h->isFusable())
+    return false;
+
+  // Elementwise hooks must not add or remove signals
+  if (h->getSignals()->size() != types.size())
+    return false;
+
+  auto oldTypes = types;
+  auto oldChains = chains;
+
+  if (!h->fuseInto(*this)) {
+    types = oldTypes;
+    chains = oldChains;
+
+    return false;
+  }
+
+  hooks.push_back(h);
+
+  return true;
+}
+
+bool FusedHook::addOperation(unsigned index, Operation::Type type, double a,
+                             double b) {
+  if (index >= types.size())
+    return false;
+
+  auto t = types[index];
+
+  switch (type) {
+  case Operation::Type::SCALE:
+    if (t != SignalType::INTEGER && t != SignalType::FLOAT &&
+        t != SignalType::COMPLEX)
+      return true;
+    break;
+
+  case Operation::Type::ROUND:
+    if (t != SignalType::FLOAT && t != SignalType::COMPLEX)
+      return true;
+    break;
+
+  case Operation::Type::LIMIT:
+    if (t != SignalType::INTEGER && t != SignalType::FLOAT)
+      return false;
+    break;
+
+  case Operation::Type::CAST:
+    return false;
+  }
+
+  chains[index].push_back({type, t, t, a, b});
+
+  return true;
+}
+
+bool FusedHook::addCast(unsigned index, enum SignalType to) {
+  if (index >= types.size())
+    return false;
+
+  auto from = types[index];
+  if (from != to)
+    chains[index].push_back({Operation::Type::CAST, from, to, 0, 0});
+
+  types[index] = to;
+
+  return true;
+}
+
+void FusedHook::compile() {
+  kernels.clear();
+
+  for (auto &c : chains) {
+    if (c.second.empty())
+      continue;
+
+    auto it =
+        std::find_if(kernels.begin(), kernels.end(), [&](const Kernel &k) {
+          return k.operations == c.second;
+        });
+
+    if (it != kernels.end())
+      it->indices.push_back(c.first);
+    else
+      kernels.push_back({{c.first}, c.second});
+  }
+}
+
+void FusedHook::apply(const Operation &op, union SignalData values[],
+                      unsigned cnt) {
+  switch (op.type) {
+  case Operation::Type::SCALE:
+    switch (op.from) {
+    case SignalType::INTEGER:
+      for (unsigned i = 0; i < cnt; i++) {
+        values[i].i *= op.a;
+        values[i].i += op.b;
+      }
+      break;
+
+    case SignalType::FLOAT:
+      for (unsigned i = 0; i < cnt; i++) {
+        values[i].f *= op.a;
+        values[i].f += op.b;
+      }
+      break;
+
+    case SignalType::COMPLEX:
+      for (unsigned i = 0; i < cnt; i++) {
+        values[i].z *= op.a;
+        values[i].z += op.b;
+      }
+      break;
+
+    default: {
+    }
+    }
+    break;
+
+  case Operation::Type::ROUND:
+    switch (op.from) {
+    case SignalType::FLOAT:
+      for (unsigned i = 0; i < cnt; i++)
+        values[i].f = round(values[i].f * op.a) / op.a;
+      break;
+
+    case SignalType::COMPLEX:
+      for (unsigned i = 0; i < cnt; i++) {
+        auto z = values[i].z;
+
+        values[i].z = std::complex<float>(round(z.real() * op.a) / op.a,
+                                          round(z.imag() * op.a) / op.a);
+      }
+      break;
+
+    default: {
+    }
+    }
+    break;
+
+  case Operation::Type::LIMIT: {
+    // Same precision as the limit_value hook
+    float min = op.a, max = op.b;
+
+    switch (op.from) {
+    case SignalType::INTEGER:
+      for (unsigned i = 0; i < cnt; i++) {
+        if (values[i].i > max)
+          values[i].i = max;
+
+        if (values[i].i < min)
+          values[i].i = min;
+      }
+      break;
+
+    case SignalType::FLOAT:
+      for (unsigned i = 0; i < cnt; i++) {
+        if (values[i].f > max)
+          values[i].f = max;
+
+        if (values[i].f < min)
+          values[i].f = min;
+      }
+      break;
+
+    default: {
+    }
+    }
+    break;
+  }
+
+  case Operation::Type::CAST:
+    for (unsigned i = 0; i < cnt; i++)
+      values[i] = values[i].cast(op.from, op.to);
+    break;
+  }
+}
+
+Hook::Reason FusedHook::process(struct Sample *smp) {
+  Reason reason;
+
+  processBatch(&smp, 1, &reason);
+
+  return reason;
+}
+
+int FusedHook::processBatch(struct Sample *smps[], unsigned cnt,
+                            Reason reasons[]) {
+  union SignalData values[cnt];
+
+  for (auto &k : kernels) {
+    for (auto index : k.indices) {
+      for (unsigned i = 0; i < cnt; i++) {
+        assert(index < smps[i]->length);
+
+        values[i] = smps[i]->data[index];
+      }
+
+      for (auto &op : k.operations)
+        apply(op, values, cnt);
+
+      for (unsigned i = 0; i < cnt; i++)
+        smps[i]->data[index] = values[i];
+    }
+  }
+
+  for (unsigned i = 0; i < cnt; i++)
+    reasons[i] = Reason::OK;
+
+  return cnt;
+}
+
+std::string FusedHook::toString() const {
+  std::string str = "fused(";
+
+  for (auto it = hooks.begin(); it != hooks.end(); ++it) {
+    auto hf = (*it)->getFactory();
+
+    if (it != hooks.begin())
+      str += " -> ";
+
+    str += hf ? hf->getName() : "internal";
+  }
+
+  return str + ")";
+}
+
+json_t *FusedHook::toJson() const {
+  json_t *json_hooks = json_array();
+  json_t *json_kernels = json_array();
+
+  for (auto h : hooks) {
+    auto hf = h->getFactory();
+
+    json_array_append_new(json_hooks,
+                          json_string(hf ? hf->getName().c_str() : "internal"));
+  }
+
+  for (auto &k : kernels)
+    json_array_append_new(json_kernels, k.toJson());
+
+  return json_pack("{ s: s, s: o, s: o }", "type", "fused", "hooks",
+                   json_hooks, "kernels", json_kernels);
+}
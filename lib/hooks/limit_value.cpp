@@ -6,6 +6,7 @@
  */
 
 #include <villas/hook.hpp>
+#include <villas/hooks/fused.hpp>
 #include <villas/node/exceptions.hpp>
 #include <villas/sample.hpp>
 #include <villas/signal.hpp>
@@ -40,35 +41,67 @@ public:
     state = State::PARSED;
   }
 
+  virtual bool fuseInto(FusedHook &fh) const {
+    for (auto index : signalIndices) {
+      if (!fh.addOperation(index, FusedHook::Operation::Type::LIMIT, min, max))
+        return false;
+    }
+
+    return true;
+  }
+
   virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
     assert(state == State::STARTED);
 
+    if (cnt == 0)
+      return 0;
+
+    // All samples of a vector share the same signal list
     for (auto index : signalIndices) {
-      switch (sample_format(smp, index)) {
+      switch (sample_format(smps[0], index)) {
       case SignalType::INTEGER:
-        if (smp->data[index].i > max)
-          smp->data[index].i = max;
+        for (unsigned i = 0; i < cnt; i++) {
+          if (smps[i]->data[index].i > max)
+            smps[i]->data[index].i = max;
 
-        if (smp->data[index].i < min)
-          smp->data[index].i = min;
+          if (smps[i]->data[index].i < min)
+            smps[i]->data[index].i = min;
+        }
         break;
 
       case SignalType::FLOAT:
-        if (smp->data[index].f > max)
-          smp->data[index].f = max;
+        for (unsigned i = 0; i < cnt; i++) {
+          if (smps[i]->data[index].f > max)
+            smps[i]->data[index].f = max;
 
-        if (smp->data[index].f < min)
-          smp->data[index].f = min;
+          if (smps[i]->data[index].f < min)
+            smps[i]->data[index].f = min;
+        }
         break;
 
       case SignalType::INVALID:
       case SignalType::COMPLEX:
       case SignalType::BOOLEAN:
-        return Hook::Reason::ERROR; // not supported
+        for (unsigned i = 0; i < cnt; i++)
+          reasons[i] = Reason::ERROR; // not supported
+
+        return -1;
       }
     }
 
-    return Reason::OK;
+    for (unsigned i = 0; i < cnt; i++)
+      reasons[i] = Reason::OK;
+
+    return cnt;
   }
 };
 
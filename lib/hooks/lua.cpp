@@ -6,6 +6,7 @@
  */
 
 #include <cstdio>
+#include <cstring>
 #include <map>
 #include <vector>
 
@@ -373,7 +374,22 @@ LuaSignalExpression::LuaSignalExpression(lua_State *l, json_t *json_sig)
   expression = expr;
 }
 
-void LuaSignalExpression::prepare() { parseExpression(expression); }
+void LuaSignalExpression::prepare(SignalList::Ptr signals, bool useNames,
+                                  bool allowNative) {
+  native.reset();
+
+  if (allowNative) {
+    try {
+      native = std::make_unique<Expression>(expression, signals, useNames);
+
+      return;
+    } catch (const RuntimeError &) {
+      // Not supported by the native engine. Use Lua instead
+    }
+  }
+
+  parseExpression(expression);
+}
 
 void LuaSignalExpression::parseExpression(const std::string &expr) {
   // Release previous expression
@@ -391,9 +407,18 @@ void LuaSignalExpression::parseExpression(const std::string &expr) {
 }
 
 void LuaSignalExpression::evaluate(union SignalData *data,
-                                   enum SignalType type) {
+                                   enum SignalType type,
+                                   const struct Sample *smp) {
   int err;
 
+  // Same conversion as for a Lua number
+  if (native) {
+    data->f = native->evaluate(smp);
+    *data = data->cast(SignalType::FLOAT, type);
+
+    return;
+  }
+
   lua_rawgeti(L, LUA_REGISTRYINDEX, cookie);
 
   err = lua_pcall(L, 0, 1, 0);
@@ -410,8 +435,9 @@ void LuaSignalExpression::evaluate(union SignalData *data,
 LuaHook::LuaHook(Path *p, Node *n, int fl, int prio, bool en)
     : Hook(p, n, fl, prio, en),
       signalsExpressions(std::make_shared<SignalList>()), L(luaL_newstate()),
-      useNames(true), hasExpressions(false), needsLocking(false),
-      functions({0}) {}
+      binding(LuaBinding::TABLE), useNames(true), hasExpressions(false),
+      hasLuaExpressions(false), useNative(true), needsLocking(false),
+      functions({0}), ffi({0}) {}
 
 LuaHook::~LuaHook() { lua_close(L); }
 
@@ -436,7 +462,9 @@ void LuaHook::parseExpressions(json_t *json_sigs) {
 void LuaHook::parse(json_t *json) {
   int ret;
   const char *script_str = nullptr;
+  const char *binding_str = nullptr;
   int names = 1;
+  int native = 1;
   json_error_t err;
   json_t *json_signals = nullptr;
 
@@ -444,13 +472,30 @@ void LuaHook::parse(json_t *json) {
 
   Hook::parse(json);
 
-  ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: o, s?: b }", "script",
-                       &script_str, "signals", &json_signals, "use_names",
-                       &names);
+  ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: o, s?: b, s?: s, s?: b }",
+                       "script", &script_str, "signals", &json_signals,
+                       "use_names", &names, "binding", &binding_str, "native",
+                       &native);
   if (ret)
     throw ConfigError(json, err, "node-config-hook-lua");
 
   useNames = names;
+  useNative = native;
+
+  if (binding_str) {
+    if (!strcmp(binding_str, "table"))
+      binding = LuaBinding::TABLE;
+    else if (!strcmp(binding_str, "ffi")) {
+#ifdef LUAJIT_FOUND
+      binding = LuaBinding::FFI;
+#else
+      throw ConfigError(json, "node-config-hook-lua-binding",
+                        "The FFI binding requires LuaJIT");
+#endif // LUAJIT_FOUND
+    } else
+      throw ConfigError(json, "node-config-hook-lua-binding",
+                        "Invalid binding: {}", binding_str);
+  }
 
   if (script_str)
     script = script_str;
@@ -467,7 +512,8 @@ void LuaHook::lookupFunctions() {
   std::map<const char *, int *> funcs = {
       {"start", &functions.start},       {"stop", &functions.stop},
       {"restart", &functions.restart},   {"prepare", &functions.prepare},
-      {"periodic", &functions.periodic}, {"process", &functions.process}};
+      {"periodic", &functions.periodic}, {"process", &functions.process},
+      {"process_batch", &functions.processBatch}};
 
   for (auto it : funcs) {
     lua_getglobal(L, it.first);
@@ -536,6 +582,160 @@ void LuaHook::setupEnvironment() {
                &dispatch<&LuaHook::luaRegisterApiHandler>);
 }
 
+void LuaHook::setupFFI() {
+#ifdef LUAJIT_FOUND
+  static_assert(sizeof(struct timespec) == 2 * sizeof(long),
+                "Unsupported layout of struct timespec");
+
+  // Mirror the layout of struct Sample. Internal members are padding.
+  size_t offTs = offsetof(struct Sample, ts);
+  size_t offData = offsetof(struct Sample, data);
+  size_t endFlags = offsetof(struct Sample, flags) + sizeof(int);
+  size_t endTs = offTs + 2 * sizeof(struct timespec);
+
+  auto chunk = fmt::format(R"(
+local ffi = require("ffi")
+
+ffi.cdef[[
+typedef union {{
+  double f;
+  int64_t i;
+  bool b;
+  float z[2];
+}} villas_signal_data;
+
+typedef struct {{
+  long sec;
+  long nsec;
+}} villas_timespec;
+
+typedef struct {{
+  uint64_t sequence;
+  unsigned length;
+  unsigned capacity;
+  int flags;
+  uint8_t _internal0[{}];
+  villas_timespec ts_origin;
+  villas_timespec ts_received;
+  uint8_t _internal1[{}];
+  villas_signal_data data[0];
+}} villas_sample;
+]]
+
+local sample_ptr = ffi.typeof("villas_sample *")
+local sample_ptr_ptr = ffi.typeof("villas_sample **")
+local reason_ptr = ffi.typeof("int32_t *")
+
+local keys, fields = ...
+
+local process = process
+local process_batch = process_batch
+
+local function process_batch_wrapper(smps, cnt, reasons)
+  smps = ffi.cast(sample_ptr_ptr, smps)
+  reasons = ffi.cast(reason_ptr, reasons)
+
+  if process_batch then
+    process_batch(smps, cnt, reasons)
+  elseif process then
+    for i = 0, cnt - 1 do
+      reasons[i] = process(smps[i]) or 0
+    end
+  end
+end
+
+-- Expressions see the same sample as with the table binding
+local current
+
+local data = setmetatable({{}}, {{
+  __index = function(_, k)
+    local i = keys[k]
+    if not i or i >= current.length or not fields[i] then
+      return nil
+    end
+
+    local v = current.data[i][fields[i]]
+    return fields[i] == "i" and tonumber(v) or v
+  end
+}})
+
+local view = setmetatable({{}}, {{
+  __index = function(_, k)
+    if k == "data" then
+      return data
+    elseif k == "flags" then
+      return current.flags
+    elseif k == "sequence" then
+      return tonumber(current.sequence)
+    elseif k == "ts_origin" or k == "ts_received" then
+      local ts = current[k]
+      return {{ [0] = tonumber(ts.sec), [1] = tonumber(ts.nsec) }}
+    end
+  end
+}})
+
+local function set_sample(p)
+  current = ffi.cast(sample_ptr, p)
+  smp = view
+end
+
+return process_batch_wrapper, set_sample
+)",
+                           offTs - endFlags, offData - endTs);
+
+  int ret = luaL_loadstring(L, chunk.c_str());
+  if (ret)
+    throw LuaError(L, ret);
+
+  // Resolve signal names to indices only once
+  lua_createtable(L, 0, signals->size());
+
+  unsigned i = 0;
+  for (auto sig : *signals) {
+    lua_pushinteger(L, i++);
+    lua_setfield(L, -2, sig->name.c_str());
+  }
+
+  lua_pushvalue(L, -1);
+  lua_setglobal(L, "signals");
+
+  // Expressions refer to signals by name or by index, depending on use_names
+  if (!useNames) {
+    lua_pop(L, 1);
+    lua_createtable(L, signals->size(), 0);
+
+    for (i = 0; i < signals->size(); i++) {
+      lua_pushinteger(L, i);
+      lua_rawseti(L, -2, i);
+    }
+  }
+
+  // The union member which holds the value of each signal
+  lua_createtable(L, signals->size(), 0);
+
+  i = 0;
+  for (auto sig : *signals) {
+    const char *field = sig->type == SignalType::FLOAT     ? "f"
+                        : sig->type == SignalType::INTEGER ? "i"
+                        : sig->type == SignalType::BOOLEAN ? "b"
+                                                           : nullptr;
+    if (field) {
+      lua_pushstring(L, field);
+      lua_rawseti(L, -2, i);
+    }
+
+    i++;
+  }
+
+  ret = lua_pcall(L, 2, 2, 0);
+  if (ret)
+    throw LuaError(L, ret);
+
+  ffi.setSample = luaL_ref(L, LUA_REGISTRYINDEX);
+  ffi.processBatch = luaL_ref(L, LUA_REGISTRYINDEX);
+#endif // LUAJIT_FOUND
+}
+
 void LuaHook::prepare() {
   // Load Lua standard libraries
   luaL_openlibs(L);
@@ -547,14 +747,23 @@ void LuaHook::prepare() {
   loadScript();
   lookupFunctions();
 
+  if (binding == LuaBinding::FFI)
+    setupFFI();
+  else if (functions.processBatch)
+    logger->warn("The Lua function process_batch() requires the FFI binding. "
+                 "It will not be called!");
+
   /* Check if we need to protect the Lua state with a mutex
    * This is the case if we have a periodic callback defined
    * As periodic() gets called from the main thread
    */
   needsLocking = functions.periodic > 0;
 
+  bool hasProcess = functions.process ||
+                    (binding == LuaBinding::FFI && functions.processBatch);
+
   // Prepare Lua process()
-  if (functions.process) {
+  if (hasProcess) {
     /* We currently do not support the alteration of
      * signal metadata in process() */
     signalsProcessed = signals;
@@ -562,13 +771,21 @@ void LuaHook::prepare() {
 
   // Prepare Lua expressions
   if (hasExpressions) {
-    for (auto &expr : expressions)
-      expr.prepare();
+    hasLuaExpressions = false;
+    for (auto &expr : expressions) {
+      expr.prepare(signals, useNames, useNative);
+
+      if (expr.isNative())
+        logger->debug("Compiled expression natively: {}",
+                      expr.getNative()->toString());
+      else
+        hasLuaExpressions = true;
+    }
 
     signals = signalsExpressions;
   }
 
-  if (!functions.process && !hasExpressions)
+  if (!hasProcess && !hasExpressions)
     logger->warn(
         "The hook has neither a script or expressions defined. It is a no-op!");
 
@@ -650,7 +867,47 @@ void LuaHook::periodic() {
   }
 }
 
+void LuaHook::evaluateExpressions(struct Sample *smp) {
+  union SignalData values[expressions.size()];
+
+  if (hasLuaExpressions && binding == LuaBinding::FFI) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ffi.setSample);
+    lua_pushlightuserdata(L, smp);
+    int ret = lua_pcall(L, 1, 0, 0);
+    if (ret)
+      throw LuaError(L, ret);
+  } else if (hasLuaExpressions) {
+    lua_pushsample(L, smp, useNames);
+    lua_setglobal(L, "smp");
+  }
+
+  /* Expressions might refer to any signal of the original sample.
+   * So the results are only written back after all have been evaluated. */
+  for (unsigned i = 0; i < expressions.size(); i++) {
+    values[i] = smp->data[i];
+
+    auto sig = signalsExpressions->getByIndex(i);
+    if (!sig)
+      continue;
+
+    expressions[i].evaluate(&values[i], sig->type, smp);
+  }
+
+  for (unsigned i = 0; i < expressions.size(); i++)
+    smp->data[i] = values[i];
+
+  smp->length = expressions.size();
+}
+
 Hook::Reason LuaHook::process(struct Sample *smp) {
+  if (binding == LuaBinding::FFI) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
   if (!functions.process && !hasExpressions)
     return Reason::OK;
 
@@ -687,22 +944,60 @@ Hook::Reason LuaHook::process(struct Sample *smp) {
     reason = Reason::OK;
 
   // After that evaluate expressions
-  if (hasExpressions) {
-    lua_pushsample(L, smp, useNames);
-    lua_setglobal(L, "smp");
+  if (hasExpressions)
+    evaluateExpressions(smp);
 
-    for (unsigned i = 0; i < expressions.size(); i++) {
-      auto sig = signalsExpressions->getByIndex(i);
-      if (!sig)
-        continue;
+  return reason;
+}
 
-      expressions[i].evaluate(&smp->data[i], sig->type);
-    }
+int LuaHook::processBatch(struct Sample *smps[], unsigned cnt,
+                          Reason reasons[]) {
+  if (binding != LuaBinding::FFI)
+    return Hook::processBatch(smps, cnt, reasons);
+
+  unsigned passed = 0;
+  int32_t results[cnt];
+  auto lockScope = needsLocking ? std::unique_lock<std::mutex>(mutex)
+                                : std::unique_lock<std::mutex>();
+
+  for (unsigned i = 0; i < cnt; i++)
+    results[i] = (int32_t)Reason::OK;
+
+  // The script accesses the samples in place
+  if (functions.process || functions.processBatch) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ffi.processBatch);
+    lua_pushlightuserdata(L, smps);
+    lua_pushinteger(L, cnt);
+    lua_pushlightuserdata(L, results);
+    int ret = lua_pcall(L, 3, 0, 0);
+    if (ret)
+      throw LuaError(L, ret);
+  }
+
+  for (unsigned i = 0; i < cnt; i++) {
+    reasons[i] = (Reason)results[i];
+
+    if (smps[i]->length > smps[i]->capacity)
+      throw RuntimeError("Lua: Sample length {} exceeds its capacity {}",
+                         smps[i]->length, smps[i]->capacity);
+
+    if (hasExpressions)
+      evaluateExpressions(smps[i]);
+
+    switch (reasons[i]) {
+    case Reason::ERROR:
+      return -1;
 
-    smp->length = expressions.size();
+    case Reason::OK:
+      passed++;
+      break;
+
+    default: {
+    }
+    }
   }
 
-  return reason;
+  return passed;
 }
 
 // Register hook
@@ -63,30 +63,49 @@ public:
   }
 
   virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
     assert(state == State::STARTED);
 
-    unsigned i = 0;
-    for (auto index : signalIndices) {
-      // The new value
-      double newValue = smp->data[index].f;
+    // All signals share one accumulator, so samples are processed in order
+    for (unsigned j = 0; j < cnt; j++) {
+      auto *smp = smps[j];
 
-      // Append the new value to the history memory
-      smpMemory[i][smpMemoryPosition % windowSize] = newValue;
+      unsigned newPosition = smpMemoryPosition % windowSize;
+      unsigned oldPosition = (smpMemoryPosition + 1) % windowSize;
 
-      // Get the old value from the history
-      double oldValue = smpMemory[i][(smpMemoryPosition + 1) % windowSize];
+      unsigned i = 0;
+      for (auto index : signalIndices) {
+        // The new value
+        double newValue = smp->data[index].f;
 
-      // Update the accumulator
-      accumulator += newValue;
-      accumulator -= oldValue;
+        // Append the new value to the history memory
+        smpMemory[i][newPosition] = newValue;
 
-      smp->data[index].f = accumulator / windowSize;
-      i++;
-    }
+        // Get the old value from the history
+        double oldValue = smpMemory[i][oldPosition];
+
+        // Update the accumulator
+        accumulator += newValue;
+        accumulator -= oldValue;
+
+        smp->data[index].f = accumulator / windowSize;
+        i++;
+      }
 
-    smpMemoryPosition++;
+      smpMemoryPosition++;
+
+      reasons[j] = Reason::OK;
+    }
 
-    return Reason::OK;
+    return cnt;
   }
 };
 
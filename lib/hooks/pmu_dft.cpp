@@ -7,6 +7,7 @@
 
 #include <complex>
 #include <cstring>
+#include <map>
 #include <vector>
 #include <villas/timing.hpp>
 
@@ -29,6 +30,11 @@ protected:
 
   enum class EstimationType { NONE, QUADRATIC, IpDFT };
 
+  enum class DftEngine {
+    MATRIX, // Multiply the window with a precomputed matrix for each estimate
+    SLIDING // Update the DFT bins recursively with each sample
+  };
+
   enum class TimeAlign {
     LEFT,
     CENTER,
@@ -53,10 +59,24 @@ protected:
     double rocof; // Rate of change of frequency.
   };
 
+  // A DFT bin which is updated by the sliding DFT
+  struct SlidingBin {
+    int bin;                     // May lie outside of the frequency range
+    std::complex<double> rotate; // Shifts the window by one sample
+    std::complex<double> last;   // Weight of the newest sample
+  };
+
+  // Contribution of a sliding bin to a windowed frequency bin
+  struct SlidingTerm {
+    unsigned index; // Index in slidingBins
+    double weight;
+  };
+
   enum WindowType windowType;
   enum PaddingType paddingType;
   enum EstimationType estType;
   enum TimeAlign timeAlignType;
+  enum DftEngine engine;
 
   std::vector<std::vector<double>> smpMemoryData;
   std::vector<timespec> smpMemoryTs;
@@ -66,9 +86,26 @@ protected:
   std::vector<std::vector<std::complex<double>>> matrix;
   std::vector<std::vector<std::complex<double>>> results;
   std::vector<double> filterWindowCoefficents;
+  std::vector<double>
+      windowCosines; // Window as sum of cosines with periods windowSize / k
   std::vector<std::vector<double>> absResults;
   std::vector<double> absFrequencies;
 
+  /* State of the sliding DFT
+   *
+   * The windowed DFT is a linear combination of unwindowed bins, as all
+   * supported windows are sums of cosines. Those bins are updated with each
+   * sample and recalculated every resyncInterval samples to avoid drift.
+   */
+  std::vector<std::complex<double>> twiddles; // exp(-2 pi i k / N)
+  std::vector<SlidingBin> slidingBins;
+  std::vector<std::vector<SlidingTerm>> slidingTerms; // Per frequency bin
+  std::vector<std::vector<std::complex<double>>>
+      slidingSums; // Per signal and sliding bin
+  unsigned resyncWindows;
+  uint64_t resyncInterval;
+  uint64_t resyncCount;
+
   uint64_t calcCount;
   unsigned sampleRate;
   double startFrequency;
@@ -116,12 +153,15 @@ public:
   PmuDftHook(Path *p, Node *n, int fl, int prio, bool en = true)
       : MultiSignalHook(p, n, fl, prio, en), windowType(WindowType::NONE),
         paddingType(PaddingType::ZERO), estType(EstimationType::NONE),
-        timeAlignType(TimeAlign::CENTER), smpMemoryData(), smpMemoryTs(),
+        timeAlignType(TimeAlign::CENTER), engine(DftEngine::MATRIX),
+        smpMemoryData(), smpMemoryTs(),
 #ifdef DFT_MEM_DUMP
         ppsMemory(),
 #endif
-        matrix(), results(), filterWindowCoefficents(), absResults(),
-        absFrequencies(), calcCount(0), sampleRate(0), startFrequency(0),
+        matrix(), results(), filterWindowCoefficents(), windowCosines(),
+        absResults(), absFrequencies(), twiddles(), slidingBins(),
+        slidingTerms(), slidingSums(), resyncWindows(100), resyncInterval(0),
+        resyncCount(0), calcCount(0), sampleRate(0), startFrequency(0),
         endFreqency(0), frequencyResolution(0), rate(0), ppsIndex(0),
         windowSize(0), windowMultiplier(0), freqCount(0), channelNameEnable(1),
         smpMemPos(0), lastSequence(0), windowCorrectionFactor(0),
@@ -211,8 +251,10 @@ public:
 
     // Initialize matrix of dft coeffients
     matrix.clear();
-    for (unsigned i = 0; i < freqCount; i++)
-      matrix.emplace_back(windowSize * windowMultiplier, 0.0);
+    if (engine == DftEngine::MATRIX) {
+      for (unsigned i = 0; i < freqCount; i++)
+        matrix.emplace_back(windowSize * windowMultiplier, 0.0);
+    }
 
     // Initalize dft results matrix
     results.clear();
@@ -226,9 +268,13 @@ public:
     for (unsigned i = 0; i < freqCount; i++)
       absFrequencies.emplace_back(startFrequency + i * frequencyResolution);
 
-    generateDftMatrix();
     calculateWindow(windowType);
 
+    if (engine == DftEngine::MATRIX)
+      generateDftMatrix();
+    else
+      prepareSlidingDft();
+
     state = State::PREPARED;
   }
 
@@ -242,6 +288,7 @@ public:
     const char *estimateTypeC = nullptr;
     const char *angleUnitC = nullptr;
     const char *timeAlignC = nullptr;
+    const char *engineC = nullptr;
 
     json_error_t err;
 
@@ -252,7 +299,7 @@ public:
     ret = json_unpack_ex(
         json, &err, 0,
         "{ s?: i, s?: F, s?: F, s?: F, s?: i, s?: i, s?: s, s?: s, s?: s, s?: "
-        "i, s?: s, s?: b, s?: s, s?: F, s?: F, s?: F, s?: F}",
+        "i, s?: s, s?: b, s?: s, s?: F, s?: F, s?: F, s?: F, s?: s, s?: i }",
         "sample_rate", &sampleRate, "start_freqency", &startFrequency,
         "end_freqency", &endFreqency, "frequency_resolution",
         &frequencyResolution, "dft_rate", &rate, "window_size_factor",
@@ -261,7 +308,8 @@ public:
         "angle_unit", &angleUnitC, "add_channel_name", &channelNameEnable,
         "timestamp_align", &timeAlignC, "phase_offset", &phaseOffset,
         "amplitude_offset", &amplitudeOffset, "frequency_offset",
-        &frequencyOffset, "rocof_offset", &rocofOffset);
+        &frequencyOffset, "rocof_offset", &rocofOffset, "dft_engine", &engineC,
+        "dft_resync", &resyncWindows);
     if (ret)
       throw ConfigError(json, err, "node-config-hook-dft");
 
@@ -321,6 +369,20 @@ public:
       estType = EstimationType::QUADRATIC;
     else if (strcmp(estimateTypeC, "ipdft") == 0)
       estType = EstimationType::IpDFT;
+
+    if (!engineC || strcmp(engineC, "matrix") == 0)
+      engine = DftEngine::MATRIX;
+    else if (strcmp(engineC, "sliding") == 0)
+      engine = DftEngine::SLIDING;
+    else
+      throw ConfigError(json, "node-config-hook-dft-engine",
+                        "DFT engine {} not recognized", engineC);
+
+    if (resyncWindows < 1)
+      throw ConfigError(json, "node-config-hook-dft-resync",
+                        "DFT resynchronization interval must be at least one "
+                        "window");
+
     state = State::PARSED;
   }
 
@@ -343,6 +405,10 @@ public:
   virtual Hook::Reason process(struct Sample *smp) {
     assert(state == State::STARTED);
 
+    // The sliding DFT needs the oldest sample before it is overwritten
+    if (engine == DftEngine::SLIDING)
+      updateSlidingDft();
+
     // Update sample memory
     unsigned i = 0;
     for (auto index : signalIndices) {
@@ -381,8 +447,11 @@ public:
       for (unsigned i = 0; i < signalIndices.size(); i++) {
         Phasor currentResult = {0, 0, 0, 0};
 
-        calculateDft(PaddingType::ZERO, smpMemoryData[i], results[i],
-                     smpMemPos);
+        if (engine == DftEngine::SLIDING)
+          calculateSlidingDft(i, results[i]);
+        else
+          calculateDft(PaddingType::ZERO, smpMemoryData[i], results[i],
+                       smpMemPos);
 
         unsigned maxPos = 0;
         double absAmplitude = 0;
@@ -547,14 +616,8 @@ public:
   void calculateWindow(enum WindowType windowTypeIn) {
     switch (windowTypeIn) {
     case WindowType::FLATTOP:
-      for (unsigned i = 0; i < windowSize; i++) {
-        filterWindowCoefficents[i] =
-            0.21557895 - 0.41663158 * cos(2 * M_PI * i / (windowSize)) +
-            0.277263158 * cos(4 * M_PI * i / (windowSize)) -
-            0.083578947 * cos(6 * M_PI * i / (windowSize)) +
-            0.006947368 * cos(8 * M_PI * i / (windowSize));
-        windowCorrectionFactor += filterWindowCoefficents[i];
-      }
+      windowCosines = {0.21557895, -0.41663158, 0.277263158, -0.083578947,
+                       0.006947368};
       break;
 
     case WindowType::HAMMING:
@@ -563,26 +626,155 @@ public:
       if (windowTypeIn == WindowType::HAMMING)
         a0 = 25. / 46;
 
-      for (unsigned i = 0; i < windowSize; i++) {
-        filterWindowCoefficents[i] =
-            a0 - (1 - a0) * cos(2 * M_PI * i / (windowSize));
-        windowCorrectionFactor += filterWindowCoefficents[i];
-      }
-
+      windowCosines = {a0, -(1 - a0)};
       break;
     }
 
     default:
-      for (unsigned i = 0; i < windowSize; i++) {
-        filterWindowCoefficents[i] = 1;
-        windowCorrectionFactor += filterWindowCoefficents[i];
-      }
+      windowCosines = {1};
       break;
     }
 
+    windowCorrectionFactor = 0;
+
+    for (unsigned i = 0; i < windowSize; i++) {
+      filterWindowCoefficents[i] = windowCosines[0];
+
+      for (unsigned k = 1; k < windowCosines.size(); k++)
+        filterWindowCoefficents[i] +=
+            windowCosines[k] * cos(2 * M_PI * k * i / (windowSize));
+
+      windowCorrectionFactor += filterWindowCoefficents[i];
+    }
+
     windowCorrectionFactor /= windowSize;
   }
 
+  /*
+   * This function prepares the bins and coefficients of the sliding DFT
+   *
+   * The window of the matrix engine starts with the newest sample which is
+   * followed by the remaining samples from oldest to newest. The sliding DFT
+   * tracks the sum over the latter and adds the newest sample on calculation.
+   */
+  void prepareSlidingDft() {
+    unsigned N = windowSize * windowMultiplier;
+    int startBin = floor(startFrequency / frequencyResolution);
+
+    twiddles.resize(N);
+    for (unsigned k = 0; k < N; k++)
+      twiddles[k] = std::polar(1.0, -2 * M_PI * k / N);
+
+    /* A cosine with period windowSize / k in the window shifts the
+     * frequency by k * windowMultiplier bins. */
+    std::map<int, unsigned> indices;
+    auto addTerm = [&](std::vector<SlidingTerm> &terms, int bin,
+                       double weight) {
+      auto it = indices.find(bin);
+      if (it == indices.end()) {
+        it = indices.emplace(bin, slidingBins.size()).first;
+
+        slidingBins.push_back(
+            {bin, twiddle(-bin), twiddle((int64_t)bin * (windowSize - 1))});
+      }
+
+      terms.push_back({it->second, weight});
+    };
+
+    slidingBins.clear();
+    slidingTerms.clear();
+    slidingTerms.resize(freqCount);
+
+    for (unsigned i = 0; i < freqCount; i++) {
+      int bin = startBin + i;
+
+      addTerm(slidingTerms[i], bin, windowCosines[0]);
+
+      for (unsigned k = 1; k < windowCosines.size(); k++) {
+        int shift = k * windowMultiplier;
+
+        addTerm(slidingTerms[i], bin - shift, windowCosines[k] / 2);
+        addTerm(slidingTerms[i], bin + shift, windowCosines[k] / 2);
+      }
+    }
+
+    slidingSums.clear();
+    for (unsigned i = 0; i < signalIndices.size(); i++)
+      slidingSums.emplace_back(slidingBins.size(), 0.0);
+
+    resyncInterval = (uint64_t)resyncWindows * windowSize;
+    resyncCount = 0;
+
+    logger->info("Using sliding DFT with {} bins for {} frequencies",
+                 slidingBins.size(), freqCount);
+  }
+
+  // Get exp(-2 pi i k / N) for any integer k
+  std::complex<double> twiddle(int64_t k) const {
+    int64_t N = twiddles.size();
+
+    return twiddles[((k % N) + N) % N];
+  }
+
+  /*
+   * This function updates the sliding DFT before the oldest sample in the
+   * sample memory is replaced
+   */
+  void updateSlidingDft() {
+    if (++resyncCount >= resyncInterval) {
+      resyncCount = 0;
+      resyncSlidingDft();
+      return;
+    }
+
+    unsigned oldest = smpMemPos % windowSize;
+    unsigned previous = (smpMemPos + windowSize - 1) % windowSize;
+
+    for (unsigned i = 0; i < signalIndices.size(); i++) {
+      double removed = smpMemoryData[i][oldest];
+      double added = smpMemoryData[i][previous];
+
+      auto &sums = slidingSums[i];
+      for (unsigned j = 0; j < slidingBins.size(); j++)
+        sums[j] = sums[j] * slidingBins[j].rotate - removed +
+                  added * slidingBins[j].last;
+    }
+  }
+
+  /*
+   * This function recalculates the sliding DFT from the sample memory to
+   * remove accumulated rounding errors
+   */
+  void resyncSlidingDft() {
+    for (unsigned i = 0; i < signalIndices.size(); i++) {
+      for (unsigned j = 0; j < slidingBins.size(); j++) {
+        std::complex<double> sum = 0;
+
+        for (unsigned k = 1; k < windowSize; k++)
+          sum += smpMemoryData[i][(smpMemPos + k) % windowSize] *
+                 twiddle((int64_t)slidingBins[j].bin * k);
+
+        slidingSums[i][j] = sum;
+      }
+    }
+  }
+
+  /*
+   * This function calculates the windowed DFT from the sliding DFT
+   */
+  void calculateSlidingDft(unsigned signal,
+                           std::vector<std::complex<double>> &results) {
+    double newest = smpMemoryData[signal][smpMemPos % windowSize];
+    auto &sums = slidingSums[signal];
+
+    for (unsigned i = 0; i < freqCount; i++) {
+      results[i] = 0;
+
+      for (auto &term : slidingTerms[i])
+        results[i] += term.weight * (sums[term.index] + newest);
+    }
+  }
+
   DftEstimate noEstimation(const Point &a, const Point &b, const Point &c,
                            unsigned maxFBin, double startFrequency,
                            double frequencyResolution, double multiplier,
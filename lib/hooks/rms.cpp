@@ -40,6 +40,7 @@ public:
 
     /* Initialize memory for each channel*/
     smpMemory.clear();
+    accumulator.clear();
     for (unsigned i = 0; i < signalIndices.size(); i++) {
       accumulator.push_back(0.0);
       smpMemory.emplace_back(windowSize, 0.0);
@@ -73,32 +74,52 @@ public:
   }
 
   virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
     assert(state == State::STARTED);
 
+    // Channels are independent, so each one is processed for the whole vector
     unsigned i = 0;
     for (auto index : signalIndices) {
-      // Square the new value
-      double newValue = pow(smp->data[index].f, 2);
+      auto &memory = smpMemory[i];
+      double acc = accumulator[i];
 
-      // Get the old value from the history
-      double oldValue = smpMemory[i][smpMemoryPosition % windowSize];
+      for (unsigned j = 0; j < cnt; j++) {
+        unsigned position = (smpMemoryPosition + j) % windowSize;
 
-      // Append the new value to the history memory
-      smpMemory[i][smpMemoryPosition % windowSize] = newValue;
+        // Square the new value
+        double newValue = pow(smps[j]->data[index].f, 2);
 
-      // Update the accumulator
-      accumulator[index] += newValue;
-      accumulator[index] -= oldValue;
+        // Get the old value from the history
+        double oldValue = memory[position];
 
-      auto rms = pow(accumulator[index] / windowSize, 0.5);
+        // Append the new value to the history memory
+        memory[position] = newValue;
 
-      smp->data[index].f = rms;
+        // Update the accumulator
+        acc += newValue;
+        acc -= oldValue;
+
+        smps[j]->data[index].f = pow(acc / windowSize, 0.5);
+      }
+
+      accumulator[i] = acc;
       i++;
     }
 
-    smpMemoryPosition++;
+    smpMemoryPosition += cnt;
+
+    for (unsigned j = 0; j < cnt; j++)
+      reasons[j] = Reason::OK;
 
-    return Reason::OK;
+    return cnt;
   }
 };
 
@@ -6,6 +6,7 @@
  */
 
 #include <villas/hook.hpp>
+#include <villas/hooks/fused.hpp>
 #include <villas/sample.hpp>
 
 namespace villas {
@@ -35,30 +36,66 @@ public:
     state = State::PARSED;
   }
 
-  virtual Hook::Reason process(struct Sample *smp) {
+  virtual bool fuseInto(FusedHook &fh) const {
     for (auto index : signalIndices) {
-      assert(index < smp->length);
-      assert(state == State::STARTED);
+      if (!fh.addOperation(index, FusedHook::Operation::Type::ROUND,
+                           pow(10, precision)))
+        return false;
+    }
+
+    return true;
+  }
+
+  virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
 
-      switch (sample_format(smp, index)) {
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
+    assert(state == State::STARTED);
+
+    if (cnt == 0)
+      return 0;
+
+    double factor = pow(10, precision);
+
+    // All samples of a vector share the same signal list
+    for (auto index : signalIndices) {
+      switch (sample_format(smps[0], index)) {
       case SignalType::FLOAT:
-        smp->data[index].f =
-            round(smp->data[index].f * pow(10, precision)) / pow(10, precision);
+        for (unsigned i = 0; i < cnt; i++) {
+          assert(index < smps[i]->length);
+
+          smps[i]->data[index].f =
+              round(smps[i]->data[index].f * factor) / factor;
+        }
         break;
 
       case SignalType::COMPLEX:
-        smp->data[index].z = std::complex<float>(
-            round(smp->data[index].z.real() * pow(10, precision)) /
-                pow(10, precision),
-            round(smp->data[index].z.imag() * pow(10, precision)) /
-                pow(10, precision));
+        for (unsigned i = 0; i < cnt; i++) {
+          assert(index < smps[i]->length);
+
+          auto z = smps[i]->data[index].z;
+
+          smps[i]->data[index].z =
+              std::complex<float>(round(z.real() * factor) / factor,
+                                  round(z.imag() * factor) / factor);
+        }
         break;
+
       default: {
       }
       }
     }
 
-    return Reason::OK;
+    for (unsigned i = 0; i < cnt; i++)
+      reasons[i] = Reason::OK;
+
+    return cnt;
   }
 };
 
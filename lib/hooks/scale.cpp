@@ -6,6 +6,7 @@
  */
 
 #include <villas/hook.hpp>
+#include <villas/hooks/fused.hpp>
 #include <villas/sample.hpp>
 
 namespace villas {
@@ -37,25 +38,59 @@ public:
     state = State::PARSED;
   }
 
-  virtual Hook::Reason process(struct Sample *smp) {
+  virtual bool fuseInto(FusedHook &fh) const {
     for (auto index : signalIndices) {
-      assert(index < smp->length);
-      assert(state == State::STARTED);
+      if (!fh.addOperation(index, FusedHook::Operation::Type::SCALE, scale,
+                           offset))
+        return false;
+    }
+
+    return true;
+  }
+
+  virtual Hook::Reason process(struct Sample *smp) {
+    Reason reason;
+
+    processBatch(&smp, 1, &reason);
+
+    return reason;
+  }
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
+    assert(state == State::STARTED);
 
-      switch (sample_format(smp, index)) {
+    if (cnt == 0)
+      return 0;
+
+    // All samples of a vector share the same signal list
+    for (auto index : signalIndices) {
+      switch (sample_format(smps[0], index)) {
       case SignalType::INTEGER:
-        smp->data[index].i *= scale;
-        smp->data[index].i += offset;
+        for (unsigned i = 0; i < cnt; i++) {
+          assert(index < smps[i]->length);
+
+          smps[i]->data[index].i *= scale;
+          smps[i]->data[index].i += offset;
+        }
         break;
 
       case SignalType::FLOAT:
-        smp->data[index].f *= scale;
-        smp->data[index].f += offset;
+        for (unsigned i = 0; i < cnt; i++) {
+          assert(index < smps[i]->length);
+
+          smps[i]->data[index].f *= scale;
+          smps[i]->data[index].f += offset;
+        }
         break;
 
       case SignalType::COMPLEX:
-        smp->data[index].z *= scale;
-        smp->data[index].z += offset;
+        for (unsigned i = 0; i < cnt; i++) {
+          assert(index < smps[i]->length);
+
+          smps[i]->data[index].z *= scale;
+          smps[i]->data[index].z += offset;
+        }
         break;
 
       default: {
@@ -63,7 +98,10 @@ public:
       }
     }
 
-    return Reason::OK;
+    for (unsigned i = 0; i < cnt; i++)
+      reasons[i] = Reason::OK;
+
+    return cnt;
   }
 };
 
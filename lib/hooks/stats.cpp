@@ -33,6 +33,9 @@ public:
   }
 
   virtual Hook::Reason process(struct Sample *smp);
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
 };
 
 class StatsReadHook : public Hook {
@@ -42,6 +45,9 @@ protected:
 
   StatsHook *parent;
 
+  // Update the metrics which compare a sample with its predecessor.
+  void update(const struct Sample *prev, const struct Sample *smp);
+
 public:
   StatsReadHook(StatsHook *pa, Path *p, Node *n, int fl, int prio,
                 bool en = true)
@@ -68,6 +74,9 @@ public:
   }
 
   virtual Hook::Reason process(struct Sample *smp);
+
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]);
 };
 
 class StatsHook : public Hook {
@@ -146,6 +155,18 @@ public:
     return Hook::Reason::OK;
   }
 
+  virtual int processBatch(struct Sample *smps[], unsigned cnt,
+                           Reason reasons[]) {
+    // Only call readHook if it hasnt been added to the node's hook list
+    if (!node)
+      return readHook->processBatch(smps, cnt, reasons);
+
+    for (unsigned i = 0; i < cnt; i++)
+      reasons[i] = Reason::OK;
+
+    return cnt;
+  }
+
   virtual void periodic() {
     assert(state == State::STARTED);
 
@@ -205,29 +226,48 @@ Hook::Reason StatsWriteHook::process(struct Sample *smp) {
   return Reason::OK;
 }
 
-Hook::Reason StatsReadHook::process(struct Sample *smp) {
-  if (last) {
-    if (smp->flags & last->flags & (int)SampleFlags::HAS_TS_RECEIVED)
+int StatsWriteHook::processBatch(struct Sample *smps[], unsigned cnt,
+                                 Reason reasons[]) {
+  timespec now = time_now();
+
+  for (unsigned i = 0; i < cnt; i++) {
+    parent->stats->update(Stats::Metric::AGE,
+                          time_delta(&smps[i]->ts.received, &now));
+
+    reasons[i] = Reason::OK;
+  }
+
+  return cnt;
+}
+
+void StatsReadHook::update(const struct Sample *prev,
+                           const struct Sample *smp) {
+  if (prev) {
+    if (smp->flags & prev->flags & (int)SampleFlags::HAS_TS_RECEIVED)
       parent->stats->update(Stats::Metric::GAP_RECEIVED,
-                            time_delta(&last->ts.received, &smp->ts.received));
+                            time_delta(&prev->ts.received, &smp->ts.received));
 
-    if (smp->flags & last->flags & (int)SampleFlags::HAS_TS_ORIGIN)
+    if (smp->flags & prev->flags & (int)SampleFlags::HAS_TS_ORIGIN)
       parent->stats->update(Stats::Metric::GAP_SAMPLE,
-                            time_delta(&last->ts.origin, &smp->ts.origin));
+                            time_delta(&prev->ts.origin, &smp->ts.origin));
 
     if ((smp->flags & (int)SampleFlags::HAS_TS_ORIGIN) &&
         (smp->flags & (int)SampleFlags::HAS_TS_RECEIVED))
       parent->stats->update(Stats::Metric::OWD,
                             time_delta(&smp->ts.origin, &smp->ts.received));
 
-    if (smp->flags & last->flags & (int)SampleFlags::HAS_SEQUENCE) {
-      int dist = smp->sequence - (int32_t)last->sequence;
+    if (smp->flags & prev->flags & (int)SampleFlags::HAS_SEQUENCE) {
+      int dist = smp->sequence - (int32_t)prev->sequence;
       if (dist != 1)
         parent->stats->update(Stats::Metric::SMPS_REORDERED, dist);
     }
   }
 
   parent->stats->update(Stats::Metric::SIGNAL_COUNT, smp->length);
+}
+
+Hook::Reason StatsReadHook::process(struct Sample *smp) {
+  update(last, smp);
 
   sample_incref(smp);
 
@@ -239,6 +279,28 @@ Hook::Reason StatsReadHook::process(struct Sample *smp) {
   return Reason::OK;
 }
 
+int StatsReadHook::processBatch(struct Sample *smps[], unsigned cnt,
+                                Reason reasons[]) {
+  if (cnt == 0)
+    return 0;
+
+  for (unsigned i = 0; i < cnt; i++) {
+    update(i > 0 ? smps[i - 1] : last, smps[i]);
+
+    reasons[i] = Reason::OK;
+  }
+
+  // Only the last sample of the vector needs to be kept
+  sample_incref(smps[cnt - 1]);
+
+  if (last)
+    sample_decref(last);
+
+  last = smps[cnt - 1];
+
+  return cnt;
+}
+
 // Register hook
 static char n[] = "stats";
 static char d[] = "Collect statistics for the current node";
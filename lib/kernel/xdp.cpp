@@ -0,0 +1,433 @@
+/* AF_XDP sockets.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/kernel/xdp.hpp>
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+using namespace villas;
+using namespace villas::kernel;
+
+static int bpf(enum bpf_cmd cmd, union bpf_attr *attr) {
+  return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+XdpSocket::XdpSocket(int ifi, unsigned q, uint16_t et, void *mem,
+                     size_t frms, size_t frmsz, Mode mode)
+    : fd(-1), map_fd(-1), prog_fd(-1), ifindex(ifi), xdp_flags(0), queue(q),
+      ethertype(et), umem((char *)mem), frame_size(frmsz), frames(frms),
+      zerocopy(false), fill(), comp(), rx(), tx(),
+      logger(Log::get("kernel:xdp")) {
+  if (frames < 2 || (frames & (frames - 1)))
+    throw RuntimeError("Number of UMEM frames must be a power of two");
+
+  try {
+    if (mode == Mode::AUTO) {
+      try {
+        setup(Mode::ZEROCOPY);
+      } catch (SystemError &e) {
+        logger->info("Zero-copy mode is not available: {}. Falling back to "
+                     "generic XDP in copy mode",
+                     e.what());
+
+        teardown();
+        setup(Mode::COPY);
+      }
+    } else
+      setup(mode);
+  } catch (...) {
+    teardown();
+    throw;
+  }
+
+  logger->debug("Created AF_XDP socket: ifindex={}, queue={}, zerocopy={}",
+                ifindex, queue, zerocopy ? "yes" : "no");
+}
+
+XdpSocket::~XdpSocket() { teardown(); }
+
+void XdpSocket::setup(Mode mode) {
+  int ret;
+
+  zerocopy = mode == Mode::ZEROCOPY;
+
+  fd = socket(AF_XDP, SOCK_RAW, 0);
+  if (fd < 0)
+    throw SystemError("Failed to create AF_XDP socket");
+
+  // Register UMEM
+  struct xdp_umem_reg reg = {};
+  reg.addr = (uintptr_t)umem;
+  reg.len = frames * frame_size;
+  reg.chunk_size = frame_size;
+
+  ret = setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg));
+  if (ret)
+    throw SystemError("Failed to register UMEM");
+
+  // Half of the frames are used for receiving, the other half for sending
+  int size = frames / 2;
+
+  for (int opt : {XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING,
+                  XDP_TX_RING}) {
+    ret = setsockopt(fd, SOL_XDP, opt, &size, sizeof(size));
+    if (ret)
+      throw SystemError("Failed to set AF_XDP ring size");
+  }
+
+  struct xdp_mmap_offsets off;
+  socklen_t optlen = sizeof(off);
+
+  ret = getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen);
+  if (ret)
+    throw SystemError("Failed to get AF_XDP ring offsets");
+
+  mapRing(&fill, &off.fr, size, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING);
+  mapRing(&comp, &off.cr, size, sizeof(uint64_t),
+          XDP_UMEM_PGOFF_COMPLETION_RING);
+  mapRing(&rx, &off.rx, size, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING);
+  mapRing(&tx, &off.tx, size, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING);
+
+  // Producer rings start out empty, so all entries are free
+  fill.cached_cons = size;
+  tx.cached_cons = size;
+
+  // Hand all RX frames to the kernel
+  auto *addrs = (uint64_t *)fill.descs;
+  for (int i = 0; i < size; i++)
+    addrs[i] = i * frame_size;
+
+  fill.cached_prod = size;
+  __atomic_store_n(fill.producer, size, __ATOMIC_RELEASE);
+
+  tx_free.clear();
+  for (size_t i = size; i < frames; i++)
+    tx_free.push_back(i * frame_size);
+
+  loadProgram();
+
+  attachProgram(prog_fd, XDP_FLAGS_UPDATE_IF_NOEXIST |
+                             (zerocopy ? XDP_FLAGS_DRV_MODE
+                                       : XDP_FLAGS_SKB_MODE));
+
+  struct sockaddr_xdp sxdp = {};
+  sxdp.sxdp_family = AF_XDP;
+  sxdp.sxdp_ifindex = ifindex;
+  sxdp.sxdp_queue_id = queue;
+  sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP | (zerocopy ? XDP_ZEROCOPY : XDP_COPY);
+
+  ret = bind(fd, (struct sockaddr *)&sxdp, sizeof(sxdp));
+  if (ret)
+    throw SystemError("Failed to bind AF_XDP socket");
+
+  // Insert the socket into the XSKMAP at the index of its queue
+  union bpf_attr attr = {};
+  uint32_t key = queue;
+  uint32_t value = fd;
+
+  attr.map_fd = map_fd;
+  attr.key = (uintptr_t)&key;
+  attr.value = (uintptr_t)&value;
+
+  ret = bpf(BPF_MAP_UPDATE_ELEM, &attr);
+  if (ret)
+    throw SystemError("Failed to insert AF_XDP socket into XSKMAP");
+}
+
+void XdpSocket::teardown() {
+  if (xdp_flags) {
+    try {
+      attachProgram(-1, xdp_flags & (XDP_FLAGS_DRV_MODE | XDP_FLAGS_SKB_MODE));
+    } catch (SystemError &e) {
+      logger->warn("Failed to detach XDP program: {}", e.what());
+    }
+
+    xdp_flags = 0;
+  }
+
+  for (auto *r : {&fill, &comp, &rx, &tx})
+    unmapRing(r);
+
+  for (auto *f : {&fd, &map_fd, &prog_fd}) {
+    if (*f >= 0)
+      close(*f);
+
+    *f = -1;
+  }
+}
+
+void XdpSocket::mapRing(struct Ring *r, const struct xdp_ring_offset *off,
+                        size_t size, size_t desc_size, off_t pgoff) {
+  r->map_len = off->desc + size * desc_size;
+  r->map = mmap(nullptr, r->map_len, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, pgoff);
+  if (r->map == MAP_FAILED) {
+    r->map = nullptr;
+    throw SystemError("Failed to map AF_XDP ring");
+  }
+
+  r->producer = (uint32_t *)((char *)r->map + off->producer);
+  r->consumer = (uint32_t *)((char *)r->map + off->consumer);
+  r->flags = (uint32_t *)((char *)r->map + off->flags);
+  r->descs = (char *)r->map + off->desc;
+  r->size = size;
+  r->mask = size - 1;
+  r->cached_prod = 0;
+  r->cached_cons = 0;
+}
+
+void XdpSocket::unmapRing(struct Ring *r) {
+  if (r->map)
+    munmap(r->map, r->map_len);
+
+  *r = {};
+}
+
+/* Load a program which redirects all frames with our Ethertype into the
+ * XSKMAP and passes all other frames to the network stack.
+ *
+ * The program is small enough to be assembled by hand, so we do not
+ * depend on libbpf / libxdp:
+ *
+ *     void *data = (void *)(long)ctx->data;
+ *     void *data_end = (void *)(long)ctx->data_end;
+ *
+ *     if (data + 14 > data_end)
+ *         return XDP_PASS;
+ *
+ *     if (*(__u16 *)(data + 12) != ethertype)
+ *         return XDP_PASS;
+ *
+ *     return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS);
+ */
+void XdpSocket::loadProgram() {
+  union bpf_attr attr = {};
+
+  attr.map_type = BPF_MAP_TYPE_XSKMAP;
+  attr.key_size = sizeof(uint32_t);
+  attr.value_size = sizeof(uint32_t);
+  attr.max_entries = queue + 1;
+
+  map_fd = bpf(BPF_MAP_CREATE, &attr);
+  if (map_fd < 0)
+    throw SystemError("Failed to create XSKMAP");
+
+  struct bpf_insn insns[] = {
+      // r2 = ctx->data, r3 = ctx->data_end
+      {BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1,
+       offsetof(struct xdp_md, data), 0},
+      {BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1,
+       offsetof(struct xdp_md, data_end), 0},
+      // if (r2 + 14 > r3) goto pass
+      {BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0},
+      {BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, 14},
+      {BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 8, 0},
+      // if (*(u16 *)(r2 + 12) != ethertype) goto pass
+      {BPF_LDX | BPF_MEM | BPF_H, BPF_REG_4, BPF_REG_2, 12, 0},
+      {BPF_JMP | BPF_JNE | BPF_K, BPF_REG_4, 0, 6, ethertype},
+      // return bpf_redirect_map(xsks, ctx->rx_queue_index, XDP_PASS)
+      {BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1,
+       offsetof(struct xdp_md, rx_queue_index), 0},
+      {BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map_fd},
+      {0, 0, 0, 0, 0},
+      {BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS},
+      {BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map},
+      {BPF_JMP | BPF_EXIT, 0, 0, 0, 0},
+      // pass: return XDP_PASS
+      {BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS},
+      {BPF_JMP | BPF_EXIT, 0, 0, 0, 0},
+  };
+
+  char log[4096] = "";
+
+  attr = {};
+  attr.prog_type = BPF_PROG_TYPE_XDP;
+  attr.insns = (uintptr_t)insns;
+  attr.insn_cnt = sizeof(insns) / sizeof(insns[0]);
+  attr.license = (uintptr_t) "Apache-2.0";
+  attr.log_buf = (uintptr_t)log;
+  attr.log_size = sizeof(log);
+  attr.log_level = 1;
+
+  prog_fd = bpf(BPF_PROG_LOAD, &attr);
+  if (prog_fd < 0) {
+    logger->debug("Verifier log: {}", log);
+    throw SystemError("Failed to load XDP program");
+  }
+}
+
+// Attach (or detach if fd < 0) the XDP program via rtnetlink
+void XdpSocket::attachProgram(int pfd, int flags) {
+  int ret;
+
+  struct {
+    struct nlmsghdr nh;
+    struct ifinfomsg ifi;
+    char attrs[64];
+  } req = {};
+
+  req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(req.ifi));
+  req.nh.nlmsg_type = RTM_SETLINK;
+  req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+  req.ifi.ifi_family = AF_UNSPEC;
+  req.ifi.ifi_index = ifindex;
+
+  auto *nest = (struct rtattr *)((char *)&req + NLMSG_ALIGN(req.nh.nlmsg_len));
+  nest->rta_type = NLA_F_NESTED | IFLA_XDP;
+  nest->rta_len = RTA_LENGTH(0);
+
+  auto put = [&](int type, const void *data, size_t len) {
+    auto *rta = (struct rtattr *)((char *)nest + RTA_ALIGN(nest->rta_len));
+    rta->rta_type = type;
+    rta->rta_len = RTA_LENGTH(len);
+    memcpy(RTA_DATA(rta), data, len);
+    nest->rta_len = RTA_ALIGN(nest->rta_len) + RTA_ALIGN(rta->rta_len);
+  };
+
+  put(IFLA_XDP_FD, &pfd, sizeof(pfd));
+  put(IFLA_XDP_FLAGS, &flags, sizeof(flags));
+
+  req.nh.nlmsg_len = NLMSG_ALIGN(req.nh.nlmsg_len) + nest->rta_len;
+
+  int sd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (sd < 0)
+    throw SystemError("Failed to create netlink socket");
+
+  ret = ::send(sd, &req, req.nh.nlmsg_len, 0);
+  if (ret < 0) {
+    close(sd);
+    throw SystemError("Failed to send netlink request");
+  }
+
+  char buf[4096];
+  ret = recv(sd, buf, sizeof(buf), 0);
+  close(sd);
+  if (ret < 0)
+    throw SystemError("Failed to receive netlink response");
+
+  auto *nh = (struct nlmsghdr *)buf;
+  if (nh->nlmsg_type == NLMSG_ERROR) {
+    auto *err = (struct nlmsgerr *)NLMSG_DATA(nh);
+    if (err->error) {
+      errno = -err->error;
+      throw SystemError("Failed to {} XDP program",
+                        pfd < 0 ? "detach" : "attach");
+    }
+  }
+
+  xdp_flags = pfd < 0 ? 0 : flags;
+}
+
+unsigned XdpSocket::receive(uint64_t addrs[], uint32_t lens[], unsigned cnt) {
+  uint32_t avail = rx.cached_prod - rx.cached_cons;
+  if (avail < cnt) {
+    rx.cached_prod = __atomic_load_n(rx.producer, __ATOMIC_ACQUIRE);
+    avail = rx.cached_prod - rx.cached_cons;
+  }
+
+  if (cnt > avail)
+    cnt = avail;
+
+  auto *descs = (struct xdp_desc *)rx.descs;
+  for (unsigned i = 0; i < cnt; i++) {
+    auto *desc = &descs[(rx.cached_cons + i) & rx.mask];
+
+    addrs[i] = desc->addr;
+    lens[i] = desc->len;
+  }
+
+  rx.cached_cons += cnt;
+  __atomic_store_n(rx.consumer, rx.cached_cons, __ATOMIC_RELEASE);
+
+  return cnt;
+}
+
+void XdpSocket::release(const uint64_t addrs[], unsigned cnt) {
+  /* The fill ring has as many entries as there are RX frames.
+   * So there is always space for the frames we hand back. */
+  auto *descs = (uint64_t *)fill.descs;
+  for (unsigned i = 0; i < cnt; i++)
+    descs[(fill.cached_prod + i) & fill.mask] = addrs[i];
+
+  fill.cached_prod += cnt;
+  __atomic_store_n(fill.producer, fill.cached_prod, __ATOMIC_RELEASE);
+
+  // Wake up the driver if it ran out of frames
+  if (__atomic_load_n(fill.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP)
+    recvfrom(fd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+}
+
+void XdpSocket::reclaimTx() {
+  comp.cached_prod = __atomic_load_n(comp.producer, __ATOMIC_ACQUIRE);
+
+  auto *descs = (uint64_t *)comp.descs;
+  while (comp.cached_cons != comp.cached_prod)
+    tx_free.push_back(descs[comp.cached_cons++ & comp.mask]);
+
+  __atomic_store_n(comp.consumer, comp.cached_cons, __ATOMIC_RELEASE);
+}
+
+unsigned XdpSocket::allocate(uint64_t addrs[], unsigned cnt) {
+  if (tx_free.size() < cnt)
+    reclaimTx();
+
+  if (cnt > tx_free.size())
+    cnt = tx_free.size();
+
+  for (unsigned i = 0; i < cnt; i++) {
+    addrs[i] = tx_free.back();
+    tx_free.pop_back();
+  }
+
+  return cnt;
+}
+
+void XdpSocket::discard(const uint64_t addrs[], unsigned cnt) {
+  for (unsigned i = 0; i < cnt; i++)
+    tx_free.push_back(addrs[i]);
+}
+
+void XdpSocket::send(const uint64_t addrs[], const uint32_t lens[],
+                     unsigned cnt) {
+  /* The TX ring has as many entries as there are TX frames.
+   * So there is always space for the frames returned by allocate(). */
+  auto *descs = (struct xdp_desc *)tx.descs;
+  for (unsigned i = 0; i < cnt; i++) {
+    auto *desc = &descs[(tx.cached_prod + i) & tx.mask];
+
+    desc->addr = addrs[i];
+    desc->len = lens[i];
+    desc->options = 0;
+  }
+
+  tx.cached_prod += cnt;
+  __atomic_store_n(tx.producer, tx.cached_prod, __ATOMIC_RELEASE);
+
+  // Kick the kernel to process the TX ring
+  if (__atomic_load_n(tx.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP)
+    sendto(fd, nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+}
@@ -49,7 +49,8 @@ Node::Node(const uuid_t &id, const std::string &name)
 #ifdef WITH_NETEM
       tc_qdisc(nullptr), tc_classifier(nullptr),
 #endif // WITH_NETEM
-      state(State::INITIALIZED), enabled(true), config(nullptr),
+      state(State::INITIALIZED), enabled(true), nonblocking(false),
+      config(nullptr),
       name_short(name), affinity(-1), // all cores
       factory(nullptr) {
   if (uuid_is_null(id)) {
@@ -272,10 +273,15 @@ int Node::read(struct Sample *smps[], unsigned cnt) {
     readd = _read(&smps[nread], toread);
     if (readd < 0)
       return readd;
+    else if (readd == 0 && nonblocking)
+      break;
 
     nread += readd;
   }
 
+  if (nread == 0)
+    return 0;
+
 #ifdef WITH_HOOKS
   // Run read hooks
   int rread = in.hooks.process(smps, nread);
@@ -300,6 +306,15 @@ int Node::read(struct Sample *smps[], unsigned cnt) {
 #endif // WITH_HOOKS
 }
 
+int Node::setNonBlocking(bool en) {
+  if (!(factory->getFlags() & (int)NodeFactory::Flags::SUPPORTS_NONBLOCKING))
+    return -1;
+
+  nonblocking = en;
+
+  return 0;
+}
+
 int Node::write(struct Sample *smps[], unsigned cnt) {
   int tosend, sent, nsent = 0;
   unsigned vect;
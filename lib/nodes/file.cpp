@@ -305,6 +305,8 @@ int villas::node::file_stop(NodeCompat *n) {
 
   f->task.stop();
 
+  f->formatter->finish(f->stream_out);
+
   fclose(f->stream_in);
   fclose(f->stream_out);
 
@@ -322,7 +324,7 @@ int villas::node::file_read(NodeCompat *n, struct Sample *const smps[],
 retry:
   ret = f->formatter->scan(f->stream_in, smps, cnt);
   if (ret <= 0) {
-    if (feof(f->stream_in)) {
+    if (f->formatter->eof(f->stream_in)) {
       switch (f->eof_mode) {
       case file::EOFBehaviour::REWIND:
         n->logger->info("Rewind input file");
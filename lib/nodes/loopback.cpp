@@ -55,7 +55,10 @@ int LoopbackNode::_read(struct Sample *smps[], unsigned cnt) {
 
   struct Sample *cpys[cnt];
 
-  avail = queue_signalled_pull_many(&queue, (void **)cpys, cnt);
+  if (nonblocking)
+    avail = queue_signalled_try_pull_many(&queue, (void **)cpys, cnt);
+  else
+    avail = queue_signalled_pull_many(&queue, (void **)cpys, cnt);
 
   sample_copy_many(smps, cpys, avail);
   sample_decref_many(cpys, avail);
@@ -129,5 +132,6 @@ static char d[] = "Loopback node-type";
 static NodePlugin<LoopbackNode, n, d,
                   (int)NodeFactory::Flags::SUPPORTS_POLL |
                       (int)NodeFactory::Flags::SUPPORTS_READ |
-                      (int)NodeFactory::Flags::SUPPORTS_WRITE>
+                      (int)NodeFactory::Flags::SUPPORTS_WRITE |
+                      (int)NodeFactory::Flags::SUPPORTS_NONBLOCKING>
     nf;
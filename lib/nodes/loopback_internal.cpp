@@ -39,7 +39,11 @@ InternalLoopbackNode::InternalLoopbackNode(Node *src, unsigned id, unsigned ql)
 
   in.signals = source->getInputSignals(false);
 
-  ret = queue_signalled_init(&queue, queuelen);
+  /* The master path source of the node is the only producer and the
+   * secondary path source the only consumer of the queue.
+   */
+  ret = queue_signalled_init(&queue, queuelen, memory::default_type,
+                             QueueSignalledMode::AUTO, (int)QueueFlags::SPSC);
   if (ret)
     throw RuntimeError("Failed to initialize queue");
 
@@ -67,7 +71,10 @@ int InternalLoopbackNode::_read(struct Sample *smps[], unsigned cnt) {
 
   struct Sample *cpys[cnt];
 
-  avail = queue_signalled_pull_many(&queue, (void **)cpys, cnt);
+  if (nonblocking)
+    avail = queue_signalled_try_pull_many(&queue, (void **)cpys, cnt);
+  else
+    avail = queue_signalled_pull_many(&queue, (void **)cpys, cnt);
 
   sample_copy_many(smps, cpys, avail);
   sample_decref_many(cpys, avail);
@@ -7,8 +7,11 @@
 
 #include <arpa/inet.h>
 #include <cerrno>
+#include <climits>
 #include <cstring>
 #include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <unistd.h>
 
 #include <villas/compat.hpp>
@@ -23,6 +26,13 @@
 #include <netinet/ether.h>
 #endif // WITH_SOCKET_LAYER_ETH
 
+#ifdef WITH_SOCKET_LAYER_XDP
+#include <net/if.h>
+#include <sys/ioctl.h>
+
+#include <villas/node/memory.hpp>
+#endif // WITH_SOCKET_LAYER_XDP
+
 #ifdef WITH_NETEM
 #include <villas/kernel/if.hpp>
 #include <villas/kernel/nl.hpp>
@@ -64,9 +74,321 @@ int villas::node::socket_init(NodeCompat *n) {
 
   s->formatter = nullptr;
 
+  s->batch.enabled = 0;
+  s->batch.gso = 0;
+  s->batch.gro = 0;
+
+#ifdef WITH_IO_URING
+  s->io_uring.enabled = 0;
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+  s->xdp.queue = 0;
+  s->xdp.frames = 4096;
+  s->xdp.frame_size = 2048;
+  s->xdp.mode = kernel::XdpSocket::Mode::AUTO;
+  s->xdp.sock = nullptr;
+  s->xdp.umem = nullptr;
+#endif // WITH_SOCKET_LAYER_XDP
+
   return 0;
 }
 
+static socklen_t socket_addrlen(const union sockaddr_union *sa) {
+  switch (sa->ss.ss_family) {
+  case AF_INET:
+    return sizeof(struct sockaddr_in);
+
+  case AF_INET6:
+    return sizeof(struct sockaddr_in6);
+
+  case AF_UNIX:
+    return SUN_LEN(&sa->sun);
+
+#ifdef WITH_SOCKET_LAYER_ETH
+  case AF_PACKET:
+    return sizeof(struct sockaddr_ll);
+#endif // WITH_SOCKET_LAYER_ETH
+  default:
+    return sizeof(*sa);
+  }
+}
+
+// Allocate buffers for recvmmsg() / sendmmsg()
+static void socket_batch_init(NodeCompat *n) {
+  auto *s = n->getData<struct Socket>();
+
+  s->in.slots = n->in.vectorize;
+  s->in.buflen =
+      s->batch.gro ? SOCKET_INITIAL_BUFFER_LEN : SOCKET_BATCH_BUFFER_LEN;
+  s->in.buf = new char[s->in.slots * s->in.buflen];
+  s->in.msgs = new struct mmsghdr[s->in.slots];
+  s->in.iovs = new struct iovec[s->in.slots];
+  s->in.saddrs = new union sockaddr_union[s->in.slots];
+  s->in.ctrl = s->batch.gro ? new char[s->in.slots * CMSG_SPACE(sizeof(int))]
+                            : nullptr;
+
+  s->out.slots = n->out.vectorize;
+  s->out.buflen = SOCKET_BATCH_BUFFER_LEN;
+  s->out.buf = new char[s->out.slots * s->out.buflen];
+  s->out.msgs = new struct mmsghdr[s->out.slots];
+  s->out.iovs = new struct iovec[s->out.slots];
+  s->out.saddrs = nullptr;
+  s->out.ctrl = new char[CMSG_SPACE(sizeof(uint16_t))];
+
+  s->batch.received = 0;
+  s->batch.next = 0;
+  s->batch.offset = 0;
+
+  memset(s->in.msgs, 0, s->in.slots * sizeof(struct mmsghdr));
+  memset(s->out.msgs, 0, s->out.slots * sizeof(struct mmsghdr));
+}
+
+static void socket_batch_destroy(NodeCompat *n) {
+  auto *s = n->getData<struct Socket>();
+
+  delete[] s->in.msgs;
+  delete[] s->in.iovs;
+  delete[] s->in.saddrs;
+  delete[] s->in.ctrl;
+
+  delete[] s->out.msgs;
+  delete[] s->out.iovs;
+  delete[] s->out.ctrl;
+}
+
+#ifdef WITH_IO_URING
+// Buffer group ID of the receive buffers
+#define SOCKET_IO_URING_BGID 0
+
+// User data of the receive and cancel requests
+#define SOCKET_IO_URING_RECV 0
+#define SOCKET_IO_URING_CANCEL 1
+
+// (Re-)submit the multishot receive request
+static void socket_io_uring_arm(NodeCompat *n) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  auto *sqe = io_uring_get_sqe(&s->io_uring.in);
+  if (!sqe)
+    throw RuntimeError("io_uring submission queue is full");
+
+  io_uring_prep_recvmsg_multishot(sqe, s->sd, &s->io_uring.msg, 0);
+  io_uring_sqe_set_data64(sqe, SOCKET_IO_URING_RECV);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = SOCKET_IO_URING_BGID;
+
+  ret = io_uring_submit(&s->io_uring.in);
+  if (ret < 0) {
+    errno = -ret;
+    throw SystemError("Failed to submit multishot receive");
+  }
+}
+
+static void socket_io_uring_init(NodeCompat *n) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  /* Each receive buffer holds the io_uring_recvmsg_out header, the source
+   * address and the payload of a single datagram. */
+  s->io_uring.nbufs = LOG2_CEIL(MAX(n->in.vectorize * 4, 64u));
+  s->in.buflen = sizeof(struct io_uring_recvmsg_out) +
+                 sizeof(union sockaddr_union) + SOCKET_BATCH_BUFFER_LEN;
+  s->in.buf = new char[s->io_uring.nbufs * s->in.buflen];
+
+  ret = io_uring_queue_init(s->io_uring.nbufs, &s->io_uring.in, 0);
+  if (ret < 0) {
+    errno = -ret;
+    throw SystemError("Failed to setup io_uring for receiving");
+  }
+
+  s->io_uring.br = io_uring_setup_buf_ring(
+      &s->io_uring.in, s->io_uring.nbufs, SOCKET_IO_URING_BGID, 0, &ret);
+  if (!s->io_uring.br) {
+    errno = -ret;
+    throw SystemError("Failed to register receive buffers");
+  }
+
+  int mask = io_uring_buf_ring_mask(s->io_uring.nbufs);
+  for (unsigned i = 0; i < s->io_uring.nbufs; i++)
+    io_uring_buf_ring_add(s->io_uring.br, s->in.buf + i * s->in.buflen,
+                          s->in.buflen, i, mask, i);
+
+  io_uring_buf_ring_advance(s->io_uring.br, s->io_uring.nbufs);
+
+  memset(&s->io_uring.msg, 0, sizeof(s->io_uring.msg));
+  s->io_uring.msg.msg_namelen = sizeof(union sockaddr_union);
+
+  socket_io_uring_arm(n);
+
+  s->out.slots = n->out.vectorize;
+  s->out.buflen = SOCKET_BATCH_BUFFER_LEN;
+  s->out.buf = new char[s->out.slots * s->out.buflen];
+  s->out.msgs = new struct mmsghdr[s->out.slots];
+  s->out.iovs = new struct iovec[s->out.slots];
+
+  memset(s->out.msgs, 0, s->out.slots * sizeof(struct mmsghdr));
+
+  ret = io_uring_queue_init(s->out.slots, &s->io_uring.out, 0);
+  if (ret < 0) {
+    errno = -ret;
+    throw SystemError("Failed to setup io_uring for sending");
+  }
+
+  s->io_uring.inflight = 0;
+}
+
+/* Cancel the multishot receive and wait for all pending sends.
+ *
+ * Afterwards, the kernel does not access the buffers anymore.
+ */
+static void socket_io_uring_cancel(NodeCompat *n) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  struct io_uring *ring = &s->io_uring.in;
+  struct io_uring_cqe *cqe;
+
+  /* Unprocessed completions are dropped. If one of them terminated the
+   * multishot receive, it has not been re-armed. */
+  unsigned head, seen = 0;
+  bool armed = true;
+
+  io_uring_for_each_cqe(ring, head, cqe) {
+    if (!(cqe->flags & IORING_CQE_F_MORE) &&
+        io_uring_cqe_get_data64(cqe) == SOCKET_IO_URING_RECV)
+      armed = false;
+
+    seen++;
+  }
+
+  io_uring_cq_advance(ring, seen);
+
+  if (armed) {
+    auto *sqe = io_uring_get_sqe(ring);
+    if (!sqe)
+      throw RuntimeError("io_uring submission queue is full");
+
+    io_uring_prep_cancel_fd(sqe, s->sd, IORING_ASYNC_CANCEL_ALL);
+    io_uring_sqe_set_data64(sqe, SOCKET_IO_URING_CANCEL);
+
+    ret = io_uring_submit(ring);
+    if (ret < 0) {
+      errno = -ret;
+      throw SystemError("Failed to cancel multishot receive");
+    }
+
+    // The last completion of the receive lacks IORING_CQE_F_MORE
+    while (armed) {
+      ret = io_uring_wait_cqe(ring, &cqe);
+      if (ret < 0) {
+        errno = -ret;
+        throw SystemError("Failed to wait for cancellation");
+      }
+
+      if (!(cqe->flags & IORING_CQE_F_MORE) &&
+          io_uring_cqe_get_data64(cqe) == SOCKET_IO_URING_RECV)
+        armed = false;
+
+      io_uring_cqe_seen(ring, cqe);
+    }
+  }
+
+  while (s->io_uring.inflight > 0) {
+    ret = io_uring_wait_cqe(&s->io_uring.out, &cqe);
+    if (ret < 0) {
+      errno = -ret;
+      throw SystemError("Failed to wait for pending sends");
+    }
+
+    io_uring_cqe_seen(&s->io_uring.out, cqe);
+    s->io_uring.inflight--;
+  }
+}
+
+static void socket_io_uring_destroy(NodeCompat *n) {
+  auto *s = n->getData<struct Socket>();
+
+  socket_io_uring_cancel(n);
+
+  io_uring_free_buf_ring(&s->io_uring.in, s->io_uring.br, s->io_uring.nbufs,
+                         SOCKET_IO_URING_BGID);
+  io_uring_queue_exit(&s->io_uring.in);
+  io_uring_queue_exit(&s->io_uring.out);
+
+  delete[] s->out.msgs;
+  delete[] s->out.iovs;
+
+  s->out.msgs = nullptr;
+  s->out.iovs = nullptr;
+}
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+static void socket_xdp_init(NodeCompat *n) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  struct ifreq ifr = {};
+  if (!if_indextoname(s->in.saddr.sll.sll_ifindex, ifr.ifr_name))
+    throw SystemError("Failed to get interface name");
+
+  // Get MAC address and MTU of the interface for building frames
+  int sd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sd < 0)
+    throw SystemError("Failed to create socket");
+
+  ret = ioctl(sd, SIOCGIFHWADDR, &ifr);
+  if (!ret)
+    memcpy(s->xdp.mac, ifr.ifr_hwaddr.sa_data, ETHER_ADDR_LEN);
+
+  if (!ret)
+    ret = ioctl(sd, SIOCGIFMTU, &ifr);
+
+  close(sd);
+
+  if (ret)
+    throw SystemError("Failed to get address of interface {}", ifr.ifr_name);
+
+  s->xdp.mtu = ifr.ifr_mtu;
+
+  /* The UMEM is allocated from the same memory type as the sample pools of
+   * the node, e.g. hugepages. */
+  size_t len = (size_t)s->xdp.frames * s->xdp.frame_size;
+  s->xdp.umem = memory::alloc_aligned(len, getpagesize(), n->getMemoryType());
+  if (!s->xdp.umem)
+    throw MemoryAllocationError();
+
+  s->xdp.sock = new kernel::XdpSocket(
+      s->in.saddr.sll.sll_ifindex, s->xdp.queue, s->in.saddr.sll.sll_protocol,
+      s->xdp.umem, s->xdp.frames, s->xdp.frame_size, s->xdp.mode);
+
+  s->sd = s->xdp.sock->getFD();
+
+  s->xdp.received = 0;
+  s->xdp.next = 0;
+
+  s->in.buf = nullptr;
+  s->out.buf = nullptr;
+
+  n->logger->info("Using AF_XDP on interface {} in {} mode", ifr.ifr_name,
+                  s->xdp.sock->isZeroCopy() ? "zero-copy" : "copy");
+}
+
+static void socket_xdp_destroy(NodeCompat *n) {
+  auto *s = n->getData<struct Socket>();
+
+  // The socket descriptor is owned by the XdpSocket
+  delete s->xdp.sock;
+  s->xdp.sock = nullptr;
+  s->sd = -1;
+
+  memory::free(s->xdp.umem);
+  s->xdp.umem = nullptr;
+}
+#endif // WITH_SOCKET_LAYER_XDP
+
 int villas::node::socket_destroy(NodeCompat *n) {
   auto *s = n->getData<struct Socket>();
 
@@ -97,6 +419,10 @@ char *villas::node::socket_print(NodeCompat *n) {
   case SocketLayer::UNIX:
     layer = "unix";
     break;
+
+  case SocketLayer::XDP:
+    layer = "xdp";
+    break;
   }
 
   char *local = socket_print_addr((struct sockaddr *)&s->in.saddr);
@@ -122,6 +448,21 @@ char *villas::node::socket_print(NodeCompat *n) {
     strcatf(&buf, ", in.multicast.ttl=%u", s->multicast.ttl);
   }
 
+  if (s->batch.enabled)
+    strcatf(&buf, ", batch.gso=%s, batch.gro=%s", s->batch.gso ? "yes" : "no",
+            s->batch.gro ? "yes" : "no");
+
+#ifdef WITH_SOCKET_LAYER_XDP
+  if (s->layer == SocketLayer::XDP) {
+    strcatf(&buf, ", xdp.queue=%d, xdp.frames=%d, xdp.frame_size=%d",
+            s->xdp.queue, s->xdp.frames, s->xdp.frame_size);
+
+    if (s->xdp.sock)
+      strcatf(&buf, ", xdp.zerocopy=%s",
+              s->xdp.sock->isZeroCopy() ? "yes" : "no");
+  }
+#endif // WITH_SOCKET_LAYER_XDP
+
   free(local);
   free(remote);
 
@@ -131,6 +472,15 @@ char *villas::node::socket_print(NodeCompat *n) {
 int villas::node::socket_check(NodeCompat *n) {
   auto *s = n->getData<struct Socket>();
 
+  if (s->batch.enabled && (s->batch.gso || s->batch.gro) &&
+      s->layer != SocketLayer::UDP)
+    throw RuntimeError("Segmentation offloads are only supported for UDP");
+
+#ifdef WITH_IO_URING
+  if (s->io_uring.enabled && s->batch.enabled)
+    throw RuntimeError("Batched I/O can not be used together with io_uring");
+#endif // WITH_IO_URING
+
   // Some checks on the addresses
   if (s->layer != SocketLayer::UNIX) {
     if (s->in.saddr.sa.sa_family != s->out.saddr.sa.sa_family)
@@ -142,7 +492,7 @@ int villas::node::socket_check(NodeCompat *n) {
       throw RuntimeError("IP protocol numbers of local and remote must match!");
   }
 #ifdef WITH_SOCKET_LAYER_ETH
-  else if (s->layer == SocketLayer::ETH) {
+  else if (s->layer == SocketLayer::ETH || s->layer == SocketLayer::XDP) {
     if (ntohs(s->in.saddr.sll.sll_protocol) !=
         ntohs(s->out.saddr.sll.sll_protocol))
       throw RuntimeError("Ethertypes of local and remote must match!");
@@ -151,6 +501,27 @@ int villas::node::socket_check(NodeCompat *n) {
       throw RuntimeError("Ethertype must be large than {} or it is interpreted "
                          "as an IEEE802.3 length field!",
                          0x5DC);
+
+    if (s->layer == SocketLayer::XDP) {
+      if (s->in.saddr.sll.sll_ifindex != s->out.saddr.sll.sll_ifindex)
+        throw RuntimeError("Interfaces of local and remote must match!");
+
+      if (s->batch.enabled)
+        throw RuntimeError("Batched I/O is not supported by the XDP layer");
+
+#ifdef WITH_IO_URING
+      if (s->io_uring.enabled)
+        throw RuntimeError("io_uring is not supported by the XDP layer");
+#endif // WITH_IO_URING
+
+      if (s->xdp.frames < 2 || s->xdp.frames & (s->xdp.frames - 1))
+        throw RuntimeError("Setting 'xdp.frames' must be a power of two");
+
+      if (s->xdp.frame_size < 2048 || s->xdp.frame_size > getpagesize() ||
+          s->xdp.frame_size & (s->xdp.frame_size - 1))
+        throw RuntimeError("Setting 'xdp.frame_size' must be a power of two "
+                           "between 2048 and the page size");
+    }
   }
 #endif // WITH_SOCKET_LAYER_ETH
 
@@ -173,6 +544,14 @@ int villas::node::socket_start(NodeCompat *n) {
   // Initialize IO
   s->formatter->start(n->getInputSignals(false), ~(int)SampleFlags::HAS_OFFSET);
 
+#ifdef WITH_SOCKET_LAYER_XDP
+  if (s->layer == SocketLayer::XDP) {
+    socket_xdp_init(n);
+
+    return 0;
+  }
+#endif // WITH_SOCKET_LAYER_XDP
+
   // Create socket
   switch (s->layer) {
   case SocketLayer::UDP:
@@ -210,28 +589,7 @@ int villas::node::socket_start(NodeCompat *n) {
   }
 
   // Bind socket for receiving
-  socklen_t addrlen = 0;
-  switch (s->in.saddr.ss.ss_family) {
-  case AF_INET:
-    addrlen = sizeof(struct sockaddr_in);
-    break;
-
-  case AF_INET6:
-    addrlen = sizeof(struct sockaddr_in6);
-    break;
-
-  case AF_UNIX:
-    addrlen = SUN_LEN(&s->in.saddr.sun);
-    break;
-
-#ifdef WITH_SOCKET_LAYER_ETH
-  case AF_PACKET:
-    addrlen = sizeof(struct sockaddr_ll);
-    break;
-#endif // WITH_SOCKET_LAYER_ETH
-  default:
-    addrlen = sizeof(s->in.saddr);
-  }
+  socklen_t addrlen = socket_addrlen(&s->in.saddr);
 
   ret = bind(s->sd, (struct sockaddr *)&s->in.saddr, addrlen);
   if (ret < 0)
@@ -280,11 +638,37 @@ int villas::node::socket_start(NodeCompat *n) {
 #endif // __linux__
   }
 
+#ifdef UDP_GRO
+  if (s->batch.enabled && s->batch.gro) {
+    int on = 1;
+    if (setsockopt(s->sd, SOL_UDP, UDP_GRO, &on, sizeof(on)))
+      throw SystemError("Failed to enable UDP generic receive offload");
+  }
+#endif // UDP_GRO
+
+#ifdef WITH_IO_URING
+  if (s->io_uring.enabled) {
+    socket_io_uring_init(n);
+
+    return 0;
+  }
+#endif // WITH_IO_URING
+
+  if (s->batch.enabled) {
+    socket_batch_init(n);
+
+    return 0;
+  }
+
   s->out.buflen = SOCKET_INITIAL_BUFFER_LEN;
   s->out.buf = new char[s->out.buflen];
   if (!s->out.buf)
     throw MemoryAllocationError();
 
+  // The formatter references up to two vectors per sample
+  s->out.slots = MIN(2 * n->out.vectorize, (unsigned)IOV_MAX);
+  s->out.iovs = new struct iovec[s->out.slots];
+
   s->in.buflen = SOCKET_INITIAL_BUFFER_LEN;
   s->in.buf = new char[s->in.buflen];
   if (!s->in.buf)
@@ -315,42 +699,51 @@ int villas::node::socket_stop(NodeCompat *n) {
       throw SystemError("Failed to leave multicast group");
   }
 
-  if (s->sd >= 0) {
-    ret = close(s->sd);
-    if (ret)
-      return ret;
+#ifdef WITH_SOCKET_LAYER_XDP
+  if (s->layer == SocketLayer::XDP) {
+    socket_xdp_destroy(n);
+
+    return 0;
   }
+#endif // WITH_SOCKET_LAYER_XDP
+
+  /* The kernel may still access the buffers of pending io_uring requests.
+   * Hence, we tear down the rings before releasing the buffers. */
+#ifdef WITH_IO_URING
+  if (s->io_uring.enabled)
+    socket_io_uring_destroy(n);
+#endif // WITH_IO_URING
+
+  if (s->batch.enabled)
+    socket_batch_destroy(n);
+  else
+    delete[] s->out.iovs;
 
   delete[] s->in.buf;
   delete[] s->out.buf;
 
-  return 0;
+  ret = 0;
+  if (s->sd >= 0)
+    ret = close(s->sd);
+
+  return ret;
 }
 
-int villas::node::socket_read(NodeCompat *n, struct Sample *const smps[],
-                              unsigned cnt) {
+/* Decode a single received datagram
+ *
+ * If \p partial is given, it is set if the datagram contains more than
+ * \p cnt samples. Such a datagram is then not reported as invalid, so that
+ * the caller can decode it again once there is enough space.
+ */
+static int socket_read_datagram(NodeCompat *n, char *ptr, ssize_t bytes,
+                                union sockaddr_union *src,
+                                struct Sample *const smps[], unsigned cnt,
+                                bool *partial = nullptr) {
   int ret;
   auto *s = n->getData<struct Socket>();
 
-  char *ptr;
-  ssize_t bytes;
   size_t rbytes;
 
-  union sockaddr_union src;
-  socklen_t srclen = sizeof(src);
-
-  // Receive next sample
-  bytes = recvfrom(s->sd, s->in.buf, s->in.buflen, 0, &src.sa, &srclen);
-  if (bytes < 0) {
-    if (errno == EINTR)
-      return -1;
-
-    throw SystemError("Failed recvfrom()");
-  } else if (bytes == 0)
-    return 0;
-
-  ptr = s->in.buf;
-
   // Strip IP header from packet
   if (s->layer == SocketLayer::IP) {
     struct ip *iphdr = (struct ip *)ptr;
@@ -362,19 +755,20 @@ int villas::node::socket_read(NodeCompat *n, struct Sample *const smps[],
   /* SOCK_RAW IP sockets to not provide the IP protocol number via recvmsg()
    * So we simply set it ourself. */
   if (s->layer == SocketLayer::IP) {
-    switch (src.sa.sa_family) {
+    switch (src->sa.sa_family) {
     case AF_INET:
-      src.sin.sin_port = s->out.saddr.sin.sin_port;
+      src->sin.sin_port = s->out.saddr.sin.sin_port;
       break;
 
     case AF_INET6:
-      src.sin6.sin6_port = s->out.saddr.sin6.sin6_port;
+      src->sin6.sin6_port = s->out.saddr.sin6.sin6_port;
       break;
     }
   }
 
-  if (s->verify_source && socket_compare_addr(&src.sa, &s->out.saddr.sa) != 0) {
-    char *buf = socket_print_addr((struct sockaddr *)&src);
+  if (s->verify_source &&
+      socket_compare_addr(&src->sa, &s->out.saddr.sa) != 0) {
+    char *buf = socket_print_addr((struct sockaddr *)src);
     n->logger->warn("Received packet from unauthorized source: {}", buf);
     free(buf);
 
@@ -382,23 +776,548 @@ int villas::node::socket_read(NodeCompat *n, struct Sample *const smps[],
   }
 
   ret = s->formatter->sscan(ptr, bytes, &rbytes, smps, cnt);
-  if (ret < 0 || (size_t)bytes != rbytes)
+  if (ret == (int)cnt && (size_t)bytes > rbytes && partial)
+    *partial = true;
+  else if (ret < 0 || (size_t)bytes != rbytes)
     n->logger->warn("Received invalid packet: ret={}, bytes={}, rbytes={}", ret,
                     bytes, rbytes);
 
   return ret;
 }
 
+/* Receive up to cnt datagrams with a single recvmmsg()
+ *
+ * Datagrams and segments which do not fit into smps are kept for the next
+ * call.
+ */
+static int socket_read_batch(NodeCompat *n, struct Sample *const smps[],
+                             unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  if (s->batch.next >= s->batch.received) {
+    unsigned vlen = MIN(cnt, s->in.slots);
+
+    for (unsigned i = 0; i < vlen; i++) {
+      struct msghdr *hdr = &s->in.msgs[i].msg_hdr;
+
+      s->in.iovs[i].iov_base = s->in.buf + i * s->in.buflen;
+      s->in.iovs[i].iov_len = s->in.buflen;
+
+      hdr->msg_name = &s->in.saddrs[i];
+      hdr->msg_namelen = sizeof(s->in.saddrs[i]);
+      hdr->msg_iov = &s->in.iovs[i];
+      hdr->msg_iovlen = 1;
+      hdr->msg_control =
+          s->in.ctrl ? s->in.ctrl + i * CMSG_SPACE(sizeof(int)) : nullptr;
+      hdr->msg_controllen = s->in.ctrl ? CMSG_SPACE(sizeof(int)) : 0;
+      hdr->msg_flags = 0;
+    }
+
+    // Block until the first datagram arrives, then take what is available
+    int flags = n->isNonBlocking() ? MSG_DONTWAIT : MSG_WAITFORONE;
+
+    ret = recvmmsg(s->sd, s->in.msgs, vlen, flags, nullptr);
+    if (ret < 0) {
+      if (errno == EINTR)
+        return -1;
+      else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+
+      throw SystemError("Failed recvmmsg()");
+    }
+
+    s->batch.received = ret;
+    s->batch.next = 0;
+    s->batch.offset = 0;
+  }
+
+  unsigned nread = 0;
+  for (; s->batch.next < s->batch.received;
+       s->batch.next++, s->batch.offset = 0) {
+    unsigned i = s->batch.next;
+
+    struct msghdr *hdr = &s->in.msgs[i].msg_hdr;
+    char *ptr = (char *)s->in.iovs[i].iov_base;
+    ssize_t bytes = s->in.msgs[i].msg_len;
+    ssize_t segsz = bytes;
+
+#ifdef UDP_GRO
+    // Coalesced datagrams: split them by their segment size
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg;
+         cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+        int gso_size;
+        memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+        if (gso_size > 0)
+          segsz = gso_size;
+      }
+    }
+#endif // UDP_GRO
+
+    for (; s->batch.offset < bytes; s->batch.offset += segsz) {
+      if (nread >= cnt)
+        return nread;
+
+      ssize_t off = s->batch.offset;
+      bool partial = false;
+
+      int decoded = socket_read_datagram(
+          n, ptr + off, MIN(segsz, bytes - off), &s->in.saddrs[i],
+          &smps[nread], cnt - nread, &partial);
+      if (partial && nread > 0)
+        return nread; // Decode the segment again in the next call
+      else if (partial)
+        n->logger->warn("Received datagram with more than {} samples", cnt);
+
+      if (decoded > 0)
+        nread += decoded;
+    }
+  }
+
+  return nread;
+}
+
+#ifdef WITH_IO_URING
+// Decode the datagrams of all pending multishot receive completions
+static int socket_read_io_uring(NodeCompat *n, struct Sample *const smps[],
+                                unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  struct io_uring *ring = &s->io_uring.in;
+  struct io_uring_cqe *cqe;
+
+  int mask = io_uring_buf_ring_mask(s->io_uring.nbufs);
+
+  // We wait in poll(2) as it is a cancellation point unlike io_uring_enter(2)
+  if (!io_uring_cq_ready(ring)) {
+    if (n->isNonBlocking())
+      return 0;
+
+    struct pollfd pfd = {.fd = ring->ring_fd, .events = POLLIN};
+
+    ret = ::poll(&pfd, 1, -1);
+    if (ret < 0) {
+      if (errno == EINTR)
+        return -1;
+
+      throw SystemError("Failed to poll");
+    }
+  }
+
+  unsigned head, seen = 0, nread = 0;
+  bool rearm = false;
+
+  io_uring_for_each_cqe(ring, head, cqe) {
+    if (nread >= cnt)
+      break;
+
+    if (cqe->res < 0) {
+      if (cqe->res != -ENOBUFS) {
+        errno = -cqe->res;
+        throw SystemError("Failed to receive");
+      }
+
+      n->logger->warn("Ran out of receive buffers");
+    } else if (cqe->flags & IORING_CQE_F_BUFFER) {
+      unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+      char *buf = s->in.buf + bid * s->in.buflen;
+
+      auto *out = io_uring_recvmsg_validate(buf, cqe->res, &s->io_uring.msg);
+      if (!out || out->flags & MSG_TRUNC)
+        n->logger->warn("Received truncated packet");
+      else {
+        auto *src = (union sockaddr_union *)io_uring_recvmsg_name(out);
+        auto *payload =
+            (char *)io_uring_recvmsg_payload(out, &s->io_uring.msg);
+        auto bytes =
+            io_uring_recvmsg_payload_length(out, cqe->res, &s->io_uring.msg);
+        bool partial = false;
+
+        ret = socket_read_datagram(n, payload, bytes, src, &smps[nread],
+                                   cnt - nread, &partial);
+        if (partial && nread > 0)
+          break; // Leave the completion for the next call
+        else if (partial)
+          n->logger->warn("Received datagram with more than {} samples", cnt);
+
+        if (ret > 0)
+          nread += ret;
+      }
+
+      // Return the buffer to the kernel
+      io_uring_buf_ring_add(s->io_uring.br, buf, s->in.buflen, bid, mask, 0);
+      io_uring_buf_ring_advance(s->io_uring.br, 1);
+    }
+
+    seen++;
+
+    // The kernel terminates multishot requests, e.g. if it runs out of buffers
+    if (!(cqe->flags & IORING_CQE_F_MORE))
+      rearm = true;
+  }
+
+  io_uring_cq_advance(ring, seen);
+
+  if (rearm)
+    socket_io_uring_arm(n);
+
+  return nread;
+}
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+/* Decode received frames directly from the UMEM
+ *
+ * Frames which do not fit into smps are kept for the next call.
+ */
+static int socket_read_xdp(NodeCompat *n, struct Sample *const smps[],
+                           unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+  auto *xs = s->xdp.sock;
+
+  // Block until the RX ring contains frames
+  while (s->xdp.next >= s->xdp.received) {
+    s->xdp.received =
+        xs->receive(s->xdp.addrs, s->xdp.lens, MIN(cnt, SOCKET_XDP_BATCH));
+    s->xdp.next = 0;
+
+    if (s->xdp.received)
+      break;
+
+    if (n->isNonBlocking())
+      return 0;
+
+    struct pollfd pfd = {.fd = s->sd, .events = POLLIN};
+
+    ret = ::poll(&pfd, 1, -1);
+    if (ret < 0) {
+      if (errno == EINTR)
+        return -1;
+
+      throw SystemError("Failed to poll");
+    }
+  }
+
+  unsigned nread = 0, first = s->xdp.next;
+  for (; s->xdp.next < s->xdp.received && nread < cnt; s->xdp.next++) {
+    unsigned i = s->xdp.next;
+    auto *eh = (struct ether_header *)xs->getFrame(s->xdp.addrs[i]);
+
+    if (s->xdp.lens[i] < ETHER_HDR_LEN)
+      continue;
+
+    union sockaddr_union src = {};
+    src.sll.sll_family = AF_PACKET;
+    src.sll.sll_protocol = eh->ether_type;
+    src.sll.sll_ifindex = s->in.saddr.sll.sll_ifindex;
+    src.sll.sll_halen = ETHER_ADDR_LEN;
+    memcpy(src.sll.sll_addr, eh->ether_shost, ETHER_ADDR_LEN);
+
+    bool partial = false;
+
+    ret = socket_read_datagram(n, (char *)(eh + 1),
+                               s->xdp.lens[i] - ETHER_HDR_LEN, &src,
+                               &smps[nread], cnt - nread, &partial);
+    if (partial && nread > 0)
+      break; // Decode the frame again in the next call
+    else if (partial)
+      n->logger->warn("Received frame with more than {} samples", cnt);
+
+    if (ret > 0)
+      nread += ret;
+  }
+
+  // Only the decoded frames are returned to the kernel
+  xs->release(s->xdp.addrs + first, s->xdp.next - first);
+
+  return nread;
+}
+#endif // WITH_SOCKET_LAYER_XDP
+
+int villas::node::socket_read(NodeCompat *n, struct Sample *const smps[],
+                              unsigned cnt) {
+  auto *s = n->getData<struct Socket>();
+
+  ssize_t bytes;
+
+  union sockaddr_union src;
+  socklen_t srclen = sizeof(src);
+
+#ifdef WITH_SOCKET_LAYER_XDP
+  if (s->layer == SocketLayer::XDP)
+    return socket_read_xdp(n, smps, cnt);
+#endif // WITH_SOCKET_LAYER_XDP
+
+#ifdef WITH_IO_URING
+  if (s->io_uring.enabled)
+    return socket_read_io_uring(n, smps, cnt);
+#endif // WITH_IO_URING
+
+  if (s->batch.enabled)
+    return socket_read_batch(n, smps, cnt);
+
+  // Receive next sample
+  bytes = recvfrom(s->sd, s->in.buf, s->in.buflen,
+                   n->isNonBlocking() ? MSG_DONTWAIT : 0, &src.sa, &srclen);
+  if (bytes < 0) {
+    if (errno == EINTR)
+      return -1;
+    else if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return 0;
+
+    throw SystemError("Failed recvfrom()");
+  } else if (bytes == 0)
+    return 0;
+
+  return socket_read_datagram(n, s->in.buf, bytes, &src, smps, cnt);
+}
+
+#ifdef UDP_SEGMENT
+/* Send all datagrams with a single sendmsg() using UDP segmentation offload.
+ *
+ * This is only possible if all but the last datagram have the same size.
+ */
+static int socket_write_gso(NodeCompat *n, unsigned vlen) {
+  auto *s = n->getData<struct Socket>();
+
+  size_t segsz = s->out.iovs[0].iov_len, total = 0;
+
+  for (unsigned i = 0; i < vlen; i++) {
+    if (s->out.iovs[i].iov_len > segsz ||
+        (i < vlen - 1 && s->out.iovs[i].iov_len != segsz))
+      return -1;
+
+    total += s->out.iovs[i].iov_len;
+  }
+
+  if (total > 0xFFFF)
+    return -1;
+
+  uint16_t gso_size = segsz;
+  struct msghdr hdr = {};
+
+  hdr.msg_name = &s->out.saddr;
+  hdr.msg_namelen = socket_addrlen(&s->out.saddr);
+  hdr.msg_iov = s->out.iovs;
+  hdr.msg_iovlen = vlen;
+  hdr.msg_control = s->out.ctrl;
+  hdr.msg_controllen = CMSG_SPACE(sizeof(gso_size));
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(gso_size));
+  memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+  ssize_t bytes = sendmsg(s->sd, &hdr, 0);
+  if (bytes < 0) {
+    n->logger->warn("Failed sendmsg() with UDP GSO: {}", strerror(errno));
+    return -1;
+  }
+
+  return vlen;
+}
+#endif // UDP_SEGMENT
+
+/* Format one sample per slot and prepare a message header for each of them.
+ *
+ * Stops at the first sample which can not be formatted.
+ *
+ * @return The number of prepared messages.
+ */
+static unsigned socket_write_prepare(NodeCompat *n,
+                                     struct Sample *const smps[],
+                                     unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  unsigned vlen = 0;
+
+  for (unsigned i = 0; i < cnt; i++) {
+    char *buf = s->out.buf + vlen * s->out.buflen;
+    size_t wbytes = 0;
+
+    ret = s->formatter->sprint(buf, s->out.buflen, &wbytes, &smps[i], 1);
+    if (ret < 0 || wbytes == 0 || wbytes > s->out.buflen) {
+      n->logger->warn("Failed to format payload: reason={}, wbytes={}", ret,
+                      wbytes);
+      break;
+    }
+
+    struct msghdr *hdr = &s->out.msgs[vlen].msg_hdr;
+
+    s->out.iovs[vlen].iov_base = buf;
+    s->out.iovs[vlen].iov_len = wbytes;
+
+    hdr->msg_name = &s->out.saddr;
+    hdr->msg_namelen = socket_addrlen(&s->out.saddr);
+    hdr->msg_iov = &s->out.iovs[vlen];
+    hdr->msg_iovlen = 1;
+    hdr->msg_control = nullptr;
+    hdr->msg_controllen = 0;
+
+    vlen++;
+  }
+
+  return vlen;
+}
+
+// Send one datagram per sample with a single sendmmsg()
+static int socket_write_batch(NodeCompat *n, struct Sample *const smps[],
+                              unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  unsigned vlen = socket_write_prepare(n, smps, MIN(cnt, s->out.slots));
+  if (vlen == 0 && cnt > 0)
+    return -1;
+
+#ifdef UDP_SEGMENT
+  if (s->batch.gso && vlen > 1 && socket_write_gso(n, vlen) > 0)
+    return vlen;
+#endif // UDP_SEGMENT
+
+  unsigned off = 0;
+  while (off < vlen) {
+    ret = sendmmsg(s->sd, &s->out.msgs[off], vlen - off, 0);
+    if (ret < 0) {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        n->logger->warn("Blocking sendmmsg()");
+        continue;
+      }
+
+      n->logger->warn("Failed sendmmsg(): {}", strerror(errno));
+      break;
+    }
+
+    off += ret;
+  }
+
+  return vlen;
+}
+
+#ifdef WITH_IO_URING
+// Submit one sendmsg() request per sample with a single syscall
+static int socket_write_io_uring(NodeCompat *n, struct Sample *const smps[],
+                                 unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+
+  struct io_uring *ring = &s->io_uring.out;
+  struct io_uring_cqe *cqe;
+
+  // The send buffers can only be reused after the previous batch completed
+  while (s->io_uring.inflight > 0) {
+    ret = io_uring_wait_cqe(ring, &cqe);
+    if (ret < 0) {
+      if (ret == -EINTR)
+        continue;
+
+      errno = -ret;
+      throw SystemError("Failed to wait for send completions");
+    }
+
+    if (cqe->res < 0)
+      n->logger->warn("Failed to send: {}", strerror(-cqe->res));
+
+    io_uring_cqe_seen(ring, cqe);
+    s->io_uring.inflight--;
+  }
+
+  unsigned vlen = socket_write_prepare(n, smps, MIN(cnt, s->out.slots));
+  if (vlen == 0 && cnt > 0)
+    return -1;
+
+  unsigned sent;
+  for (sent = 0; sent < vlen; sent++) {
+    auto *sqe = io_uring_get_sqe(ring);
+    if (!sqe)
+      break;
+
+    io_uring_prep_sendmsg(sqe, s->sd, &s->out.msgs[sent].msg_hdr, 0);
+    s->io_uring.inflight++;
+  }
+
+  ret = io_uring_submit(ring);
+  if (ret < 0) {
+    errno = -ret;
+    throw SystemError("Failed to submit send requests");
+  }
+
+  return sent;
+}
+#endif // WITH_IO_URING
+
+#ifdef WITH_SOCKET_LAYER_XDP
+// Format samples directly into UMEM frames and pass them to the TX ring
+static int socket_write_xdp(NodeCompat *n, struct Sample *const smps[],
+                            unsigned cnt) {
+  int ret;
+  auto *s = n->getData<struct Socket>();
+  auto *xs = s->xdp.sock;
+
+  uint64_t addrs[SOCKET_XDP_BATCH];
+  uint32_t lens[SOCKET_XDP_BATCH];
+
+  size_t maxlen = MIN(xs->getFrameSize(), s->xdp.mtu + ETHER_HDR_LEN);
+
+  unsigned sent = 0, frames = 0;
+  while (sent < cnt && frames < SOCKET_XDP_BATCH) {
+    if (!xs->allocate(&addrs[frames], 1)) {
+      n->logger->warn("No free frames in AF_XDP TX ring");
+      break;
+    }
+
+    auto *eh = (struct ether_header *)xs->getFrame(addrs[frames]);
+    size_t wbytes;
+
+    memcpy(eh->ether_dhost, s->out.saddr.sll.sll_addr, ETHER_ADDR_LEN);
+    memcpy(eh->ether_shost, s->xdp.mac, ETHER_ADDR_LEN);
+    eh->ether_type = s->out.saddr.sll.sll_protocol;
+
+    // A frame carries as many samples as fit
+    ret = s->formatter->sprint((char *)(eh + 1), maxlen - ETHER_HDR_LEN,
+                               &wbytes, &smps[sent], cnt - sent);
+    if (ret <= 0) {
+      n->logger->warn("Failed to format payload: reason={}", ret);
+
+      xs->discard(&addrs[frames], 1);
+      break;
+    }
+
+    lens[frames++] = ETHER_HDR_LEN + wbytes;
+    sent += ret;
+  }
+
+  xs->send(addrs, lens, frames);
+
+  return sent;
+}
+#endif // WITH_SOCKET_LAYER_XDP
+
 int villas::node::socket_write(NodeCompat *n, struct Sample *const smps[],
                                unsigned cnt) {
   auto *s = n->getData<struct Socket>();
 
   int ret;
   ssize_t bytes;
-  size_t wbytes;
+  size_t wbytes, iovcnt;
+
+#ifdef WITH_IO_URING
+  if (s->io_uring.enabled)
+    return socket_write_io_uring(n, smps, cnt);
+#endif // WITH_IO_URING
+
+  if (s->batch.enabled)
+    return socket_write_batch(n, smps, cnt);
 
 retry:
-  ret = s->formatter->sprint(s->out.buf, s->out.buflen, &wbytes, smps, cnt);
+  iovcnt = s->out.slots;
+  ret = s->formatter->sprintv(s->out.buf, s->out.buflen, &wbytes, s->out.iovs,
+                              &iovcnt, smps, cnt);
   if (ret < 0) {
     n->logger->warn("Failed to format payload: reason={}", ret);
     return ret;
@@ -420,45 +1339,34 @@ retry:
     goto retry;
   }
 
-  // Send message
-  socklen_t addrlen = 0;
-  switch (s->in.saddr.ss.ss_family) {
-  case AF_INET:
-    addrlen = sizeof(struct sockaddr_in);
-    break;
+  /* Send message
+   *
+   * The payload might reference the sample data directly. Hence we use
+   * sendmsg() to avoid copying it into a contiguous buffer.
+   */
+  struct msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
 
-  case AF_INET6:
-    addrlen = sizeof(struct sockaddr_in6);
-    break;
-
-  case AF_UNIX:
-    addrlen = SUN_LEN(&s->out.saddr.sun);
-    break;
-
-#ifdef WITH_SOCKET_LAYER_ETH
-  case AF_PACKET:
-    addrlen = sizeof(struct sockaddr_ll);
-    break;
-#endif // WITH_SOCKET_LAYER_ETH
-  default:
-    addrlen = sizeof(s->in.saddr);
-  }
+  hdr.msg_name = &s->out.saddr;
+  hdr.msg_namelen = socket_addrlen(&s->out.saddr);
+  hdr.msg_iov = s->out.iovs;
+  hdr.msg_iovlen = iovcnt;
 
 retry2:
-  bytes = sendto(s->sd, s->out.buf, wbytes, 0, (struct sockaddr *)&s->out.saddr,
-                 addrlen);
+  bytes = sendmsg(s->sd, &hdr, 0);
   if (bytes < 0) {
     if ((errno == EPERM) || (errno == ENOENT && s->layer == SocketLayer::UNIX))
-      n->logger->warn("Failed sendto(): {}", strerror(errno));
+      n->logger->warn("Failed sendmsg(): {}", strerror(errno));
     else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-      n->logger->warn("Blocking sendto()");
+      n->logger->warn("Blocking sendmsg()");
       goto retry2;
     } else
-      n->logger->warn("Failed sendto(): {}", strerror(errno));
+      n->logger->warn("Failed sendmsg(): {}", strerror(errno));
   } else if ((size_t)bytes < wbytes)
-    n->logger->warn("Partial sendto()");
+    n->logger->warn("Partial sendmsg()");
 
-  return cnt;
+  // The formatter might not reference all samples due to the limit of slots
+  return ret;
 }
 
 int villas::node::socket_parse(NodeCompat *n, json_t *json) {
@@ -471,16 +1379,23 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json) {
   json_error_t err;
   json_t *json_multicast = nullptr;
   json_t *json_format = nullptr;
+  json_t *json_batch = nullptr;
+  json_t *json_xdp = nullptr;
+
+  const char *io_engine = nullptr;
 
   // Default values
   s->layer = SocketLayer::UDP;
   s->verify_source = 0;
 
   ret = json_unpack_ex(
-      json, &err, 0, "{ s?: s, s?: o, s: { s: s }, s: { s: s, s?: b, s?: o } }",
-      "layer", &layer, "format", &json_format, "out", "address", &remote, "in",
-      "address", &local, "verify_source", &s->verify_source, "multicast",
-      &json_multicast);
+      json, &err, 0,
+      "{ s?: s, s?: o, s?: o, s?: s, s?: o, s: { s: s }, s: { s: s, s?: b, "
+      "s?: o } }",
+      "layer", &layer, "format", &json_format, "batch", &json_batch,
+      "io_engine", &io_engine, "xdp", &json_xdp, "out", "address", &remote,
+      "in", "address", &local, "verify_source", &s->verify_source,
+      "multicast", &json_multicast);
   if (ret)
     throw ConfigError(json, err, "node-config-node-socket");
 
@@ -501,6 +1416,10 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json) {
     else if (!strcmp(layer, "eth"))
       s->layer = SocketLayer::ETH;
 #endif // WITH_SOCKET_LAYER_ETH
+#ifdef WITH_SOCKET_LAYER_XDP
+    else if (!strcmp(layer, "xdp"))
+      s->layer = SocketLayer::XDP;
+#endif // WITH_SOCKET_LAYER_XDP
     else if (!strcmp(layer, "udp"))
       s->layer = SocketLayer::UDP;
     else if (!strcmp(layer, "unix") || !strcmp(layer, "local"))
@@ -552,6 +1471,58 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json) {
     }
   }
 
+  if (io_engine) {
+    if (!strcmp(io_engine, "io_uring")) {
+#ifdef WITH_IO_URING
+      s->io_uring.enabled = 1;
+#else
+      n->logger->warn("VILLASnode has been built without io_uring support. "
+                      "Falling back to regular sockets.");
+#endif // WITH_IO_URING
+    } else if (strcmp(io_engine, "socket"))
+      throw ConfigError(json, "node-config-node-socket-io-engine",
+                        "Invalid I/O engine '{}'", io_engine);
+  }
+
+#ifdef WITH_SOCKET_LAYER_XDP
+  if (json_xdp) {
+    const char *mode = nullptr;
+
+    ret = json_unpack_ex(json_xdp, &err, 0, "{ s?: i, s?: s, s?: i, s?: i }",
+                         "queue", &s->xdp.queue, "mode", &mode, "frames",
+                         &s->xdp.frames, "frame_size", &s->xdp.frame_size);
+    if (ret)
+      throw ConfigError(json_xdp, err, "node-config-node-socket-xdp",
+                        "Failed to parse XDP settings");
+
+    if (mode) {
+      if (!strcmp(mode, "auto"))
+        s->xdp.mode = kernel::XdpSocket::Mode::AUTO;
+      else if (!strcmp(mode, "zerocopy"))
+        s->xdp.mode = kernel::XdpSocket::Mode::ZEROCOPY;
+      else if (!strcmp(mode, "copy"))
+        s->xdp.mode = kernel::XdpSocket::Mode::COPY;
+      else
+        throw ConfigError(json_xdp, "node-config-node-socket-xdp-mode",
+                          "Invalid XDP mode '{}'", mode);
+    }
+  }
+#endif // WITH_SOCKET_LAYER_XDP
+
+  if (json_batch) {
+    // Default values
+    s->batch.enabled = true;
+    s->batch.gso = 0;
+    s->batch.gro = 0;
+
+    ret = json_unpack_ex(json_batch, &err, 0, "{ s?: b, s?: b, s?: b }",
+                         "enabled", &s->batch.enabled, "gso", &s->batch.gso,
+                         "gro", &s->batch.gro);
+    if (ret)
+      throw ConfigError(json_batch, err, "node-config-node-socket-batch",
+                        "Failed to parse batch settings");
+  }
+
   return 0;
 }
 
@@ -563,6 +1534,21 @@ int villas::node::socket_fds(NodeCompat *n, int fds[]) {
   return 1;
 }
 
+int villas::node::socket_poll_fds(NodeCompat *n, int fds[]) {
+#ifdef WITH_IO_URING
+  auto *s = n->getData<struct Socket>();
+
+  // The ring becomes readable as soon as receive completions are pending
+  if (s->io_uring.enabled) {
+    fds[0] = s->io_uring.in.ring_fd;
+
+    return 1;
+  }
+#endif // WITH_IO_URING
+
+  return socket_fds(n, fds);
+}
+
 __attribute__((constructor(110))) static void register_plugin() {
   p.name = "socket";
 #ifdef WITH_NETEM
@@ -572,6 +1558,7 @@ __attribute__((constructor(110))) static void register_plugin() {
   p.description = "BSD network sockets for Ethernet / IP / UDP";
 #endif
   p.vectorize = 0;
+  p.flags = (int)NodeFactory::Flags::SUPPORTS_NONBLOCKING;
   p.size = sizeof(struct Socket);
   p.type.start = socket_type_start;
   p.reverse = socket_reverse;
@@ -584,6 +1571,6 @@ __attribute__((constructor(110))) static void register_plugin() {
   p.stop = socket_stop;
   p.read = socket_read;
   p.write = socket_write;
-  p.poll_fds = socket_fds;
+  p.poll_fds = socket_poll_fds;
   p.netem_fds = socket_fds;
 }
@@ -12,9 +12,11 @@
 #include <map>
 
 #include <poll.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 
 #include <villas/colors.hpp>
+#include <villas/executor.hpp>
 #include <villas/hook.hpp>
 #include <villas/hook_list.hpp>
 #include <villas/kernel/rt.hpp>
@@ -31,13 +33,25 @@
 #include <villas/utils.hpp>
 #include <villas/uuid.hpp>
 
+#ifdef WITH_IO_URING
+#include <liburing.h>
+#endif // WITH_IO_URING
+
 using namespace villas;
 using namespace villas::node;
 
 void *Path::runWrapper(void *arg) {
   auto *p = (Path *)arg;
 
-  return p->poll ? p->runPoll() : p->runSingle();
+  if (!p->poll)
+    return p->runSingle();
+
+#ifdef WITH_IO_URING
+  if (p->io_engine == IoEngine::IO_URING)
+    return p->runIoUring();
+#endif // WITH_IO_URING
+
+  return p->runPoll();
 }
 
 /* Main thread function per path:
@@ -55,7 +69,7 @@ void *Path::runSingle() {
   while (state == State::STARTED) {
     pthread_testcancel();
 
-    ret = ps->read(0);
+    ret = wait_mode == WaitMode::BLOCK ? ps->read(0) : readSingle(ps);
     if (ret <= 0)
       continue;
 
@@ -74,31 +88,167 @@ void *Path::runSingle() {
  */
 void *Path::runPoll() {
   while (state == State::STARTED) {
-    int ret = ::poll(pfds.data(), pfds.size(), -1);
+    int ret = wait_mode == WaitMode::BLOCK ? ::poll(pfds.data(), pfds.size(), -1)
+                                           : waitPoll();
     if (ret < 0)
       throw SystemError("Failed to poll");
 
     logger->debug("Returned from poll(2): ret={}", ret);
 
     for (unsigned i = 0; i < pfds.size(); i++) {
-      auto &pfd = pfds[i];
+      if (pfds[i].revents & POLLIN)
+        readPollFD(i);
+    }
 
-      if (pfd.revents & POLLIN) {
-        // Timeout: re-enqueue the last sample
-        if (pfd.fd == timeout.getFD()) {
-          timeout.wait();
+    for (auto pd : destinations)
+      pd->write();
+  }
 
-          last_sample->sequence = last_sequence++;
+  return nullptr;
+}
 
-          PathDestination::enqueueAll(this, &last_sample, 1);
-        }
-        // A source is ready to receive samples
-        else {
-          auto ps = sources[i];
+/* Busy-poll the single source of the path with non-blocking reads.
+ *
+ * In adaptive mode, we fall back to a blocking read after the spin budget
+ * has been exhausted.
+ */
+int Path::readSingle(PathSource::Ptr ps) {
+  int ret;
+  auto *n = ps->getNode();
+  struct timespec start = time_now(), now;
 
-          ps->read(i);
-        }
+  do {
+    pthread_testcancel();
+
+    ret = ps->read(0);
+    now = time_now();
+
+    if (ret != 0) {
+      recordWait(Stats::Metric::WAIT_SPIN, time_delta(&start, &now));
+      return ret;
+    }
+  } while (wait_mode == WaitMode::SPIN ||
+           time_delta(&start, &now) < spin_budget);
+
+  recordWait(Stats::Metric::WAIT_SPIN, time_delta(&start, &now));
+
+  n->setNonBlocking(false);
+  ret = ps->read(0);
+  n->setNonBlocking(true);
+
+  start = time_now();
+  recordWait(Stats::Metric::WAIT_SLEEP, time_delta(&now, &start));
+
+  return ret;
+}
+
+/* Busy-poll the pfds list before sleeping in poll(2).
+ *
+ * Spinning uses poll(2) with a zero timeout. This still requires a syscall,
+ * but avoids putting the thread to sleep and the latency of waking it up.
+ */
+int Path::waitPoll() {
+  int ret;
+  struct timespec start = time_now(), now;
+
+  do {
+    pthread_testcancel();
+
+    ret = ::poll(pfds.data(), pfds.size(), 0);
+    now = time_now();
+
+    if (ret != 0) {
+      recordWait(Stats::Metric::WAIT_SPIN, time_delta(&start, &now));
+      return ret;
+    }
+  } while (wait_mode == WaitMode::SPIN ||
+           time_delta(&start, &now) < spin_budget);
+
+  recordWait(Stats::Metric::WAIT_SPIN, time_delta(&start, &now));
+
+  ret = ::poll(pfds.data(), pfds.size(), -1);
+
+  start = time_now();
+  recordWait(Stats::Metric::WAIT_SLEEP, time_delta(&now, &start));
+
+  return ret;
+}
+
+#ifdef WITH_IO_URING
+// Submit a poll request for the i-th entry of the pfds list.
+static void path_io_uring_arm(struct io_uring *ring, struct pollfd *pfd,
+                              unsigned i) {
+  auto *sqe = io_uring_get_sqe(ring);
+  if (!sqe)
+    throw RuntimeError("io_uring submission queue is full");
+
+  /* We use one-shot instead of multishot poll requests here.
+   * Multishot requests only complete on new wake-ups, which would stall
+   * sources whose read() does not drain all pending data at once.
+   */
+  io_uring_prep_poll_add(sqe, pfd->fd, POLLIN);
+  io_uring_sqe_set_data64(sqe, i);
+}
+
+/* Main thread function per path:
+ *     read samples from source -> write samples to destinations
+ *
+ * This variant of the path waits for all path sources using an io_uring.
+ * Re-armed poll requests are submitted together with the wait, so that
+ * each iteration requires only a single syscall and handles all ready
+ * sources in one batch.
+ */
+void *Path::runIoUring() {
+  int ret;
+  unsigned head, cnt;
+  struct io_uring_cqe *cqe;
+
+  std::vector<bool> ready(pfds.size());
+
+  /* io_uring_enter(2) is not a cancellation point.
+   * So we wake up periodically to check if the path has been stopped.
+   */
+  struct __kernel_timespec ts = {.tv_sec = 0, .tv_nsec = 100000000};
+
+  while (state == State::STARTED) {
+    pthread_testcancel();
+
+    ret = io_uring_submit_and_wait_timeout(ring, &cqe, 1, &ts, nullptr);
+    if (ret < 0) {
+      if (ret == -EINTR || ret == -ETIME)
+        continue;
+
+      errno = -ret;
+      throw SystemError("Failed to wait for io_uring completions");
+    }
+
+    cnt = 0;
+    io_uring_for_each_cqe(ring, head, cqe) {
+      auto i = io_uring_cqe_get_data64(cqe);
+
+      if (cqe->res < 0) {
+        errno = -cqe->res;
+        throw SystemError("Failed to poll");
       }
+
+      if (cqe->res & POLLIN)
+        ready[i] = true;
+
+      cnt++;
+    }
+
+    io_uring_cq_advance(ring, cnt);
+
+    logger->debug("Reaped {} io_uring completions", cnt);
+
+    for (unsigned i = 0; i < pfds.size(); i++) {
+      if (!ready[i])
+        continue;
+
+      ready[i] = false;
+
+      readPollFD(i);
+      path_io_uring_arm(ring, &pfds[i], i);
     }
 
     for (auto pd : destinations)
@@ -107,12 +257,55 @@ void *Path::runPoll() {
 
   return nullptr;
 }
+#endif // WITH_IO_URING
+
+void Path::runOnce() {
+  struct epoll_event evs[16];
+
+  /* Sources which do not fit into evs remain ready and will be handled
+   * in the next step after the executor has re-armed the path.
+   */
+  int ret = epoll_wait(epoll_fd, evs, ARRAY_LEN(evs), 0);
+  if (ret < 0) {
+    if (errno == EINTR)
+      return;
+
+    throw SystemError("Failed to wait for sources of path {}",
+                      this->toString());
+  }
+
+  for (int i = 0; i < ret; i++)
+    readPollFD(evs[i].data.u32);
+
+  for (auto pd : destinations)
+    pd->write();
+}
+
+void Path::readPollFD(unsigned i) {
+  // Timeout: re-enqueue the last sample
+  if (pfds[i].fd == timeout.getFD()) {
+    timeout.wait();
+
+    last_sample->sequence = last_sequence++;
+
+    PathDestination::enqueueAll(this, &last_sample, 1);
+  }
+  // A source is ready to receive samples
+  else {
+    auto ps = sources[i];
+
+    ps->read(i);
+  }
+}
 
 Path::Path()
-    : state(State::INITIALIZED), mode(Mode::ANY), timeout(CLOCK_MONOTONIC),
+    : state(State::INITIALIZED), mode(Mode::ANY), io_engine(IoEngine::POLL),
+      wait_mode(WaitMode::BLOCK), spin_budget(100e-6), spin_time(0),
+      sleep_time(0), ring(nullptr), executor(nullptr), epoll_fd(-1), timeout(CLOCK_MONOTONIC),
       rate(0), // Disabled
       affinity(0), enabled(true), poll(-1), reversed(false), builtin(true),
-      original_sequence_no(-1), queuelen(DEFAULT_QUEUE_LENGTH),
+      original_sequence_no(-1), queuelen(DEFAULT_QUEUE_LENGTH), pool_cache(0),
+      trace(false), trace_period(1e-9),
       logger(Log::get(fmt::format("path:{}", id++))) {
   uuid_clear(uuid);
 
@@ -148,6 +341,60 @@ void Path::startPoll() {
 
     pfds.push_back(pfd);
   }
+
+#ifdef WITH_IO_URING
+  if (io_engine == IoEngine::IO_URING) {
+    int ret;
+
+    ring = new struct io_uring;
+
+    ret = io_uring_queue_init(std::max<unsigned>(pfds.size(), 8), ring, 0);
+    if (ret < 0) {
+      delete ring;
+      ring = nullptr;
+
+      errno = -ret;
+      throw SystemError("Failed to setup io_uring for path {}",
+                        this->toString());
+    }
+
+    for (unsigned i = 0; i < pfds.size(); i++)
+      path_io_uring_arm(ring, &pfds[i], i);
+  }
+#endif // WITH_IO_URING
+
+  if (executor) {
+    int ret;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0)
+      throw SystemError("Failed to create epoll instance for path {}",
+                        this->toString());
+
+    for (unsigned i = 0; i < pfds.size(); i++) {
+      struct epoll_event ev = {.events = EPOLLIN, .data = {.u32 = i}};
+
+      ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pfds[i].fd, &ev);
+      if (ret)
+        throw SystemError("Failed to add file descriptor to epoll instance");
+    }
+  }
+}
+
+void Path::stopPoll() {
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+
+#ifdef WITH_IO_URING
+  if (ring) {
+    io_uring_queue_exit(ring);
+
+    delete ring;
+    ring = nullptr;
+  }
+#endif // WITH_IO_URING
 }
 
 void Path::prepare(NodeList &nodes) {
@@ -255,7 +502,15 @@ void Path::prepare(NodeList &nodes) {
     i++;
   }
 
-  // Prepare path destinations
+  /* Prepare path destinations
+   *
+   * Each PathDestination owns its queue and belongs to exactly one path.
+   * The only producer is this path in PathDestination::enqueueAll() and the
+   * only consumer is the writer of this destination in
+   * PathDestination::write(). Hence we can use the single-producer,
+   * single-consumer mode, regardless of how many paths write to the node.
+   */
+  int queue_flags = (int)QueueFlags::SPSC;
   int mt_cnt = 0;
   for (auto pd : destinations) {
     auto *pd_mt = pd->node->getMemoryType();
@@ -268,7 +523,7 @@ void Path::prepare(NodeList &nodes) {
       mt_cnt++;
     }
 
-    ret = pd->prepare(queuelen);
+    ret = pd->prepare(queuelen, queue_flags);
     if (ret)
       throw RuntimeError("Failed to prepare path destination {} of path {}",
                          pd->node->getName(), this->toString());
@@ -284,10 +539,27 @@ void Path::prepare(NodeList &nodes) {
       poll = 1;
     else if (sources.size() > 1)
       poll = 1;
+    else if (executor && sources.size() == 1 &&
+             sources.front()->getNode()->getFactory()->getFlags() &
+                 (int)NodeFactory::Flags::SUPPORTS_POLL)
+      poll = 1; // The executor can only wait for pollable sources
     else
       poll = 0;
   }
 
+  // Paths which block in their sources or spin keep their own thread
+  if (executor &&
+      (poll == 0 || io_engine == IoEngine::IO_URING ||
+       wait_mode != WaitMode::BLOCK)) {
+    logger->info("Path {} is not run by the executor as it {}",
+                 this->toString(),
+                 poll == 0                           ? "does not use polling"
+                 : io_engine == IoEngine::IO_URING ? "uses io_uring"
+                                                     : "busy-polls");
+
+    executor = nullptr;
+  }
+
 #ifdef WITH_HOOKS
   // Prepare path hooks
   int m = builtin ? (int)Hook::Flags::PATH | (int)Hook::Flags::BUILTIN : 0;
@@ -306,6 +578,45 @@ void Path::prepare(NodeList &nodes) {
     throw RuntimeError("Failed to initialize pool of path: {}",
                        this->toString());
 
+  if (pool_cache > 0) {
+    /* All workers of the executor may run this path and touch its pools.
+     * Threads of destination nodes which release queued samples are not
+     * known here and must be covered by the queuelen of the path. */
+    unsigned threads = executor ? executor->getWorkerCount() : 1;
+
+    ret = pool_cache_enable(&pool, pool_cache, threads);
+    if (ret)
+      logger->warn("Disabling pool cache of path {}: the pool is too small "
+                   "for {} threads with a magazine size of {}",
+                   this->toString(), threads, pool_cache);
+
+    for (auto ps : sources) {
+      ret = pool_cache_enable(&ps->pool, pool_cache, threads);
+      if (ret)
+        logger->warn("Disabling pool cache of source {} of path {}: the pool "
+                     "is too small for {} threads with a magazine size of {}",
+                     ps->node->getName(), this->toString(), threads,
+                     pool_cache);
+    }
+  }
+
+  if (trace || wait_mode != WaitMode::BLOCK)
+    stats = std::make_shared<Stats>(20, 500);
+
+  if (trace) {
+
+#ifdef __x86_64__
+    ret = tsc_init(&tsc);
+    if (ret || !tsc.is_invariant || !tsc.frequency) {
+      logger->warn("No invariant TSC available. Using clock_gettime() for "
+                   "tracing path {}",
+                   this->toString());
+      tsc.frequency = 0;
+    } else
+      trace_period = 1.0 / tsc.frequency;
+#endif
+  }
+
   logger->debug("Prepared path {} with {} output signals:", this->toString(),
                 osigs->size());
   if (logger->level() <= spdlog::level::debug)
@@ -317,7 +628,7 @@ void Path::prepare(NodeList &nodes) {
 }
 
 void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid) {
-  int ret, en = -1, rev = -1;
+  int ret, en = -1, rev = -1, trace_en = -1;
 
   json_error_t err;
   json_t *json_in;
@@ -327,16 +638,22 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid) {
 
   const char *mode_str = nullptr;
   const char *uuid_str = nullptr;
+  const char *io_engine_str = nullptr;
+  const char *wait_str = nullptr;
 
   ret = json_unpack_ex(json, &err, 0,
                        "{ s: o, s?: o, s?: o, s?: b, s?: b, s?: b, s?: i, s?: "
-                       "s, s?: b, s?: F, s?: o, s?: b, s?: s, s?: i }",
+                       "s, s?: b, s?: F, s?: o, s?: b, s?: s, s?: i, s?: i, "
+                       "s?: s, s?: s, s?: F, s?: b }",
                        "in", &json_in, "out", &json_out, "hooks", &json_hooks,
                        "reverse", &rev, "enabled", &en, "builtin", &builtin,
                        "queuelen", &queuelen, "mode", &mode_str, "poll", &poll,
                        "rate", &rate, "mask", &json_mask,
                        "original_sequence_no", &original_sequence_no, "uuid",
-                       &uuid_str, "affinity", &affinity);
+                       &uuid_str, "affinity", &affinity, "pool_cache",
+                       &pool_cache, "io_engine", &io_engine_str, "wait",
+                       &wait_str, "spin_budget", &spin_budget, "trace",
+                       &trace_en);
   if (ret)
     throw ConfigError(json, err, "node-config-path",
                       "Failed to parse path configuration");
@@ -347,6 +664,9 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid) {
   if (rev >= 0)
     reversed = rev != 0;
 
+  if (trace_en >= 0)
+    trace = trace_en != 0;
+
   // Optional settings
   if (mode_str) {
     if (!strcmp(mode_str, "any"))
@@ -358,6 +678,34 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid) {
                         mode_str);
   }
 
+  if (io_engine_str) {
+    if (!strcmp(io_engine_str, "poll"))
+      io_engine = IoEngine::POLL;
+    else if (!strcmp(io_engine_str, "io_uring")) {
+#ifdef WITH_IO_URING
+      io_engine = IoEngine::IO_URING;
+#else
+      logger->warn("VILLASnode has been built without io_uring support. "
+                   "Falling back to poll.");
+      io_engine = IoEngine::POLL;
+#endif // WITH_IO_URING
+    } else
+      throw ConfigError(json, "node-config-path-io-engine",
+                        "Invalid I/O engine '{}'", io_engine_str);
+  }
+
+  if (wait_str) {
+    if (!strcmp(wait_str, "block"))
+      wait_mode = WaitMode::BLOCK;
+    else if (!strcmp(wait_str, "spin"))
+      wait_mode = WaitMode::SPIN;
+    else if (!strcmp(wait_str, "adaptive"))
+      wait_mode = WaitMode::ADAPTIVE;
+    else
+      throw ConfigError(json, "node-config-path-wait", "Invalid wait mode '{}'",
+                        wait_str);
+  }
+
   // UUID
   if (uuid_str) {
     ret = uuid_parse(uuid_str, uuid);
@@ -445,6 +793,21 @@ void Path::check() {
     throw RuntimeError("Setting 'rate' of path {} must be a positive number.",
                        this->toString());
 
+  if (pool_cache < 0)
+    throw RuntimeError(
+        "Setting 'pool_cache' of path {} must be a positive number.",
+        this->toString());
+
+  if (spin_budget < 0)
+    throw RuntimeError(
+        "Setting 'spin_budget' of path {} must be a positive number.",
+        this->toString());
+
+  if (wait_mode != WaitMode::BLOCK && io_engine == IoEngine::IO_URING)
+    throw RuntimeError("Setting 'wait' of path {} can not be combined with the "
+                       "io_uring I/O engine",
+                       this->toString());
+
   if (!IS_POW2(queuelen)) {
     queuelen = LOG2_CEIL(queuelen);
     logger->warn("Queue length should always be a power of 2. Adjusting to {}",
@@ -469,6 +832,17 @@ void Path::checkPrepared() {
     if (rate > 0)
       throw RuntimeError("Setting 'poll' must be activated when used together "
                          "with setting 'rate'");
+
+    // Check that the source can be busy-polled
+    if (wait_mode != WaitMode::BLOCK) {
+      auto *n = sources.front()->getNode();
+
+      if (!(n->getFactory()->getFlags() &
+            (int)NodeFactory::Flags::SUPPORTS_NONBLOCKING))
+        throw RuntimeError("Node {} does not support non-blocking reads which "
+                           "are required for setting 'wait' of path {}",
+                           n->getName(), this->toString());
+    }
   } else {
     if (rate <= 0) {
       // Check that all path sources provide a file descriptor for polling if fixed rate is disabled
@@ -487,7 +861,11 @@ void Path::start() {
   int ret;
   const char *mode_str;
 
-  assert(state == State::PREPARED);
+  /* Stopped paths can be started again via the API. Path::stop() releases
+   * all resources which are acquired here. Samples which have been queued
+   * for the destinations before are dropped by Path::stop().
+   */
+  assert(state == State::PREPARED || state == State::STOPPED);
 
   switch (mode) {
   case Mode::ANY:
@@ -504,11 +882,16 @@ void Path::start() {
   }
 
   logger->info("Starting path {}: #signals={}/{}, #hooks={}, #sources={}, "
-               "#destinations={}, mode={}, poll={}, mask=0b{:b}, rate={}, "
+               "#destinations={}, mode={}, poll={}, io_engine={}, "
+               "executor={}, wait={}, trace={}, mask=0b{:b}, rate={}, "
                "enabled={}, reversed={}, queuelen={}, original_sequence_no={}",
                this->toString(), signals->size(), getOutputSignals()->size(),
                hooks.size(), sources.size(), destinations.size(), mode_str,
-               poll ? "yes" : "no", mask.to_ullong(), rate,
+               poll ? "yes" : "no",
+               io_engine == IoEngine::IO_URING ? "io_uring" : "poll",
+               executor ? "yes" : "no", waitModeToString(wait_mode),
+               trace ? "yes" : "no",
+               mask.to_ullong(), rate,
                isEnabled() ? "yes" : "no", isReversed() ? "yes" : "no",
                queuelen, original_sequence_no ? "yes" : "no");
 
@@ -538,9 +921,25 @@ void Path::start() {
 
   if (poll > 0)
     startPoll();
+  else if (wait_mode != WaitMode::BLOCK)
+    sources.front()->getNode()->setNonBlocking(true);
+
+  spin_time = 0;
+  sleep_time = 0;
 
   state = State::STARTED;
 
+  // The steps of the path are run by the workers of the executor
+  if (executor) {
+    if (affinity)
+      logger->warn("Setting 'affinity' of path {} is ignored as it is run by "
+                   "the executor",
+                   this->toString());
+
+    executor->add(this);
+    return;
+  }
+
   /* Start one thread per path for sending to destinations
    *
    * Special case: If the path only has a single source and this source
@@ -566,24 +965,53 @@ void Path::stop() {
   if (state != State::STOPPING)
     state = State::STOPPING;
 
-  /* Cancel the thread in case is currently in a blocking syscall.
-   *
-   * We dont care if the thread has already been terminated.
+  /* Paths which are run by the executor have no thread. We wait until no
+   * worker executes the path anymore before closing its epoll instance.
    */
-  ret = pthread_cancel(tid);
-  if (ret && ret != ESRCH)
-    throw RuntimeError("Failed to cancel path thread");
+  if (executor)
+    executor->remove(this);
+  else {
+    /* Cancel the thread in case is currently in a blocking syscall.
+     *
+     * We dont care if the thread has already been terminated.
+     */
+    ret = pthread_cancel(tid);
+    if (ret && ret != ESRCH)
+      throw RuntimeError("Failed to cancel path thread");
+
+    ret = pthread_join(tid, nullptr);
+    if (ret)
+      throw RuntimeError("Failed to join path thread");
+  }
 
-  ret = pthread_join(tid, nullptr);
-  if (ret)
-    throw RuntimeError("Failed to join path thread");
+  if (poll > 0)
+    stopPoll();
+  else if (wait_mode != WaitMode::BLOCK)
+    sources.front()->getNode()->setNonBlocking(false);
 
 #ifdef WITH_HOOKS
   hooks.stop();
 #endif // WITH_HOOKS
 
+  // A restarted path must not send stale samples
+  for (auto pd : destinations)
+    pd->drain();
+
   sample_decref(last_sample);
 
+  if (pool_cache > 0) {
+    size_t hits, misses;
+
+    getPoolCacheCounters(hits, misses);
+
+    logger->info("Pool cache of path {}: hits={}, misses={}", this->toString(),
+                 hits, misses);
+  }
+
+  if (wait_mode != WaitMode::BLOCK)
+    logger->info("Wait times of path {}: spin={:.6f} s, sleep={:.6f} s",
+                 this->toString(), spin_time, sleep_time);
+
   state = State::STOPPED;
 }
 
@@ -665,6 +1093,9 @@ json_t *Path::toJson() const {
   json_t *json_sources = json_array();
   json_t *json_destinations = json_array();
 
+  size_t cache_hits, cache_misses;
+  getPoolCacheCounters(cache_hits, cache_misses);
+
   for (auto ps : sources)
     json_array_append_new(json_sources,
                           json_string(ps->node->getNameShort().c_str()));
@@ -674,17 +1105,93 @@ json_t *Path::toJson() const {
                           json_string(pd->node->getNameShort().c_str()));
 
   json_t *json_path = json_pack(
-      "{ s: s, s: s, s: s, s: b, s: b s: b, s: b, s: b, s: b s: i, s: o, s: o, "
-      "s: o, s: o }",
+      "{ s: s, s: s, s: s, s: b, s: b s: b, s: b, s: b, s: b s: s, s: b, "
+      "s: s, s: f, s: f, s: f, s: i, s: i, s: I, s: I, s: o, s: o, s: o, "
+      "s: o }",
       "uuid", uuid::toString(uuid).c_str(), "state",
       stateToString(state).c_str(), "mode", mode == Mode::ANY ? "any" : "all",
       "enabled", enabled, "builtin", builtin, "reversed", reversed,
       "original_sequence_no", original_sequence_no, "last_sequence",
-      last_sequence, "poll", poll, "queuelen", queuelen, "signals",
+      last_sequence, "poll", poll, "io_engine",
+      io_engine == IoEngine::IO_URING ? "io_uring" : "poll", "executor",
+      executor != nullptr, "wait", waitModeToString(wait_mode), "spin_budget",
+      spin_budget, "spin_time", spin_time, "sleep_time", sleep_time, "queuelen",
+      queuelen, "pool_cache", pool_cache, "pool_cache_hits",
+      (json_int_t)cache_hits, "pool_cache_misses", (json_int_t)cache_misses,
+      "signals",
       json_signals, "hooks", json_hooks, "in", json_sources, "out",
       json_destinations);
 
+#ifdef WITH_HOOKS
+  json_object_set_new(json_path, "hook_plan", hooks.planToJson());
+#endif // WITH_HOOKS
+
+  if (stats)
+    json_object_set_new(json_path, "stats", stats->toJson());
+
   return json_path;
 }
 
+void Path::getPoolCacheCounters(size_t &hits, size_t &misses) const {
+  hits = pool.cache_hits;
+  misses = pool.cache_misses;
+
+  for (auto ps : sources) {
+    hits += ps->pool.cache_hits;
+    misses += ps->pool.cache_misses;
+  }
+}
+
+const char *Path::waitModeToString(WaitMode m) {
+  switch (m) {
+  case WaitMode::BLOCK:
+    return "block";
+
+  case WaitMode::SPIN:
+    return "spin";
+
+  case WaitMode::ADAPTIVE:
+    return "adaptive";
+  }
+
+  return "unknown";
+}
+
+uint64_t Path::traceNow() const {
+#ifdef __x86_64__
+  if (tsc.frequency)
+    return tsc_now(const_cast<struct Tsc *>(&tsc));
+#endif
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void Path::traceStage(enum Stats::Metric m, Node *n, uint64_t start,
+                      uint64_t end) const {
+  double delta = (end - start) * trace_period;
+
+  stats->update(m, delta);
+
+  if (n && n->getStats())
+    n->getStats()->update(m, delta);
+}
+
+void Path::recordWait(enum Stats::Metric m, double delta) {
+  if (m == Stats::Metric::WAIT_SPIN)
+    spin_time += delta;
+  else
+    sleep_time += delta;
+
+  stats->update(m, delta);
+
+  for (auto ps : sources) {
+    auto *n = ps->getNode();
+    if (n->getStats())
+      n->getStats()->update(m, delta);
+  }
+}
+
 int villas::node::Path::id = 0;
@@ -16,7 +16,8 @@
 using namespace villas;
 using namespace villas::node;
 
-PathDestination::PathDestination(Path *p, Node *n) : node(n), path(p) {
+PathDestination::PathDestination(Path *p, Node *n)
+    : node(n), path(p), stamps_head(0), stamps_tail(0) {
   queue.state = State::DESTROYED;
 }
 
@@ -26,31 +27,59 @@ PathDestination::~PathDestination() {
   ret = queue_destroy(&queue);
 }
 
-int PathDestination::prepare(int queuelen) {
+int PathDestination::prepare(int queuelen, int flags) {
   int ret;
 
-  ret = queue_init(&queue, queuelen);
+  ret = queue_init(&queue, queuelen, memory::default_type, flags);
   if (ret)
     return ret;
 
+  if (path->trace)
+    stamps.resize(queuelen);
+
   return 0;
 }
 
 void PathDestination::enqueueAll(Path *p, const struct Sample *const smps[],
                                  unsigned cnt) {
   unsigned enqueued, cloned;
+  bool frozen = true;
 
   struct Sample *clones[cnt];
 
-  cloned = sample_clone_many(clones, smps, cnt);
-  if (cloned < cnt)
-    p->logger->warn("Pool underrun in path {}", p->toString());
+  for (unsigned i = 0; i < cnt; i++) {
+    if (!sample_is_frozen(smps[i])) {
+      frozen = false;
+      break;
+    }
+  }
+
+  /* Frozen samples are immutable and can be shared between all
+   * destinations by reference. Others need to be cloned first.
+   */
+  if (frozen) {
+    for (unsigned i = 0; i < cnt; i++)
+      clones[i] = const_cast<struct Sample *>(smps[i]);
+
+    cloned = sample_incref_many(clones, cnt);
+  } else {
+    cloned = sample_clone_many(clones, smps, cnt);
+    if (cloned < cnt)
+      p->logger->warn("Pool underrun in path {}", p->toString());
+  }
+
+  uint64_t now = p->trace ? p->traceNow() : 0;
 
   for (auto pd : p->destinations) {
     enqueued = queue_push_many(&pd->queue, (void **)clones, cloned);
     if (enqueued != cnt)
       p->logger->warn("Queue overrun for path {}", p->toString());
 
+    if (p->trace) {
+      for (unsigned i = 0; i < enqueued; i++)
+        pd->stamps[pd->stamps_head++ % pd->stamps.size()] = now;
+    }
+
     // Increase reference counter of these samples as they are now also owned by the queue
     sample_incref_many(clones, cloned);
 
@@ -82,7 +111,37 @@ void PathDestination::write() {
         "Dequeued {} samples from queue of node {} which is part of path {}",
         allocated, node->getName(), path->toString());
 
+    uint64_t t_write = 0;
+    if (path->trace) {
+      t_write = path->traceNow();
+
+      for (int i = 0; i < allocated; i++)
+        path->traceStage(Stats::Metric::STAGE_QUEUE, node,
+                         stamps[stamps_tail++ % stamps.size()], t_write);
+    }
+
+#ifdef WITH_HOOKS
+    /* Write hooks modify samples in place.
+     * Nodes only read the samples passed to them. Hence, frozen samples
+     * which are shared with other destinations are only copied here.
+     */
+    if (node->out.hooks.size() > 0) {
+      int writable = sample_make_writable_many(smps, allocated);
+      if (writable < allocated) {
+        path->logger->warn("Pool underrun in path {}", path->toString());
+
+        sample_decref_many(smps + writable, allocated - writable);
+        allocated = writable;
+      }
+    }
+#endif // WITH_HOOKS
+
     sent = node->write(smps, allocated);
+
+    if (path->trace)
+      path->traceStage(Stats::Metric::STAGE_WRITE, node, t_write,
+                       path->traceNow());
+
     if (sent < 0) {
       path->logger->error("Failed to sent {} samples to node {}: reason={}",
                           cnt, node->getName(), sent);
@@ -97,6 +156,18 @@ void PathDestination::write() {
   }
 }
 
+void PathDestination::drain() {
+  int cnt = node->out.vectorize;
+  int pulled;
+
+  struct Sample *smps[cnt];
+
+  while ((pulled = queue_pull_many(&queue, (void **)smps, cnt)) > 0)
+    sample_decref_many(smps, pulled);
+
+  stamps_tail = stamps_head;
+}
+
 void PathDestination::check() {
   if (!node->isEnabled())
     throw RuntimeError("Destination {} is not enabled", node->getName());
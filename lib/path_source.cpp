@@ -42,6 +42,7 @@ PathSource::~PathSource() {
 int PathSource::read(int i) {
   int ret, recv, tomux, allocated, cnt, toenqueue, enqueued = 0,
                                                    muxed_initialized = 0;
+  uint64_t t_read = 0, t_remap = 0, t_hooks = 0;
 
   cnt = node->in.vectorize;
 
@@ -54,6 +55,9 @@ int PathSource::read(int i) {
   if (allocated != cnt)
     path->logger->warn("Pool underrun for path source {}", node->getName());
 
+  if (path->trace)
+    t_read = path->traceNow();
+
   // Read ready samples and store them to blocks pointed by smps[]
   recv = node->read(read_smps, allocated);
   if (recv == 0) {
@@ -71,10 +75,15 @@ int PathSource::read(int i) {
       enqueued = 0;
       goto read_decref_read_smps;
     }
-  } else if (recv < allocated)
+  } else if (recv < allocated && !node->isNonBlocking())
     path->logger->warn("Partial read for path {}: read={}, expected={}",
                        path->toString(), recv, allocated);
 
+  if (path->trace) {
+    t_remap = path->traceNow();
+    path->traceStage(Stats::Metric::STAGE_READ, node, t_read, t_remap);
+  }
+
   // Let the master path sources forward received samples to their secondaries
   writeToSecondaries(read_smps, recv);
 
@@ -132,6 +141,11 @@ int PathSource::read(int i) {
 
   sample_copy(path->last_sample, muxed_smps[tomux - 1]);
 
+  if (path->trace) {
+    t_hooks = path->traceNow();
+    path->traceStage(Stats::Metric::STAGE_REMAP, node, t_remap, t_hooks);
+  }
+
 #ifdef WITH_HOOKS
   toenqueue = path->hooks.process(muxed_smps, tomux);
   if (toenqueue == -1) {
@@ -148,6 +162,16 @@ int PathSource::read(int i) {
   toenqueue = tomux;
 #endif
 
+  if (path->trace)
+    path->traceStage(Stats::Metric::STAGE_HOOKS, node, t_hooks,
+                     path->traceNow());
+
+  /* The muxed samples are not modified anymore after the hooks ran.
+   * Hence, they can be passed to all destinations by reference.
+   */
+  if (toenqueue > 0)
+    sample_freeze_many(muxed_smps, toenqueue);
+
   path->received.set(i);
 
   path->logger->trace("Source nodes: received=0b{:b}, mask=0b{:b}",
@@ -5,6 +5,10 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <mutex>
+#include <set>
+#include <vector>
+
 #include <villas/exceptions.hpp>
 #include <villas/kernel/kernel.hpp>
 #include <villas/log.hpp>
@@ -13,6 +17,180 @@
 #include <villas/utils.hpp>
 
 using namespace villas;
+using namespace villas::node;
+
+namespace {
+
+/* A Bonwick-style magazine cache
+ *
+ * See: J. Bonwick and J. Adams, "Magazines and Vmem: Extending the Slab
+ *      Allocator to Many CPUs and Arbitrary Resources", USENIX 2001.
+ */
+struct PoolMagazines {
+  struct Pool *pool;
+  uint64_t cache_id;
+
+  std::vector<void *> loaded;
+  std::vector<void *> previous;
+
+  size_t hits;
+  size_t misses;
+};
+
+// Protects against concurrent pool_destroy() while threads exit
+std::mutex pools_mutex;
+std::set<uint64_t> pools_cached;
+std::atomic<uint64_t> pools_next_cache_id(1);
+
+void pool_cache_publish(struct PoolMagazines *m) {
+  struct Pool *p = m->pool;
+
+  std::atomic_fetch_add_explicit(&p->cache_hits, m->hits,
+                                 std::memory_order_relaxed);
+  std::atomic_fetch_add_explicit(&p->cache_misses, m->misses,
+                                 std::memory_order_relaxed);
+
+  m->hits = 0;
+  m->misses = 0;
+}
+
+/* Count an operation served by the magazines of the calling thread.
+ *
+ * The counters are published to the pool with every exchange with the
+ * shared queue and at least every magazine_size operations. So they are
+ * also current for long-lived threads which never flush their magazines.
+ */
+void pool_cache_count(struct PoolMagazines *m, bool miss) {
+  if (miss)
+    m->misses++;
+  else
+    m->hits++;
+
+  if (miss || m->hits >= m->pool->magazine_size)
+    pool_cache_publish(m);
+}
+
+void pool_cache_flush_magazines(struct PoolMagazines *m) {
+  struct Pool *p = m->pool;
+
+  queue_push_many(&p->queue, m->loaded.data(), m->loaded.size());
+  queue_push_many(&p->queue, m->previous.data(), m->previous.size());
+
+  m->loaded.clear();
+  m->previous.clear();
+
+  pool_cache_publish(m);
+}
+
+class PoolCache {
+
+public:
+  std::vector<struct PoolMagazines> magazines;
+
+  ~PoolCache() {
+    // Return cached blocks of pools which are still alive
+    std::lock_guard<std::mutex> guard(pools_mutex);
+
+    for (auto &m : magazines) {
+      if (pools_cached.count(m.cache_id))
+        pool_cache_flush_magazines(&m);
+    }
+  }
+
+  struct PoolMagazines *lookup(struct Pool *p) {
+    for (auto it = magazines.begin(); it != magazines.end(); ++it) {
+      if (it->pool != p)
+        continue;
+
+      if (it->cache_id == p->cache_id)
+        return &*it;
+
+      // Stale magazines of a destroyed pool at the same address
+      magazines.erase(it);
+      break;
+    }
+
+    magazines.push_back({.pool = p,
+                         .cache_id = p->cache_id,
+                         .loaded = {},
+                         .previous = {},
+                         .hits = 0,
+                         .misses = 0});
+
+    auto *m = &magazines.back();
+    m->loaded.reserve(p->magazine_size);
+    m->previous.reserve(p->magazine_size);
+
+    return m;
+  }
+};
+
+thread_local PoolCache pool_cache;
+
+ssize_t pool_cache_get_many(struct Pool *p, void *blocks[], size_t cnt) {
+  auto *m = pool_cache.lookup(p);
+  bool miss = false;
+  size_t n = 0;
+
+  while (n < cnt) {
+    if (!m->loaded.empty()) {
+      while (n < cnt && !m->loaded.empty()) {
+        blocks[n++] = m->loaded.back();
+        m->loaded.pop_back();
+      }
+    } else if (!m->previous.empty())
+      std::swap(m->loaded, m->previous);
+    else {
+      // Both magazines are empty: refill from the shared queue
+      m->loaded.resize(p->magazine_size);
+
+      int ret = queue_pull_many(&p->queue, m->loaded.data(), p->magazine_size);
+
+      m->loaded.resize(ret > 0 ? ret : 0);
+      miss = true;
+
+      if (ret <= 0)
+        break;
+    }
+  }
+
+  pool_cache_count(m, miss);
+
+  return n;
+}
+
+ssize_t pool_cache_put_many(struct Pool *p, void *blocks[], size_t cnt) {
+  auto *m = pool_cache.lookup(p);
+  bool miss = false;
+  size_t n = 0;
+
+  while (n < cnt) {
+    if (m->loaded.size() < p->magazine_size) {
+      while (n < cnt && m->loaded.size() < p->magazine_size)
+        m->loaded.push_back(blocks[n++]);
+    } else if (m->previous.empty())
+      std::swap(m->loaded, m->previous);
+    else {
+      // Both magazines are full: return one to the shared queue
+      int ret = queue_push_many(&p->queue, m->previous.data(),
+                                m->previous.size());
+      if (ret < 0)
+        break;
+
+      m->previous.erase(m->previous.begin(), m->previous.begin() + ret);
+      miss = true;
+
+      if (!m->previous.empty())
+        break;
+    }
+  }
+
+  pool_cache_count(m, miss);
+
+  return n;
+}
+
+} // namespace
 
 int villas::node::pool_init(struct Pool *p, size_t cnt, size_t blocksz,
                             struct memory::Type *m) {
@@ -34,6 +212,10 @@ int villas::node::pool_init(struct Pool *p, size_t cnt, size_t blocksz,
   logger->debug("Allocated {:#x} bytes for memory pool", p->len);
 
   p->buffer_off = (char *)buffer - (char *)p;
+  p->magazine_size = 0;
+  p->cache_id = 0;
+  p->cache_hits = 0;
+  p->cache_misses = 0;
 
   ret = queue_init(&p->queue, LOG2_CEIL(cnt), m);
   if (ret)
@@ -53,6 +235,12 @@ int villas::node::pool_destroy(struct Pool *p) {
   if (p->state == State::DESTROYED)
     return 0;
 
+  if (p->magazine_size > 0) {
+    std::lock_guard<std::mutex> guard(pools_mutex);
+
+    pools_cached.erase(p->cache_id);
+  }
+
   ret = queue_destroy(&p->queue);
   if (ret)
     return ret;
@@ -65,21 +253,58 @@ int villas::node::pool_destroy(struct Pool *p) {
   return ret;
 }
 
+int villas::node::pool_cache_enable(struct Pool *p, size_t magazine_size,
+                                     unsigned threads) {
+  // Every thread may strand both of its magazines
+  if (2 * magazine_size * MAX(1U, threads) > p->len / p->blocksz)
+    return -1;
+
+  std::lock_guard<std::mutex> guard(pools_mutex);
+
+  p->magazine_size = magazine_size;
+  p->cache_id = pools_next_cache_id++;
+
+  if (magazine_size > 0)
+    pools_cached.insert(p->cache_id);
+
+  return 0;
+}
+
+void villas::node::pool_cache_flush(struct Pool *p) {
+  if (p->magazine_size == 0)
+    return;
+
+  pool_cache_flush_magazines(pool_cache.lookup(p));
+}
+
 ssize_t villas::node::pool_get_many(struct Pool *p, void *blocks[],
                                     size_t cnt) {
+  if (p->magazine_size > 0)
+    return pool_cache_get_many(p, blocks, cnt);
+
   return queue_pull_many(&p->queue, blocks, cnt);
 }
 
 ssize_t villas::node::pool_put_many(struct Pool *p, void *blocks[],
                                     size_t cnt) {
+  if (p->magazine_size > 0)
+    return pool_cache_put_many(p, blocks, cnt);
+
   return queue_push_many(&p->queue, blocks, cnt);
 }
 
 void *villas::node::pool_get(struct Pool *p) {
   void *ptr;
+
+  if (p->magazine_size > 0)
+    return pool_cache_get_many(p, &ptr, 1) == 1 ? ptr : nullptr;
+
   return queue_pull(&p->queue, &ptr) == 1 ? ptr : nullptr;
 }
 
 int villas::node::pool_put(struct Pool *p, void *buf) {
+  if (p->magazine_size > 0)
+    return pool_cache_put_many(p, &buf, 1);
+
   return queue_push(&p->queue, buf);
 }
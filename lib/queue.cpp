@@ -37,10 +37,11 @@
 #include <villas/utils.hpp>
 
 using namespace villas;
+using namespace villas::node;
 
 // Initialize MPMC queue
 int villas::node::queue_init(struct CQueue *q, size_t size,
-                             struct memory::Type *m) {
+                             struct memory::Type *m, int flags) {
   // Queue size must be 2 exponent
   if (!IS_POW2(size)) {
     size_t old_size = size;
@@ -51,6 +52,7 @@ int villas::node::queue_init(struct CQueue *q, size_t size,
   }
 
   q->buffer_mask = size - 1;
+  q->flags = flags;
   struct CQueue_cell *buffer =
       (struct CQueue_cell *)memory::alloc(sizeof(struct CQueue_cell) * size, m);
   if (!buffer)
@@ -70,6 +72,9 @@ int villas::node::queue_init(struct CQueue *q, size_t size,
   std::atomic_store_explicit(&q->head, 0u, std::memory_order_relaxed);
 #endif
 
+  q->cached_head = 0;
+  q->cached_tail = 0;
+
   q->state = State::INITIALIZED;
 
   return 0;
@@ -94,6 +99,63 @@ size_t villas::node::queue_available(struct CQueue *q) {
          std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
 }
 
+/* Single-producer, single-consumer variants
+ *
+ * The producer owns the tail and the consumer owns the head pointer.
+ * Each side keeps a cached copy of the other side's pointer and only
+ * reloads it if the cached value indicates a full or empty ring.
+ * The per-cell sequence numbers are not used.
+ */
+static int queue_spsc_push_many(struct CQueue *q, void *ptr[], size_t cnt) {
+  struct CQueue_cell *buffer;
+  size_t tail, space, size = q->buffer_mask + 1;
+
+  buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
+  tail = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
+
+  space = size - (tail - q->cached_head);
+  if (space < cnt) {
+    q->cached_head =
+        std::atomic_load_explicit(&q->head, std::memory_order_acquire);
+    space = size - (tail - q->cached_head);
+  }
+
+  if (cnt > space)
+    cnt = space;
+
+  for (size_t i = 0; i < cnt; i++)
+    buffer[(tail + i) & q->buffer_mask].data_off = (char *)ptr[i] - (char *)q;
+
+  std::atomic_store_explicit(&q->tail, tail + cnt, std::memory_order_release);
+
+  return cnt;
+}
+
+static int queue_spsc_pull_many(struct CQueue *q, void *ptr[], size_t cnt) {
+  struct CQueue_cell *buffer;
+  size_t head, avail;
+
+  buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
+  head = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
+
+  avail = q->cached_tail - head;
+  if (avail < cnt) {
+    q->cached_tail =
+        std::atomic_load_explicit(&q->tail, std::memory_order_acquire);
+    avail = q->cached_tail - head;
+  }
+
+  if (cnt > avail)
+    cnt = avail;
+
+  for (size_t i = 0; i < cnt; i++)
+    ptr[i] = (char *)q + buffer[(head + i) & q->buffer_mask].data_off;
+
+  std::atomic_store_explicit(&q->head, head + cnt, std::memory_order_release);
+
+  return cnt;
+}
+
 int villas::node::queue_push(struct CQueue *q, void *ptr) {
   struct CQueue_cell *cell, *buffer;
   size_t pos, seq;
@@ -103,6 +165,9 @@ int villas::node::queue_push(struct CQueue *q, void *ptr) {
       State::STOPPED)
     return -1;
 
+  if (q->flags & (int)QueueFlags::SPSC)
+    return queue_spsc_push_many(q, &ptr, 1);
+
   buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
   pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
   while (true) {
@@ -137,6 +202,9 @@ int villas::node::queue_pull(struct CQueue *q, void **ptr) {
       State::STOPPED)
     return -1;
 
+  if (q->flags & (int)QueueFlags::SPSC)
+    return queue_spsc_pull_many(q, ptr, 1);
+
   buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
   pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
   while (true) {
@@ -163,35 +231,113 @@ int villas::node::queue_pull(struct CQueue *q, void **ptr) {
 }
 
 int villas::node::queue_push_many(struct CQueue *q, void *ptr[], size_t cnt) {
-  int ret;
-  size_t i;
+  struct CQueue_cell *buffer;
+  size_t pos, seq, i, n;
+  intptr_t diff;
+
+  if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) ==
+      State::STOPPED)
+    return -1;
+
+  if (cnt == 0)
+    return 0;
+
+  if (q->flags & (int)QueueFlags::SPSC)
+    return queue_spsc_push_many(q, ptr, cnt);
 
-  for (ret = 0, i = 0; i < cnt; i++) {
-    ret = queue_push(q, ptr[i]);
-    if (ret <= 0)
-      break;
+  if (cnt > q->buffer_mask + 1)
+    cnt = q->buffer_mask + 1;
+
+  buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
+  pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
+  while (true) {
+    // Count the number of consecutive free cells starting at the tail
+    for (n = 0; n < cnt; n++) {
+      seq = std::atomic_load_explicit(
+          &buffer[(pos + n) & q->buffer_mask].sequence,
+          std::memory_order_acquire);
+      diff = (intptr_t)seq - (intptr_t)(pos + n);
+      if (diff != 0)
+        break;
+    }
+
+    if (n > 0) {
+      // Reserve the whole range of cells with a single CAS
+      if (std::atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + n,
+                                                     std::memory_order_relaxed,
+                                                     std::memory_order_relaxed))
+        break;
+    } else if (diff < 0)
+      return 0;
+    else
+      pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
   }
 
-  if (ret == -1 && i == 0)
-    return -1;
+  // Publish the reserved cells in order
+  for (i = 0; i < n; i++) {
+    struct CQueue_cell *cell = &buffer[(pos + i) & q->buffer_mask];
+
+    cell->data_off = (char *)ptr[i] - (char *)q;
+    std::atomic_store_explicit(&cell->sequence, pos + i + 1,
+                               std::memory_order_release);
+  }
 
-  return i;
+  return n;
 }
 
 int villas::node::queue_pull_many(struct CQueue *q, void *ptr[], size_t cnt) {
-  int ret;
-  size_t i;
+  struct CQueue_cell *buffer;
+  size_t pos, seq, i, n;
+  intptr_t diff;
+
+  if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) ==
+      State::STOPPED)
+    return -1;
+
+  if (cnt == 0)
+    return 0;
+
+  if (q->flags & (int)QueueFlags::SPSC)
+    return queue_spsc_pull_many(q, ptr, cnt);
+
+  if (cnt > q->buffer_mask + 1)
+    cnt = q->buffer_mask + 1;
 
-  for (ret = 0, i = 0; i < cnt; i++) {
-    ret = queue_pull(q, &ptr[i]);
-    if (ret <= 0)
-      break;
+  buffer = (struct CQueue_cell *)((char *)q + q->buffer_off);
+  pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
+  while (true) {
+    // Count the number of consecutive published cells starting at the head
+    for (n = 0; n < cnt; n++) {
+      seq = std::atomic_load_explicit(
+          &buffer[(pos + n) & q->buffer_mask].sequence,
+          std::memory_order_acquire);
+      diff = (intptr_t)seq - (intptr_t)(pos + n + 1);
+      if (diff != 0)
+        break;
+    }
+
+    if (n > 0) {
+      // Reserve the whole range of cells with a single CAS
+      if (std::atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + n,
+                                                     std::memory_order_relaxed,
+                                                     std::memory_order_relaxed))
+        break;
+    } else if (diff < 0)
+      return 0;
+    else
+      pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
   }
 
-  if (ret == -1 && i == 0)
-    return -1;
+  // Release the reserved cells in order
+  for (i = 0; i < n; i++) {
+    struct CQueue_cell *cell = &buffer[(pos + i) & q->buffer_mask];
+
+    ptr[i] = (char *)q + cell->data_off;
+    std::atomic_store_explicit(&cell->sequence, pos + i + q->buffer_mask + 1,
+                               std::memory_order_release);
+  }
 
-  return i;
+  return n;
 }
 
 int villas::node::queue_close(struct CQueue *q) {
@@ -45,7 +45,8 @@ int villas::node::queue_signalled_init(struct CQueueSignalled *qs, size_t size,
 #endif
   }
 
-  ret = queue_init(&qs->queue, size, mem);
+  ret = queue_init(&qs->queue, size, mem,
+                   flags & ~(int)QueueSignalledFlags::PROCESS_SHARED);
   if (ret < 0)
     return ret;
 
@@ -268,6 +269,14 @@ int villas::node::queue_signalled_pull_many(struct CQueueSignalled *qs,
   return pulled;
 }
 
+int villas::node::queue_signalled_try_pull_many(struct CQueueSignalled *qs,
+                                                void *ptr[], size_t cnt) {
+  /* The signalling state is left untouched. A later blocking pull
+   * might therefore return once without data and wait again.
+   */
+  return queue_pull_many(&qs->queue, ptr, cnt);
+}
+
 int villas::node::queue_signalled_close(struct CQueueSignalled *qs) {
   int ret;
 
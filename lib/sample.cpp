@@ -28,6 +28,7 @@ int villas::node::sample_init(struct Sample *s) {
   s->length = 0;
   s->capacity = (p->blocksz - sizeof(struct Sample)) / sizeof(s->data[0]);
   s->refcnt = ATOMIC_VAR_INIT(1);
+  s->flags &= ~(int)SampleFlags::FROZEN;
 
   new (&s->signals) std::shared_ptr<SignalList>;
 
@@ -137,7 +138,7 @@ int villas::node::sample_copy(struct Sample *dst, const struct Sample *src) {
   dst->length = MIN(src->length, dst->capacity);
 
   dst->sequence = src->sequence;
-  dst->flags = src->flags;
+  dst->flags = src->flags & ~(int)SampleFlags::FROZEN;
   dst->ts = src->ts;
   dst->signals = src->signals;
 
@@ -146,6 +147,48 @@ int villas::node::sample_copy(struct Sample *dst, const struct Sample *src) {
   return 0;
 }
 
+void villas::node::sample_freeze(struct Sample *s) {
+  s->flags |= (int)SampleFlags::FROZEN;
+}
+
+void villas::node::sample_freeze_many(struct Sample *const smps[], int cnt) {
+  for (int i = 0; i < cnt; i++)
+    sample_freeze(smps[i]);
+}
+
+struct Sample *villas::node::sample_make_writable(struct Sample *s) {
+  struct Sample *clone;
+
+  if (!sample_is_frozen(s))
+    return s;
+
+  // We are the only owner
+  if (atomic_load(&s->refcnt) == 1) {
+    s->flags &= ~(int)SampleFlags::FROZEN;
+    return s;
+  }
+
+  clone = sample_clone(s);
+  if (!clone)
+    return nullptr;
+
+  sample_decref(s);
+
+  return clone;
+}
+
+int villas::node::sample_make_writable_many(struct Sample *smps[], int cnt) {
+  for (int i = 0; i < cnt; i++) {
+    struct Sample *s = sample_make_writable(smps[i]);
+    if (!s)
+      return i;
+
+    smps[i] = s;
+  }
+
+  return cnt;
+}
+
 struct Sample *villas::node::sample_clone(struct Sample *orig) {
   struct Sample *clone;
   struct Pool *pool;
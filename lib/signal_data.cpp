@@ -5,14 +5,123 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <charconv>
 #include <cinttypes>
+#include <cmath>
 #include <cstring>
+#include <limits>
 
 #include <villas/signal_data.hpp>
 #include <villas/signal_type.hpp>
+#include <villas/utils.hpp>
 
 using namespace villas::node;
 
+/* Conversion between numbers and strings.
+ *
+ * std::to_chars() and std::from_chars() do not depend on the locale and are
+ * considerably faster than the printf() and strtod() family. The latter are
+ * still used for inputs which are not supported by std::from_chars() like
+ * hexadecimal floats or out-of-range values to retain the previous behaviour.
+ */
+namespace {
+
+bool isNumberChar(char c) {
+  return isalnum((unsigned char)c) || c == '.' || c == '+' || c == '-';
+}
+
+// Returns the end of the number which starts at ptr
+const char *numberEnd(const char *ptr) {
+  while (isNumberChar(*ptr))
+    ptr++;
+
+  return ptr;
+}
+
+// Skip leading whitespace and a positive sign which are accepted by strtod()
+const char *numberStart(const char *ptr) {
+  while (isspace((unsigned char)*ptr))
+    ptr++;
+
+  if (ptr[0] == '+' && ptr[1] != '-' && ptr[1] != '+')
+    ptr++;
+
+  return ptr;
+}
+
+double parseReal(const char *ptr, char **end) {
+#ifdef __cpp_lib_to_chars
+  double v;
+  const char *first = numberStart(ptr);
+  auto res = std::from_chars(first, numberEnd(first), v);
+  if (res.ec == std::errc() && *res.ptr != 'x' && *res.ptr != 'X') {
+    *end = const_cast<char *>(res.ptr);
+    return v;
+  }
+#endif
+
+  return strtod(ptr, end);
+}
+
+int64_t parseInteger(const char *ptr, char **end) {
+  int64_t v;
+  const char *first = numberStart(ptr);
+  auto res = std::from_chars(first, numberEnd(first), v);
+  if (res.ec == std::errc()) {
+    *end = const_cast<char *>(res.ptr);
+    return v;
+  }
+
+  return strtoll(ptr, end, 10);
+}
+
+/* Print a real number with a fixed number of decimal places.
+ *
+ * A negative precision selects the shortest representation which can be
+ * parsed back to the same value. The return value follows snprintf().
+ */
+template <typename T>
+int printReal(char *buf, size_t len, T v, int precision, bool sign = false) {
+#ifdef __cpp_lib_to_chars
+  if (len > 1) {
+    char *ptr = buf;
+    char *last = buf + len - 1; // Leave space for the terminator
+
+    if (sign && !std::signbit(v))
+      *ptr++ = '+';
+
+    auto res = precision < 0 ? std::to_chars(ptr, last, v)
+                             : std::to_chars(ptr, last, v,
+                                             std::chars_format::fixed,
+                                             precision);
+    if (res.ec == std::errc()) {
+      *res.ptr = '\0';
+      return res.ptr - buf;
+    }
+  }
+#endif
+
+  if (precision < 0)
+    return snprintf(buf, len, sign ? "%+.*g" : "%.*g",
+                    std::numeric_limits<T>::max_digits10, (double)v);
+
+  return snprintf(buf, len, sign ? "%+.*f" : "%.*f", precision, (double)v);
+}
+
+int printInteger(char *buf, size_t len, int64_t v) {
+  if (len > 1) {
+    auto res = std::to_chars(buf, buf + len - 1, v);
+    if (res.ec == std::errc()) {
+      *res.ptr = '\0';
+      return res.ptr - buf;
+    }
+  }
+
+  return snprintf(buf, len, "%" PRIi64, v);
+}
+
+} // namespace
+
 void SignalData::set(enum SignalType type, double val) {
   switch (type) {
   case SignalType::BOOLEAN:
@@ -131,21 +240,21 @@ SignalData SignalData::cast(enum SignalType from, enum SignalType to) const {
 int SignalData::parseString(enum SignalType type, const char *ptr, char **end) {
   switch (type) {
   case SignalType::FLOAT:
-    this->f = strtod(ptr, end);
+    this->f = parseReal(ptr, end);
     break;
 
   case SignalType::INTEGER:
-    this->i = strtol(ptr, end, 10);
+    this->i = parseInteger(ptr, end);
     break;
 
   case SignalType::BOOLEAN:
-    this->b = strtol(ptr, end, 10);
+    this->b = parseInteger(ptr, end);
     break;
 
   case SignalType::COMPLEX: {
     float real, imag = 0;
 
-    real = strtod(ptr, end);
+    real = parseReal(ptr, end);
     if (*end == ptr)
       return -1;
 
@@ -157,7 +266,7 @@ int SignalData::parseString(enum SignalType type, const char *ptr, char **end) {
 
       (*end)++;
     } else if (*ptr == '-' || *ptr == '+') {
-      imag = strtod(ptr, end);
+      imag = parseReal(ptr, end);
       if (*end == ptr)
         return -1;
 
@@ -249,17 +358,23 @@ int SignalData::printString(enum SignalType type, char *buf, size_t len,
                             int precision) const {
   switch (type) {
   case SignalType::FLOAT:
-    return snprintf(buf, len, "%.*f", precision, this->f);
+    return printReal(buf, len, this->f, precision);
 
   case SignalType::INTEGER:
-    return snprintf(buf, len, "%" PRIi64, this->i);
+    return printInteger(buf, len, this->i);
 
   case SignalType::BOOLEAN:
-    return snprintf(buf, len, "%u", this->b);
+    return printInteger(buf, len, this->b);
 
-  case SignalType::COMPLEX:
-    return snprintf(buf, len, "%.*f%+.*fi", precision, std::real(this->z),
-                    precision, std::imag(this->z));
+  case SignalType::COMPLEX: {
+    int n = printReal(buf, len, std::real(this->z), precision);
+    size_t off = MIN((size_t)n, len);
+
+    n += printReal(buf + off, len - off, std::imag(this->z), precision, true);
+    off = MIN((size_t)n, len);
+
+    return n + snprintf(buf + off, len - off, "i");
+  }
 
   default:
     return snprintf(buf, len, "<?>");
@@ -97,8 +97,9 @@ int villas::node::socket_parse_address(const char *addr, struct sockaddr *saddr,
     ret = 0;
   }
 #ifdef WITH_SOCKET_LAYER_ETH
-  else if (layer ==
-           SocketLayer::ETH) { // Format: "ab:cd:ef:12:34:56%ifname:protocol"
+  else if (layer == SocketLayer::ETH ||
+           layer ==
+               SocketLayer::XDP) { // Format: "ab:cd:ef:12:34:56%ifname:protocol"
     // Split string
     char *lasts;
     char *node = strtok_r(copy, "%", &lasts);
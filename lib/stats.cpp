@@ -39,6 +39,23 @@ std::unordered_map<Stats::Metric, Stats::MetricDescription> Stats::metrics = {
      {"rtp.pkts_lost", "packets", "Cumulative number of packets lost"}},
     {Stats::Metric::RTP_JITTER,
      {"rtp.jitter", "seconds", "Interarrival jitter"}},
+    {Stats::Metric::STAGE_READ,
+     {"stage.read", "seconds", "Time spent reading samples from the node"}},
+    {Stats::Metric::STAGE_REMAP,
+     {"stage.remap", "seconds", "Time spent remapping received samples"}},
+    {Stats::Metric::STAGE_HOOKS,
+     {"stage.hooks", "seconds", "Time spent in the hooks of the path"}},
+    {Stats::Metric::STAGE_QUEUE,
+     {"stage.queue", "seconds",
+      "Time samples spent in the queue before being written"}},
+    {Stats::Metric::STAGE_WRITE,
+     {"stage.write", "seconds",
+      "Time spent formatting and writing samples to the node"}},
+    {Stats::Metric::WAIT_SPIN,
+     {"wait.spin", "seconds", "Time spent busy-polling the sources of a path"}},
+    {Stats::Metric::WAIT_SLEEP,
+     {"wait.sleep", "seconds",
+      "Time spent sleeping until the sources of a path are ready"}},
 };
 
 std::unordered_map<Stats::Type, Stats::TypeDescription> Stats::types = {
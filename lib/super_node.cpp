@@ -77,19 +77,20 @@ void SuperNode::parse(json_t *root) {
   json_t *json_paths = nullptr;
   json_t *json_logging = nullptr;
   json_t *json_http = nullptr;
+  json_t *json_executor = nullptr;
 
   json_error_t err;
 
   int stop = -1;
 
-  ret =
-      json_unpack_ex(root, &err, 0,
-                     "{ s?: F, s?: o, s?: o, s?: o, s?: o, s?: i, s?: i, s?: "
-                     "i, s?: b, s?: s }",
-                     "stats", &statsRate, "http", &json_http, "logging",
-                     &json_logging, "nodes", &json_nodes, "paths", &json_paths,
-                     "hugepages", &hugepages, "affinity", &affinity, "priority",
-                     &priority, "idle_stop", &stop, "uuid", &uuid_str);
+  ret = json_unpack_ex(
+      root, &err, 0,
+      "{ s?: F, s?: o, s?: o, s?: o, s?: o, s?: i, s?: i, s?: i, s?: b, s?: "
+      "s, s?: o }",
+      "stats", &statsRate, "http", &json_http, "logging", &json_logging,
+      "nodes", &json_nodes, "paths", &json_paths, "hugepages", &hugepages,
+      "affinity", &affinity, "priority", &priority, "idle_stop", &stop, "uuid",
+      &uuid_str, "executor", &json_executor);
   if (ret)
     throw ConfigError(root, err, "node-config",
                       "Unpacking top-level config failed");
@@ -113,6 +114,9 @@ void SuperNode::parse(json_t *root) {
   if (json_logging)
     Log::getInstance().parse(json_logging);
 
+  if (json_executor)
+    executor.parse(json_executor);
+
   // Parse nodes
   if (json_nodes) {
     if (!json_is_object(json_nodes))
@@ -224,6 +228,8 @@ void SuperNode::check() {
   for (auto *p : paths)
     p->check();
 
+  executor.check();
+
   state = State::CHECKED;
 }
 
@@ -291,10 +297,16 @@ void SuperNode::prepareNodes() {
 }
 
 void SuperNode::preparePaths() {
+  if (executor.isEnabled())
+    executor.prepare(affinity);
+
   for (auto *p : paths) {
     if (!p->isEnabled())
       continue;
 
+    if (executor.isEnabled())
+      p->executor = &executor;
+
     p->prepare(nodes);
   }
 }
@@ -340,6 +352,9 @@ void SuperNode::start() {
   startNodes();
   startPaths();
 
+  if (executor.isEnabled())
+    executor.start();
+
   if (statsRate > 0) // A rate <0 will disable the periodic stats
     task.setRate(statsRate);
 
@@ -397,6 +412,8 @@ void SuperNode::stopInterfaces() {
 }
 
 void SuperNode::stop() {
+  executor.stop();
+
   stopNodes();
   stopPaths();
   stopNodeTypes();
@@ -12,8 +12,6 @@
   # Extra features
   withExtraConfig ? withAllExtras,
   withExtraGraphviz ? withAllExtras,
-  # Format-types
-  withFormatProtobuf ? withAllFormats,
   # Hook-types
   withHookLua ? withAllHooks,
   # Node-types
@@ -66,9 +64,6 @@
   mosquitto,
   nanomsg,
   openssl,
-  pkgsBuildBuild,
-  protobufc,
-  protobufcBuildBuild ? pkgsBuildBuild.protobufc,
   rabbitmq-c,
   rdkafka,
   rdma-core,
@@ -85,8 +80,7 @@ stdenv.mkDerivation {
   separateDebugInfo = true;
   cmakeFlags =
     [ ]
-    ++ lib.optionals (!withGpl) [ "-DWITHOUT_GPL=ON" ]
-    ++ lib.optionals withFormatProtobuf [ "-DCMAKE_FIND_ROOT_PATH=${protobufcBuildBuild}/bin" ];
+    ++ lib.optionals (!withGpl) [ "-DWITHOUT_GPL=ON" ];
   postPatch = ''
     patchShebangs --host ./tools
   '';
@@ -117,7 +111,6 @@ stdenv.mkDerivation {
     makeWrapper
     pkg-config
   ];
-  depsBuildBuild = lib.optionals withFormatProtobuf [ protobufcBuildBuild ];
   buildInputs =
     [
       jansson
@@ -129,7 +122,6 @@ stdenv.mkDerivation {
     ]
     ++ lib.optionals withExtraConfig [ libconfig ]
     ++ lib.optionals withExtraGraphviz [ graphviz ]
-    ++ lib.optionals withFormatProtobuf [ protobufc ]
     ++ lib.optionals withHookLua [ lua ]
     ++ lib.optionals withNodeAmqp [ rabbitmq-c ]
     ++ lib.optionals withNodeComedi [ comedilib ]
@@ -216,7 +216,7 @@ protected:
     retry:
       eofs = 0;
       for (auto side : sides) {
-        ret = feof(side->stream);
+        ret = side->formatter->eof(side->stream);
         if (ret)
           eofs++;
       }
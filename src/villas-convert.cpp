@@ -139,7 +139,7 @@ protected:
     if (ret < 0)
       throw MemoryAllocationError();
 
-    while (!feof(stdin)) {
+    while (!dirs[0].formatter->eof(stdin)) {
       ret = dirs[0].formatter->scan(stdin, smps, cnt);
       if (ret == 0)
         continue;
@@ -149,6 +149,8 @@ protected:
       dirs[1].formatter->print(stdout, smps, ret);
     }
 
+    dirs[1].formatter->finish(stdout);
+
     for (unsigned i = 0; i < ARRAY_LEN(dirs); i++)
       delete dirs[i].formatter;
 
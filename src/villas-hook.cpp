@@ -235,7 +235,7 @@ protected:
     h->prepare(input->getSignals());
     h->start();
 
-    while (!stop && !feof(stdin)) {
+    while (!stop && !input->eof(stdin)) {
       ret = sample_alloc_many(&p, smps, cnt);
       if (ret != cnt)
         throw RuntimeError("Failed to allocate {} smps from pool", cnt);
@@ -248,17 +248,28 @@ protected:
 
       logger->debug("Read {} smps from stdin", recv);
 
-      unsigned send = 0;
-      for (int processed = 0; processed < recv; processed++) {
-        struct Sample *smp = smps[processed];
+      for (int i = 0; i < recv; i++) {
+        struct Sample *smp = smps[i];
 
         if (!(smp->flags & (int)SampleFlags::HAS_TS_RECEIVED)) {
           smp->ts.received = now;
           smp->flags |= (int)SampleFlags::HAS_TS_RECEIVED;
         }
+      }
+
+      node::Hook::Reason reasons[cnt];
+
+      ret = h->processBatch(smps, recv, reasons);
+      if (ret < 0)
+        throw RuntimeError("Failed to process samples");
 
-        auto ret = h->process(smp);
-        switch (ret) {
+      auto sigs = h->getSignals();
+
+      unsigned send = 0;
+      for (int processed = 0; processed < recv; processed++) {
+        struct Sample *smp = smps[processed];
+
+        switch (reasons[processed]) {
           using Reason = node::Hook::Reason;
         case Reason::ERROR:
           throw RuntimeError("Failed to process samples");
@@ -274,7 +285,7 @@ protected:
           goto stop;
         }
 
-        smp->signals = h->getSignals();
+        smp->signals = sigs;
       }
 
     stop:
@@ -287,6 +298,8 @@ protected:
 
     h->stop();
 
+    output->finish(stdout);
+
     for (auto &d : descs)
       delete (*d.formatter);
 
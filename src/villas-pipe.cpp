@@ -141,7 +141,7 @@ public:
       if (limit > 0 && count >= limit)
         goto leave_limit;
 
-      if (feof(stdin))
+      if (formatter->eof(stdin))
         goto leave_eof;
     }
 
@@ -210,6 +210,8 @@ public:
     raise(SIGUSR1);
 
   leave:
+    formatter->finish(stdout);
+
     logger->debug("Receive thread stopped");
   }
 };
@@ -276,7 +278,7 @@ protected:
 
     case SIGUSR1:
       if (recv.dir->enabled) {
-        if (recv.dir->limit < 0 && feof(stdin))
+        if (recv.dir->limit < 0 && formatter->eof(stdin))
           stop = true;
 
         if (recv.dir->limit > 0 && recv.dir->count >= recv.dir->limit)
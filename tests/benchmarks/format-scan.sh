@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+#
+# Benchmark for the throughput of scanning large recordings.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+# Settings
+
+# ${FORMATS} may be a list.
+FORMATS=${FORMATS:-"villas.binary villas.human csv"}
+NUM_VALUES=${NUM_VALUES:-64}
+SIZE_MB=${SIZE_MB:-4096} # Approximate size of the recordings
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+for FORMAT in ${FORMATS}; do
+    # Generate a small chunk and repeat it until the desired size is reached
+    villas signal -v ${NUM_VALUES} -n -l 10000 mixed | \
+    villas convert -o ${FORMAT} > chunk.dat
+
+    CHUNK_BYTES=$(stat -c %s chunk.dat)
+    REPEAT=$(( (SIZE_MB * 1024 * 1024 + CHUNK_BYTES - 1) / CHUNK_BYTES ))
+
+    for i in $(seq ${REPEAT}); do
+        cat chunk.dat
+    done > recording.dat
+
+    BYTES=$(stat -c %s recording.dat)
+    SAMPLES=$(( REPEAT * 10000 ))
+
+    START=$(date +%s.%N)
+    villas convert -i ${FORMAT} -o ${FORMAT} < recording.dat > /dev/null
+    END=$(date +%s.%N)
+
+    awk -v f=${FORMAT} -v b=${BYTES} -v s=${SAMPLES} -v t0=${START} -v t1=${END} 'BEGIN {
+        t = t1 - t0
+        printf "%-16s %8.1f MB/s %12.0f samples/s (%d bytes in %.2f s)\n", f, b / t / 1e6, s / t, b, t
+    }'
+
+    rm chunk.dat recording.dat
+done
@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+#
+# Benchmark for chains of elementwise hooks with and without fusion.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+# Settings
+
+NUM_VALUES=${NUM_VALUES:-64}
+NUM_SAMPLES=${NUM_SAMPLES:-1000000}
+VECTORIZE=${VECTORIZE:-64}
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+villas signal -v ${NUM_VALUES} -n -l ${NUM_SAMPLES} mixed | \
+villas convert -o villas.binary > input.dat
+
+SIGNALS=$(seq -s ', ' -f '"signal%g"' 0 $(( NUM_VALUES - 1 )))
+
+for FUSE in false true; do
+
+cat > config.json <<EOF
+{
+    "idle_stop": true,
+    "nodes": {
+        "input": {
+            "type": "file",
+            "uri": "input.dat",
+            "format": "villas.binary",
+
+            "in": {
+                "signals": "${NUM_VALUES}f",
+                "epoch_mode": "original",
+                "eof": "stop",
+                "vectorize": ${VECTORIZE}
+            }
+        },
+        "null": {
+            "type": "file",
+            "uri": "/dev/null",
+            "format": "villas.binary"
+        }
+    },
+    "paths": [
+        {
+            "in": "input",
+            "out": "null",
+            "hooks": [
+                { "type": "scale", "fuse": ${FUSE}, "signals": [ ${SIGNALS} ], "scale": 100, "offset": 5 },
+                { "type": "round", "fuse": ${FUSE}, "signals": [ ${SIGNALS} ], "precision": 2 },
+                { "type": "limit_value", "fuse": ${FUSE}, "signals": [ ${SIGNALS} ], "min": -50, "max": 50 },
+                { "type": "cast", "fuse": ${FUSE}, "signals": [ ${SIGNALS} ], "new_type": "integer" }
+            ]
+        }
+    ]
+}
+EOF
+
+    START=$(date +%s.%N)
+    villas node config.json > /dev/null
+    END=$(date +%s.%N)
+
+    awk -v f=${FUSE} -v s=${NUM_SAMPLES} -v t0=${START} -v t1=${END} 'BEGIN {
+        t = t1 - t0
+        printf "fuse=%-6s %12.0f samples/s (%d samples in %.2f s)\n", f, s / t, s, t
+    }'
+
+done
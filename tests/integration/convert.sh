@@ -17,7 +17,7 @@ function finish {
 }
 trap finish EXIT
 
-FORMATS="villas.human csv tsv json opal.asyncip"
+FORMATS="villas.human villas.binary csv tsv json opal.asyncip"
 
 villas signal -v5 -n -l20 mixed > input.dat
 
@@ -28,6 +28,8 @@ for FORMAT in ${FORMATS}; do
     CMP_FLAGS=""
     if [ ${FORMAT} = "opal.asyncip" ]; then
         CMP_FLAGS+=-T
+    elif [ ${FORMAT} = "villas.binary" ]; then
+        CMP_FLAGS+="-e 1e-5" # Values are encoded in single-precision
     fi
 
     villas compare ${CMP_FLAGS} input.dat output.dat
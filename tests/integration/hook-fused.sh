@@ -0,0 +1,114 @@
+#!/usr/bin/env bash
+#
+# Integration test for fused elementwise hooks.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+cat > input.dat <<EOF
+# seconds.nanoseconds(sequence)	signal0	signal1	signal2	signal3	signal4
+1551015508.801653200(0)	0.022245	0.000000	-1.000000	1.000000	0.000000
+1551015508.901653200(1)	0.015339	0.587785	-1.000000	0.600000	0.100000
+1551015509.001653200(2)	0.027500	0.951057	-1.000000	0.200000	0.200000
+1551015509.101653200(3)	0.040320	0.951057	-1.000000	-0.200000	0.300000
+1551015509.201653200(4)	0.026079	0.587785	-1.000000	-0.600000	0.400000
+1551015509.301653200(5)	0.049262	0.000000	1.000000	-1.000000	0.500000
+1551015509.401653200(6)	0.014883	-0.587785	1.000000	-0.600000	0.600000
+1551015509.501653200(7)	0.023232	-0.951057	1.000000	-0.200000	0.700000
+1551015509.601653200(8)	0.015231	-0.951057	1.000000	0.200000	0.800000
+1551015509.701653200(9)	0.060849	-0.587785	1.000000	0.600000	0.900000
+EOF
+
+cat > expect.dat <<EOF
+# seconds.nanoseconds(sequence)	signal0	signal1	signal2	signal3	signal4
+1551015508.801653200(0)	0.022245	5.000000	-95	1.000000	0.000000
+1551015508.901653200(1)	0.015339	50.000000	-95	0.600000	0.100000
+1551015509.001653200(2)	0.027500	50.000000	-95	0.200000	0.200000
+1551015509.101653200(3)	0.040320	50.000000	-95	-0.200000	0.300000
+1551015509.201653200(4)	0.026079	50.000000	-95	-0.600000	0.400000
+1551015509.301653200(5)	0.049262	5.000000	105	-1.000000	0.500000
+1551015509.401653200(6)	0.014883	-50.000000	105	-0.600000	0.600000
+1551015509.501653200(7)	0.023232	-50.000000	105	-0.200000	0.700000
+1551015509.601653200(8)	0.015231	-50.000000	105	0.200000	0.800000
+1551015509.701653200(9)	0.060849	-50.000000	105	0.600000	0.900000
+EOF
+
+# Run the same chain once fused and once with every hook acting as a barrier
+for FUSE in true false; do
+
+cat > config.json <<EOF
+{
+    "idle_stop": true,
+    "nodes": {
+        "input": {
+            "type": "file",
+            "uri": "input.dat",
+            "in": {
+                "signals": "5f",
+                "epoch_mode": "original",
+                "eof": "stop"
+            }
+        },
+        "output": {
+            "type": "file",
+            "uri": "output-${FUSE}.dat"
+        }
+    },
+    "paths": [
+        {
+            "in": "input",
+            "out": "output",
+            "hooks": [
+                {
+                    "type": "scale",
+                    "fuse": ${FUSE},
+
+                    "signals": [ "signal1", "signal2" ],
+                    "scale": 100,
+                    "offset": 5
+                },
+                {
+                    "type": "round",
+                    "fuse": ${FUSE},
+
+                    "signals": [ "signal1", "signal2" ],
+                    "precision": 1
+                },
+                {
+                    "type": "limit_value",
+                    "fuse": ${FUSE},
+
+                    "signal": "signal1",
+                    "min": -50,
+                    "max": 50
+                },
+                {
+                    "type": "cast",
+                    "fuse": ${FUSE},
+
+                    "signal": "signal2",
+                    "new_type": "integer"
+                }
+            ]
+        }
+    ]
+}
+EOF
+
+villas node config.json
+
+villas compare output-${FUSE}.dat expect.dat
+
+done
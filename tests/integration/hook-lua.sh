@@ -57,6 +57,9 @@ cat > expect.dat <<EOF
 1551015509.701653200+6.430676e+07(9)	0	0.587785	145.000000	9	1551015509.701653
 EOF
 
-villas hook lua -c config.json < input.dat > output.dat
+# Natively compiled expressions must yield the same results as Lua
+for NATIVE in true false; do
+    villas hook lua -c config.json -o native=${NATIVE} < input.dat > output.dat
 
-villas compare output.dat expect.dat
+    villas compare output.dat expect.dat
+done
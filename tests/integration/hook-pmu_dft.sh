@@ -0,0 +1,62 @@
+#!/usr/bin/env bash
+#
+# Integration test for the DFT engines of the pmu_dft hook.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+# Usage: config ENGINE [RESYNC]
+function config {
+    local resync=${2:+"\"dft_resync\": $2,"}
+
+    cat <<EOF
+{
+    "signals": [ "sine" ],
+    "sample_rate": 1000,
+    "dft_rate": 10,
+    "start_freqency": 49.5,
+    "end_freqency": 50.5,
+    "frequency_resolution": 0.1,
+    "window_type": "hann",
+    "padding_type": "zero",
+    "frequency_estimate_type": "quadratic",
+    ${resync}
+    "dft_engine": "$1"
+}
+EOF
+}
+
+# Usage: check SAMPLES [RESYNC]
+function check {
+    config matrix > matrix.json
+    config sliding $2 > sliding.json
+
+    villas signal -r 1000 -l $1 -n -F 50.02 sine > input.dat
+
+    villas hook -c matrix.json pmu_dft < input.dat > expect.dat
+    villas hook -c sliding.json pmu_dft < input.dat > output.dat
+
+    # Both engines must yield the same phasors
+    villas compare -e 1e-6 output.dat expect.dat
+}
+
+# Frequent resynchronization
+check 5000 2
+
+# Default interval of 100 windows, spanning ten resynchronizations
+check 100000
+
+# Large interval: the recursive update must not drift over 1000 windows
+check 100000 1000
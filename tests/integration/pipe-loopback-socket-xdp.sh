@@ -0,0 +1,104 @@
+#!/usr/bin/env bash
+#
+# Integration loopback test for villas pipe using the AF_XDP socket layer.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+if [ "${EUID}" -ne 0 ] || [ -n "${CI}" ]; then
+    echo "Test requires root permissions"
+    exit 99
+fi
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+IF1=villas-xdp0
+IF2=villas-xdp1
+
+function finish {
+    ip link delete ${IF1} 2> /dev/null || true
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+# Frames sent on one end of a veth pair are received on the other one
+ip link add ${IF1} type veth peer name ${IF2}
+ip link set ${IF1} up
+ip link set ${IF2} up
+
+MAC1=$(cat /sys/class/net/${IF1}/address)
+MAC2=$(cat /sys/class/net/${IF2}/address)
+
+NUM_SAMPLES=${NUM_SAMPLES:-100}
+NUM_VALUES=${NUM_VALUES:-4}
+FORMAT=${FORMAT:-villas.binary}
+VECTORIZES="1 10"
+
+for VECTORIZE in ${VECTORIZES}; do
+
+cat > config.json << EOF2
+{
+    "nodes": {
+        "node1": {
+             "type": "socket",
+
+             "vectorize": ${VECTORIZE},
+             "format": "${FORMAT}",
+             "layer": "xdp",
+
+             "xdp": {
+             	"mode": "copy"
+             },
+
+             "out": {
+             	"address": "${MAC2}%${IF1}:34997"
+             },
+             "in": {
+             	"address": "${MAC1}%${IF1}:34997"
+             }
+        },
+        "node2": {
+             "type": "socket",
+
+             "vectorize": ${VECTORIZE},
+             "format": "${FORMAT}",
+             "layer": "xdp",
+
+             "xdp": {
+             	"mode": "copy"
+             },
+
+             "out": {
+             	"address": "${MAC1}%${IF2}:34997"
+             },
+             "in": {
+             	"address": "${MAC2}%${IF2}:34997",
+             	"signals": {
+             		"count": ${NUM_VALUES},
+             		"type": "float"
+             	}
+             }
+        }
+    }
+}
+EOF2
+
+villas signal -v ${NUM_VALUES} -l ${NUM_SAMPLES} -n random > input.dat
+
+villas pipe -r -l ${NUM_SAMPLES} config.json node2 > output.dat &
+
+# Wait for the receiver to attach its XDP program
+sleep 1
+
+villas pipe -s config.json node1 < input.dat
+
+wait $!
+
+villas compare ${CMPFLAGS} input.dat output.dat
+
+done
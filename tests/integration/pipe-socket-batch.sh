@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+#
+# Integration test for the batched receive mode of the socket node.
+#
+# The sender packs several samples into each datagram while the receiver
+# reads fewer samples per call than a single recvmmsg() returns.
+#
+# Author: Steffen Vogel <post@steffenvogel.de>
+# SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+# SPDX-License-Identifier: Apache-2.0
+
+set -e
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+    popd
+    rm -rf ${DIR}
+}
+trap finish EXIT
+
+NUM_SAMPLES=${NUM_SAMPLES:-1000}
+NUM_VALUES=${NUM_VALUES:-4}
+FORMAT=${FORMAT:-villas.binary}
+
+# Usage: config SENDER_BATCH RECEIVER_BATCH
+function config {
+    cat <<EOF
+{
+    "nodes": {
+        "tx": {
+             "type": "socket",
+             "format": "${FORMAT}",
+             "layer": "udp",
+             "batch": $1,
+
+             "out": {
+             	"address": "127.0.0.1:12001",
+             	"vectorize": 10
+             },
+             "in": {
+             	"address": "127.0.0.1:12000"
+             }
+        },
+        "rx": {
+             "type": "socket",
+             "format": "${FORMAT}",
+             "layer": "udp",
+             "batch": $2,
+
+             "out": {
+             	"address": "127.0.0.1:12000"
+             },
+             "in": {
+             	"address": "127.0.0.1:12001",
+             	"vectorize": 3,
+             	"signals": {
+             		"count": ${NUM_VALUES},
+             		"type": "float"
+             	}
+             }
+        }
+    }
+}
+EOF
+}
+
+# Datagrams with up to 10 samples each
+config '{ "enabled": false }' '{ }' > plain.json
+
+# Segments of a single datagram coalesced by UDP GRO
+config '{ "gso": true }' '{ "gro": true }' > gro.json
+
+villas signal -v ${NUM_VALUES} -l ${NUM_SAMPLES} -n random > input.dat
+
+for CONFIG in plain.json gro.json; do
+    # The receiver does not terminate if samples are lost
+    timeout 10 villas pipe -r -l ${NUM_SAMPLES} ${CONFIG} rx > output.dat &
+
+    # Wait for the receiver to bind its socket
+    sleep 1
+
+    villas pipe -s ${CONFIG} tx < input.dat
+
+    wait $!
+
+    villas compare ${CMPFLAGS} input.dat output.dat
+done
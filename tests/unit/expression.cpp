@@ -0,0 +1,118 @@
+/* Unit tests for natively compiled signal expressions.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+
+#include <criterion/criterion.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/expression.hpp>
+#include <villas/sample.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+static SignalList::Ptr make_signals() {
+  auto signals = std::make_shared<SignalList>();
+
+  signals->push_back(std::make_shared<Signal>("u", "V", SignalType::FLOAT));
+  signals->push_back(std::make_shared<Signal>("n", "", SignalType::INTEGER));
+  signals->push_back(std::make_shared<Signal>("b", "", SignalType::BOOLEAN));
+
+  return signals;
+}
+
+static struct Sample *make_sample(SignalList::Ptr signals) {
+  auto *smp = sample_alloc_mem(signals->size());
+
+  smp->length = signals->size();
+  smp->signals = signals;
+  smp->sequence = 7;
+  smp->flags = (int)SampleFlags::HAS_DATA | (int)SampleFlags::HAS_SEQUENCE;
+
+  smp->data[0].f = 1.5;
+  smp->data[1].i = -3;
+  smp->data[2].b = true;
+
+  return smp;
+}
+
+// cppcheck-suppress unknownMacro
+Test(expression, evaluate) {
+  auto signals = make_signals();
+  auto *smp = make_sample(signals);
+
+  cr_assert_float_eq(Expression("smp.data.u * 2 + 1", signals).evaluate(smp),
+                     4, 1e-9);
+  cr_assert_float_eq(Expression("smp.data['n'] ^ 2", signals).evaluate(smp),
+                     9, 1e-9);
+  cr_assert_float_eq(Expression("-2 ^ 2", signals).evaluate(smp), -4, 1e-9);
+  cr_assert_float_eq(Expression("2 ^ 3 ^ 2", signals).evaluate(smp), 512,
+                     1e-9);
+  cr_assert_float_eq(Expression("5.5 % -2", signals).evaluate(smp), -0.5,
+                     1e-9);
+  cr_assert_float_eq(
+      Expression("math.max(smp.data.n, 0, smp.data.u)", signals).evaluate(smp),
+      1.5, 1e-9);
+  cr_assert_float_eq(
+      Expression("math.sqrt(smp.data.u^2 + smp.data.n^2)", signals)
+          .evaluate(smp),
+      std::sqrt(1.5 * 1.5 + 9), 1e-9);
+  cr_assert_float_eq(Expression("smp.sequence + 1", signals).evaluate(smp), 8,
+                     1e-9);
+
+  cr_assert_float_eq(
+      Expression("smp.data[1] * smp.data[0]", signals, false).evaluate(smp),
+      -4.5, 1e-9);
+
+  sample_free(smp);
+}
+
+Test(expression, constant_folding) {
+  auto signals = make_signals();
+
+  Expression e1("(1 + 2) * math.pi / 3", signals);
+  cr_assert(e1.isConstant());
+  cr_assert_float_eq(e1.getProgram()[0].value, M_PI, 1e-9);
+
+  Expression e2("smp.data.u * (2 + 3)", signals);
+  cr_assert_not(e2.isConstant());
+  cr_assert_eq(e2.getProgram().size(), 3);
+}
+
+Test(expression, unsupported) {
+  auto signals = make_signals();
+
+  // These expressions must be evaluated by Lua
+  cr_assert_throw(Expression("smp.data.b", signals), RuntimeError);
+  cr_assert_throw(Expression("smp.data.x", signals), RuntimeError);
+  cr_assert_throw(Expression("smp.data[0]", signals), RuntimeError);
+  cr_assert_throw(Expression("smp.data.u", signals, false), RuntimeError);
+  cr_assert_throw(Expression("offset + 1", signals), RuntimeError);
+  cr_assert_throw(Expression("smp.data.u // 2", signals), RuntimeError);
+  cr_assert_throw(Expression("smp.data.u > 0 and 1 or 0", signals),
+                  RuntimeError);
+}
+
+Test(expression, missing) {
+  auto signals = make_signals();
+  auto *smp = make_sample(signals);
+
+  Expression e("smp.ts_origin[0] + smp.data.n", signals);
+
+  cr_assert_throw(e.evaluate(smp), RuntimeError);
+
+  smp->flags |= (int)SampleFlags::HAS_TS_ORIGIN;
+  smp->ts.origin.tv_sec = 10;
+
+  cr_assert_float_eq(e.evaluate(smp), 7, 1e-9);
+
+  smp->length = 1;
+  cr_assert_throw(e.evaluate(smp), RuntimeError);
+
+  sample_free(smp);
+}
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <cmath>
 #include <complex>
 #include <float.h>
 #include <stdio.h>
@@ -13,6 +14,9 @@
 #include <criterion/parameterized.h>
 
 #include <villas/format.hpp>
+#include <villas/formats/msg_format.hpp>
+#include <villas/formats/msg_kernels.hpp>
+#include <villas/formats/raw.hpp>
 #include <villas/log.hpp>
 #include <villas/pool.hpp>
 #include <villas/sample.hpp>
@@ -29,6 +33,10 @@ extern void init_memory();
 
 #define NUM_VALUES 10
 
+#define BENCH_VALUES 1000
+#define BENCH_SAMPLES 64
+#define BENCH_RUNS 100
+
 using string =
     std::basic_string<char, std::char_traits<char>, criterion::allocator<char>>;
 
@@ -221,13 +229,18 @@ ParameterizedTestParameters(format, lowlevel) {
       "{ \"type\": \"raw\", \"bits\": 64, \"endianess\": \"little\" }", 1, 64);
   params.emplace_back("{ \"type\": \"villas.human\" }", 10, 0);
   params.emplace_back("{ \"type\": \"villas.binary\" }", 10, 0);
+  params.emplace_back("{ \"type\": \"villas.binary\", \"version\": 3 }", 10,
+                      0);
+  params.emplace_back("{ \"type\": \"villas.web\", \"version\": 3 }", 10, 0);
+  params.emplace_back("{ \"type\": \"villas.compressed\" }", 10, 0);
   params.emplace_back("{ \"type\": \"csv\" }", 10, 0);
   params.emplace_back("{ \"type\": \"tsv\" }", 10, 0);
   params.emplace_back("{ \"type\": \"json\" }", 10, 0);
   // params.emplace_back("{ \"type\": \"json.kafka\" }",					10, 0); # broken due to signal names
   // params.emplace_back("{ \"type\": \"json.reserve\" }",				10, 0);
-#ifdef PROTOBUF_FOUND
   params.emplace_back("{ \"type\": \"protobuf\" }", 10, 0);
+#ifdef ARROW_FOUND
+  params.emplace_back("{ \"type\": \"arrow\" }", 10, 0);
 #endif
 
   return params;
@@ -314,13 +327,18 @@ ParameterizedTestParameters(format, highlevel) {
       "{ \"type\": \"raw\", \"bits\": 64, \"endianess\": \"little\" }", 1, 64);
   params.emplace_back("{ \"type\": \"villas.human\" }", 10, 0);
   params.emplace_back("{ \"type\": \"villas.binary\" }", 10, 0);
+  params.emplace_back("{ \"type\": \"villas.binary\", \"version\": 3 }", 10,
+                      0);
+  params.emplace_back("{ \"type\": \"villas.web\", \"version\": 3 }", 10, 0);
+  params.emplace_back("{ \"type\": \"villas.compressed\" }", 10, 0);
   params.emplace_back("{ \"type\": \"csv\" }", 10, 0);
   params.emplace_back("{ \"type\": \"tsv\" }", 10, 0);
   params.emplace_back("{ \"type\": \"json\" }", 10, 0);
   // params.emplace_back("{ \"type\": \"json.kafka\" }",					10, 0); # broken due to signal names
   // params.emplace_back("{ \"type\": \"json.reserve\" }",				10, 0);
-#ifdef PROTOBUF_FOUND
   params.emplace_back("{ \"type\": \"protobuf\" }", 10, 0);
+#ifdef ARROW_FOUND
+  params.emplace_back("{ \"type\": \"arrow\" }", 10, 0);
 #endif
 
   return params;
@@ -378,6 +396,9 @@ ParameterizedTest(Param *p, format, highlevel, .init = init_memory) {
   cnt = fmt->print(stream, smps, p->cnt);
   cr_assert_eq(cnt, p->cnt, "Written only %d of %d samples", cnt, p->cnt);
 
+  ret = fmt->finish(stream);
+  cr_assert_eq(ret, 0);
+
   ret = fflush(stream);
   cr_assert_eq(ret, 0);
 
@@ -421,3 +442,766 @@ ParameterizedTest(Param *p, format, highlevel, .init = init_memory) {
   ret = pool_destroy(&pool);
   cr_assert_eq(ret, 0);
 }
+
+// Compare the throughput of all kernels supported by the CPU
+Test(format, villas_binary_kernels, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  size_t wbytes, rbytes;
+
+  Logger logger = Log::get("test:format:villas_binary_kernels");
+
+  struct Pool pool;
+  struct Sample *smps[BENCH_SAMPLES];
+  struct Sample *smpt[BENCH_SAMPLES];
+
+  std::vector<char> buf(BENCH_SAMPLES * MSG_LEN(BENCH_VALUES));
+
+  ret = pool_init(&pool, 2 * BENCH_SAMPLES, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  ret = sample_alloc_many(&pool, smpt, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  auto signals = std::make_shared<SignalList>(BENCH_VALUES, SignalType::FLOAT);
+
+  fill_sample_data(signals, smps, BENCH_SAMPLES);
+
+  json_t *json_format = json_pack("{ s: s }", "type", "villas.binary");
+  cr_assert_not_null(json_format);
+
+  auto *fmt = FormatFactory::make(json_format);
+  cr_assert_not_null(fmt);
+
+  fmt->start(signals, (int)SampleFlags::ALL);
+
+  for (auto *k : msg_kernels_supported()) {
+    double sprint_time = 0, sscan_time = 0;
+
+    msg_kernels_set(k);
+
+    for (unsigned r = 0; r < BENCH_RUNS; r++) {
+      auto start = time_now();
+
+      cnt = fmt->sprint(buf.data(), buf.size(), &wbytes, smps, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto mid = time_now();
+
+      cnt = fmt->sscan(buf.data(), wbytes, &rbytes, smpt, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto end = time_now();
+
+      sprint_time += time_delta(&start, &mid);
+      sscan_time += time_delta(&mid, &end);
+    }
+
+    for (unsigned i = 0; i < cnt; i++)
+      cr_assert_eq_sample(smps[i], smpt[i], fmt->getFlags());
+
+    double total_smps = BENCH_RUNS * BENCH_SAMPLES;
+    double total_bytes = BENCH_RUNS * wbytes;
+
+    logger->info("kernels={}: sprint={:.0f} samples/s, {:.1f} MB/s, "
+                 "sscan={:.0f} samples/s, {:.1f} MB/s",
+                 k->name, total_smps / sprint_time,
+                 total_bytes / sprint_time / 1e6, total_smps / sscan_time,
+                 total_bytes / sscan_time / 1e6);
+  }
+
+  msg_kernels_set(nullptr);
+
+  delete fmt;
+
+  sample_free_many(smps, BENCH_SAMPLES);
+  sample_free_many(smpt, BENCH_SAMPLES);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// Version 3 batches must interoperate with version 2 messages
+Test(format, villas_binary_batch, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  size_t wbytes, rbytes, v2bytes;
+  const unsigned num = 32;
+
+  Logger logger = Log::get("test:format:villas_binary_batch");
+
+  struct Pool pool;
+  struct Sample *smps[num];
+  struct Sample *smpt[num];
+
+  char buf[2 * num * MSG_LEN(8)];
+
+  ret = pool_init(&pool, 2 * num, SAMPLE_LENGTH(8));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, num);
+  cr_assert_eq(ret, num);
+
+  ret = sample_alloc_many(&pool, smpt, num);
+  cr_assert_eq(ret, num);
+
+  auto signals = std::make_shared<SignalList>("6f2i");
+
+  fill_sample_data(signals, smps, num);
+
+  Format *fmts[3];
+  const char *versions[] = {"2", "3", "\"auto\""};
+  for (unsigned i = 0; i < ARRAY_LEN(fmts); i++) {
+    auto config =
+        fmt::format("{{ \"type\": \"villas.binary\", \"version\": {} }}",
+                    versions[i]);
+
+    json_t *json_format = json_loads(config.c_str(), 0, nullptr);
+    cr_assert_not_null(json_format);
+
+    fmts[i] = FormatFactory::make(json_format);
+    cr_assert_not_null(fmts[i]);
+
+    fmts[i]->start(signals, (int)SampleFlags::ALL);
+  }
+
+  auto *v2 = fmts[0], *v3 = fmts[1], *autov = fmts[2];
+
+  cnt = v2->sprint(buf, sizeof(buf), &v2bytes, smps, num);
+  cr_assert_eq(cnt, num);
+  cr_assert_eq(v2bytes, num * MSG_LEN(8));
+
+  // The negotiating format starts with version 2
+  cnt = autov->sprint(buf, sizeof(buf), &wbytes, smps, num);
+  cr_assert_eq(cnt, num);
+  cr_assert_eq(wbytes, v2bytes);
+
+  // Batches are accepted by all decoders
+  for (auto *fmt : fmts) {
+    // Periodic samples share a single batch
+    cnt = v3->sprint(buf, sizeof(buf), &wbytes, smps, num);
+    cr_assert_eq(cnt, num);
+    cr_assert_eq(wbytes, MSG_BATCH_LEN(num, 8));
+
+    // sscan() converts the byte-order in place
+    cnt = fmt->sscan(buf, wbytes, &rbytes, smpt, num);
+    cr_assert_eq(cnt, num);
+    cr_assert_eq(rbytes, wbytes);
+
+    for (unsigned i = 0; i < cnt; i++)
+      cr_assert_eq_sample(smps[i], smpt[i], fmt->getFlags());
+  }
+
+  logger->info("Payload size for {} samples: v2={} bytes, v3={} bytes", num,
+               v2bytes, wbytes);
+
+  // A gap in the sequence numbers and in the timestamps start new batches
+  for (unsigned i = 10; i < num; i++) {
+    smps[i]->sequence += 5;
+
+    if (i >= 20)
+      smps[i]->ts.origin.tv_sec += 10;
+  }
+
+  cnt = v3->sprint(buf, sizeof(buf), &wbytes, smps, num);
+  cr_assert_eq(cnt, num);
+  cr_assert_eq(wbytes,
+               MSG_BATCH_LEN(num, 8) + 2 * sizeof(struct MessageBatch));
+
+  // Version 2 messages may follow batches in the same buffer
+  size_t v3bytes = wbytes;
+
+  cnt = v2->sprint(buf + v3bytes, sizeof(buf) - v3bytes, &wbytes, smps, 4);
+  cr_assert_eq(cnt, 4);
+
+  cnt = v2->sscan(buf, v3bytes + wbytes, &rbytes, smpt, num);
+  cr_assert_eq(cnt, num);
+  cr_assert_eq(rbytes, v3bytes);
+
+  for (unsigned i = 0; i < cnt; i++)
+    cr_assert_eq_sample(smps[i], smpt[i], v2->getFlags());
+
+  cnt = v2->sscan(buf + v3bytes, wbytes, &rbytes, smpt, num);
+  cr_assert_eq(cnt, 4);
+
+  // The negotiating format follows the version of received messages
+  cnt = autov->sprint(buf, sizeof(buf), &wbytes, smps, 4);
+  cr_assert_eq(wbytes, MSG_BATCH_LEN(4, 8));
+
+  cnt = v2->sprint(buf, sizeof(buf), &wbytes, smps, 4);
+  cnt = autov->sscan(buf, wbytes, &rbytes, smpt, num);
+  cr_assert_eq(cnt, 4);
+
+  cnt = autov->sprint(buf, sizeof(buf), &wbytes, smps, 4);
+  cr_assert_eq(wbytes, 4 * MSG_LEN(8));
+
+  // Batches in a stream are split if fewer samples are requested
+  FILE *f = tmpfile();
+  cr_assert_not_null(f);
+
+  cnt = v3->print(f, smps, num);
+  cr_assert_eq(cnt, num);
+
+  rewind(f);
+
+  for (unsigned i = 0; i < num; i += cnt) {
+    cnt = v2->scan(f, smpt, 5);
+    cr_assert_eq(cnt, MIN(5, num - i));
+
+    for (unsigned k = 0; k < cnt; k++)
+      cr_assert_eq_sample(smps[i + k], smpt[k], v2->getFlags());
+  }
+
+  cr_assert(v2->eof(f));
+
+  fclose(f);
+
+  for (auto *fmt : fmts)
+    delete fmt;
+
+  sample_free_many(smps, num);
+  sample_free_many(smpt, num);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+Test(format, json_direct, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  size_t wbytes, rbytes;
+
+  Logger logger = Log::get("test:format:json_direct");
+
+  struct Pool pool;
+  struct Sample *smps[BENCH_SAMPLES];
+  struct Sample *smpt[BENCH_SAMPLES];
+
+  std::vector<char> buf(BENCH_SAMPLES * BENCH_VALUES * 32);
+  std::vector<char> expected;
+
+  ret = pool_init(&pool, 2 * BENCH_SAMPLES, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  ret = sample_alloc_many(&pool, smpt, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  auto signals = std::make_shared<SignalList>(BENCH_VALUES, SignalType::FLOAT);
+
+  fill_sample_data(signals, smps, BENCH_SAMPLES);
+
+  // The jansson-based implementation comes first and serves as reference
+  for (auto direct : {false, true}) {
+    double sprint_time = 0, sscan_time = 0;
+
+    json_t *json_format =
+        json_pack("{ s: s, s: b }", "type", "json", "direct", direct);
+    cr_assert_not_null(json_format);
+
+    auto *fmt = FormatFactory::make(json_format);
+    cr_assert_not_null(fmt);
+
+    fmt->start(signals, (int)SampleFlags::ALL);
+
+    for (unsigned r = 0; r < BENCH_RUNS; r++) {
+      auto start = time_now();
+
+      cnt = fmt->sprint(buf.data(), buf.size(), &wbytes, smps, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto mid = time_now();
+
+      cnt = fmt->sscan(buf.data(), wbytes, &rbytes, smpt, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto end = time_now();
+
+      sprint_time += time_delta(&start, &mid);
+      sscan_time += time_delta(&mid, &end);
+    }
+
+    for (unsigned i = 0; i < cnt; i++)
+      cr_assert_eq_sample(smps[i], smpt[i], fmt->getFlags());
+
+    // Both implementations must produce identical payloads
+    if (direct) {
+      cr_assert_eq(wbytes, expected.size());
+      cr_assert_arr_eq(buf.data(), expected.data(), wbytes);
+    } else
+      expected.assign(buf.data(), buf.data() + wbytes);
+
+    double total_smps = BENCH_RUNS * BENCH_SAMPLES;
+    double total_bytes = BENCH_RUNS * wbytes;
+
+    logger->info("direct={}: sprint={:.0f} samples/s, {:.1f} MB/s, "
+                 "sscan={:.0f} samples/s, {:.1f} MB/s",
+                 direct, total_smps / sprint_time,
+                 total_bytes / sprint_time / 1e6, total_smps / sscan_time,
+                 total_bytes / sscan_time / 1e6);
+
+    delete fmt;
+  }
+
+  sample_free_many(smps, BENCH_SAMPLES);
+  sample_free_many(smpt, BENCH_SAMPLES);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// Compare the size and throughput of binary formats for slowly changing data
+Test(format, villas_compressed_ratio, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  size_t wbytes, rbytes;
+
+  Logger logger = Log::get("test:format:villas_compressed_ratio");
+
+  struct Pool pool;
+  struct Sample *smps[BENCH_SAMPLES];
+  struct Sample *smpt[BENCH_SAMPLES];
+
+  std::vector<char> buf(BENCH_SAMPLES * MSG_LEN(BENCH_VALUES) * 2);
+
+  ret = pool_init(&pool, 2 * BENCH_SAMPLES, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  ret = sample_alloc_many(&pool, smpt, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  auto signals = std::make_shared<SignalList>(BENCH_VALUES, SignalType::FLOAT);
+
+  fill_sample_data(signals, smps, BENCH_SAMPLES);
+
+  // Voltages measured by a 12-bit ADC
+  for (unsigned i = 0; i < BENCH_SAMPLES; i++) {
+    for (unsigned j = 0; j < BENCH_VALUES; j++)
+      smps[i]->data[j].f =
+          round(2048 * sin(2 * M_PI * 50 * i * 50e-6 + j)) / 2048 * 230;
+  }
+
+  std::vector<const char *> types = {"villas.binary", "villas.compressed",
+                                     "protobuf"};
+
+  size_t reference = 0;
+  for (auto *type : types) {
+    double sprint_time = 0, sscan_time = 0;
+
+    json_t *json_format = json_pack("{ s: s }", "type", type);
+    cr_assert_not_null(json_format);
+
+    auto *fmt = FormatFactory::make(json_format);
+    cr_assert_not_null(fmt);
+
+    fmt->start(signals, (int)SampleFlags::ALL);
+
+    for (unsigned r = 0; r < BENCH_RUNS; r++) {
+      auto start = time_now();
+
+      cnt = fmt->sprint(buf.data(), buf.size(), &wbytes, smps, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto mid = time_now();
+
+      cnt = fmt->sscan(buf.data(), wbytes, &rbytes, smpt, BENCH_SAMPLES);
+      cr_assert_eq(cnt, BENCH_SAMPLES);
+
+      auto end = time_now();
+
+      sprint_time += time_delta(&start, &mid);
+      sscan_time += time_delta(&mid, &end);
+    }
+
+    for (unsigned i = 0; i < cnt; i++)
+      cr_assert_eq_sample(smps[i], smpt[i], fmt->getFlags());
+
+    if (!reference)
+      reference = wbytes;
+
+    double total_smps = BENCH_RUNS * BENCH_SAMPLES;
+
+    logger->info("type={}: bytes={}, ratio={:.2f}, sprint={:.0f} samples/s, "
+                 "sscan={:.0f} samples/s",
+                 type, wbytes, (double)reference / wbytes,
+                 total_smps / sprint_time, total_smps / sscan_time);
+
+    delete fmt;
+  }
+
+  sample_free_many(smps, BENCH_SAMPLES);
+  sample_free_many(smpt, BENCH_SAMPLES);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// Frames in a stream are split if fewer samples are requested
+Test(format, villas_compressed_stream, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  const unsigned num = 17, first = 10;
+
+  struct Pool pool;
+  struct Sample *smps[num];
+  struct Sample *smpt[num];
+
+  ret = pool_init(&pool, 2 * num, SAMPLE_LENGTH(NUM_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, num);
+  cr_assert_eq(ret, num);
+
+  ret = sample_alloc_many(&pool, smpt, num);
+  cr_assert_eq(ret, num);
+
+  auto signals = std::make_shared<SignalList>("6f2i2b");
+
+  fill_sample_data(signals, smps, num);
+
+  json_t *json_format = json_pack("{ s: s }", "type", "villas.compressed");
+  cr_assert_not_null(json_format);
+
+  auto *fmt = FormatFactory::make(json_format);
+  cr_assert_not_null(fmt);
+
+  fmt->start(signals, (int)SampleFlags::ALL);
+
+  FILE *f = tmpfile();
+  cr_assert_not_null(f);
+
+  // Two frames with 10 and 7 samples
+  cnt = fmt->print(f, smps, first);
+  cr_assert_eq(cnt, first);
+
+  cnt = fmt->print(f, smps + first, num - first);
+  cr_assert_eq(cnt, num - first);
+
+  // The file node scans a single sample at a time
+  for (unsigned request : {1, 3}) {
+    rewind(f);
+
+    for (unsigned i = 0; i < num; i += cnt) {
+      cnt = fmt->scan(f, smpt, request);
+      cr_assert_gt(cnt, 0, "Lost samples after %u of %u", i, num);
+      cr_assert_leq(cnt, request);
+
+      for (unsigned k = 0; k < cnt; k++)
+        cr_assert_eq_sample(smps[i + k], smpt[k], fmt->getFlags());
+    }
+
+    cr_assert(fmt->eof(f));
+  }
+
+  fclose(f);
+
+  delete fmt;
+
+  sample_free_many(smps, num);
+  sample_free_many(smpt, num);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// Compare the throughput of text formats with and without a fixed precision
+Test(format, text_throughput, .init = init_memory) {
+  int ret;
+  unsigned cnt;
+  size_t wbytes, rbytes;
+
+  Logger logger = Log::get("test:format:text_throughput");
+
+  struct Pool pool;
+  struct Sample *smps[BENCH_SAMPLES];
+  struct Sample *smpt[BENCH_SAMPLES];
+
+  std::vector<char> buf(BENCH_SAMPLES * BENCH_VALUES * 40);
+
+  ret = pool_init(&pool, 2 * BENCH_SAMPLES, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  ret = sample_alloc_many(&pool, smpt, BENCH_SAMPLES);
+  cr_assert_eq(ret, BENCH_SAMPLES);
+
+  auto signals = std::make_shared<SignalList>(BENCH_VALUES, SignalType::FLOAT);
+
+  fill_sample_data(signals, smps, BENCH_SAMPLES);
+
+  for (unsigned i = 0; i < BENCH_SAMPLES; i++) {
+    for (unsigned j = 0; j < BENCH_VALUES; j++)
+      smps[i]->data[j].f = 230 * sin(2 * M_PI * 50 * i * 50e-6 + j);
+  }
+
+  for (auto *type : {"csv", "tsv", "villas.human"}) {
+    for (auto precision : {-1, 17}) {
+      double sprint_time = 0, sscan_time = 0;
+
+      json_t *json_format = json_pack("{ s: s, s: i }", "type", type,
+                                      "real_precision", precision);
+      cr_assert_not_null(json_format);
+
+      auto *fmt = FormatFactory::make(json_format);
+      cr_assert_not_null(fmt);
+
+      fmt->start(signals, (int)SampleFlags::ALL);
+
+      for (unsigned r = 0; r < BENCH_RUNS; r++) {
+        auto start = time_now();
+
+        cnt = fmt->sprint(buf.data(), buf.size(), &wbytes, smps, BENCH_SAMPLES);
+        cr_assert_eq(cnt, BENCH_SAMPLES);
+
+        auto mid = time_now();
+
+        cnt = fmt->sscan(buf.data(), wbytes, &rbytes, smpt, BENCH_SAMPLES);
+        cr_assert_eq(cnt, BENCH_SAMPLES);
+
+        auto end = time_now();
+
+        sprint_time += time_delta(&start, &mid);
+        sscan_time += time_delta(&mid, &end);
+      }
+
+      // The shortest representation is lossless
+      if (precision < 0) {
+        for (unsigned i = 0; i < cnt; i++) {
+          for (unsigned j = 0; j < BENCH_VALUES; j++)
+            cr_assert_eq(smps[i]->data[j].f, smpt[i]->data[j].f);
+        }
+      }
+
+      double total_smps = BENCH_RUNS * BENCH_SAMPLES;
+      double total_bytes = BENCH_RUNS * wbytes;
+
+      logger->info("type={}, real_precision={}: sprint={:.0f} samples/s, "
+                   "{:.1f} MB/s, sscan={:.0f} samples/s, {:.1f} MB/s",
+                   type, precision, total_smps / sprint_time,
+                   total_bytes / sprint_time / 1e6, total_smps / sscan_time,
+                   total_bytes / sscan_time / 1e6);
+
+      delete fmt;
+    }
+  }
+
+  sample_free_many(smps, BENCH_SAMPLES);
+  sample_free_many(smpt, BENCH_SAMPLES);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// Exposes the generic implementation of the raw format for comparison
+class GenericRawFormat : public RawFormat {
+
+public:
+  using RawFormat::RawFormat;
+
+  virtual int sscan(const char *buf, size_t len, size_t *rbytes,
+                    struct Sample *const smps[], unsigned cnt) {
+    return sscanGeneric(buf, len, rbytes, smps, cnt);
+  }
+
+  virtual int sprint(char *buf, size_t len, size_t *wbytes,
+                     const struct Sample *const smps[], unsigned cnt) {
+    return sprintGeneric(buf, len, wbytes, smps, cnt);
+  }
+};
+
+// Compare the specialized codecs of the raw format with the generic one
+Test(format, raw_codecs, .init = init_memory) {
+  int ret;
+  size_t wbytes, rbytes;
+
+  Logger logger = Log::get("test:format:raw_codecs");
+
+  struct Pool pool;
+  struct Sample *smp, *smpt;
+
+  std::vector<char> buf(BENCH_VALUES * sizeof(double) + 64);
+  std::vector<char> expected;
+
+  ret = pool_init(&pool, 2, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  smp = sample_alloc(&pool);
+  cr_assert_not_null(smp);
+
+  smpt = sample_alloc(&pool);
+  cr_assert_not_null(smpt);
+
+  auto signals = std::make_shared<SignalList>(BENCH_VALUES, SignalType::FLOAT);
+
+  fill_sample_data(signals, &smp, 1);
+
+  // The first two are equivalent to the gtnet format
+  for (auto *config :
+       {"{ \"type\": \"raw\", \"bits\": 32, \"endianess\": \"big\" }",
+        "{ \"type\": \"raw\", \"bits\": 32, \"endianess\": \"big\", "
+        "\"fake\": true }",
+        "{ \"type\": \"raw\", \"bits\": 64 }"}) {
+    for (auto generic : {true, false}) {
+      double sprint_time = 0, sscan_time = 0;
+
+      json_t *json_format = json_loads(config, 0, nullptr);
+      cr_assert_not_null(json_format);
+
+      RawFormat *fmt;
+      if (generic) {
+        fmt = new GenericRawFormat((int)SampleFlags::HAS_DATA);
+        fmt->parse(json_format);
+      } else {
+        fmt = dynamic_cast<RawFormat *>(FormatFactory::make(json_format));
+        cr_assert_not_null(fmt);
+      }
+
+      fmt->start(signals, (int)SampleFlags::ALL);
+
+      for (unsigned r = 0; r < BENCH_RUNS * BENCH_SAMPLES; r++) {
+        auto start = time_now();
+
+        ret = fmt->sprint(buf.data(), buf.size(), &wbytes, &smp, 1);
+        cr_assert_eq(ret, 1);
+
+        auto mid = time_now();
+
+        ret = fmt->sscan(buf.data(), wbytes, &rbytes, &smpt, 1);
+        cr_assert_eq(ret, 1);
+
+        auto end = time_now();
+
+        sprint_time += time_delta(&start, &mid);
+        sscan_time += time_delta(&mid, &end);
+      }
+
+      cr_assert_eq_sample_raw(smp, smpt, fmt->getFlags(), 32);
+
+      // Both implementations must produce identical payloads
+      if (generic)
+        expected.assign(buf.data(), buf.data() + wbytes);
+      else {
+        cr_assert_eq(wbytes, expected.size());
+        cr_assert_arr_eq(buf.data(), expected.data(), wbytes);
+      }
+
+      double total_smps = BENCH_RUNS * BENCH_SAMPLES;
+
+      logger->info("format={}, generic={}: sprint={:.0f} samples/s, "
+                   "sscan={:.0f} samples/s",
+                   config, generic, total_smps / sprint_time,
+                   total_smps / sscan_time);
+
+      delete fmt;
+    }
+  }
+
+  sample_decref(smp);
+  sample_decref(smpt);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+// The vectors of sprintv() must contain the same payload as sprint()
+Test(format, sprintv, .init = init_memory) {
+  int ret;
+  size_t wbytes, vbytes;
+  const unsigned cnt = 4;
+
+  struct Pool pool;
+  struct Sample *smps[cnt];
+
+  std::vector<char> buf(BENCH_VALUES * sizeof(double) * cnt * 2);
+  std::vector<char> scratch(buf.size());
+  std::vector<char> joined;
+
+  struct iovec iov[2 * cnt];
+  size_t iovcnt;
+
+  ret = pool_init(&pool, cnt, SAMPLE_LENGTH(BENCH_VALUES));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, cnt);
+  cr_assert_eq(ret, cnt);
+
+  struct {
+    const char *config;
+    const char *dtypes;
+    bool inplace; // Values are referenced in the sample memory
+  } cases[] = {
+      {"{ \"type\": \"raw\", \"bits\": 64 }", "64f", true},
+      {"{ \"type\": \"raw\", \"bits\": 64, \"fake\": true }", "64i", true},
+      {"{ \"type\": \"raw\", \"bits\": 64, \"fake\": true }", "32f32i", false},
+      {"{ \"type\": \"raw\", \"bits\": 32, \"endianess\": \"big\" }", "64f",
+       false},
+      {"{ \"type\": \"villas.binary\" }", "64f", false},
+  };
+
+  for (auto &c : cases) {
+    auto signals = std::make_shared<SignalList>(c.dtypes);
+
+    fill_sample_data(signals, smps, cnt);
+
+    json_t *json_format = json_loads(c.config, 0, nullptr);
+    cr_assert_not_null(json_format);
+
+    auto *fmt = FormatFactory::make(json_format);
+    cr_assert_not_null(fmt);
+
+    fmt->start(signals, (int)SampleFlags::ALL);
+
+    ret = fmt->sprint(buf.data(), buf.size(), &wbytes, smps, cnt);
+    cr_assert_eq(ret, cnt);
+
+    iovcnt = ARRAY_LEN(iov);
+    ret = fmt->sprintv(scratch.data(), scratch.size(), &vbytes, iov, &iovcnt,
+                       smps, cnt);
+    cr_assert_eq(ret, cnt, "config=%s", c.config);
+    cr_assert_eq(vbytes, wbytes, "config=%s", c.config);
+
+    joined.clear();
+    for (size_t i = 0; i < iovcnt; i++) {
+      auto *base = (const char *)iov[i].iov_base;
+      joined.insert(joined.end(), base, base + iov[i].iov_len);
+
+      if (c.inplace)
+        continue;
+
+      // Everything must have been written to the scratch buffer
+      cr_assert(base >= scratch.data() &&
+                base + iov[i].iov_len <= scratch.data() + scratch.size());
+    }
+
+    cr_assert_eq(joined.size(), wbytes);
+    cr_assert_arr_eq(joined.data(), buf.data(), wbytes, "config=%s", c.config);
+
+    if (c.inplace) {
+      for (unsigned i = 0; i < cnt; i++) {
+        bool found = false;
+
+        for (size_t j = 0; j < iovcnt; j++)
+          found |= iov[j].iov_base == smps[i]->data;
+
+        cr_assert(found, "Values of sample %u are not referenced", i);
+      }
+    }
+
+    delete fmt;
+  }
+
+  sample_free_many(smps, cnt);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
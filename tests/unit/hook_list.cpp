@@ -0,0 +1,137 @@
+/* Unit tests for hook lists.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <criterion/criterion.h>
+
+#include <villas/hook.hpp>
+#include <villas/hook_list.hpp>
+#include <villas/pool.hpp>
+#include <villas/sample.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+// A hook which returns a predefined reason for each sequence number
+class ReasonHook : public Hook {
+
+public:
+  std::map<uint64_t, Reason> reasons;
+
+  SignalList::Ptr expected; // Signals of the samples passed to this hook
+  std::vector<uint64_t> seen;
+
+  ReasonHook(unsigned prio, std::map<uint64_t, Reason> r)
+      : Hook(nullptr, nullptr, (int)Hook::Flags::PATH, prio),
+        reasons(std::move(r)) {
+    fusable = false;
+  }
+
+  virtual Reason process(struct Sample *smp) {
+    cr_assert_eq(smp->signals, expected);
+
+    seen.push_back(smp->sequence);
+
+    auto it = reasons.find(smp->sequence);
+
+    return it != reasons.end() ? it->second : Reason::OK;
+  }
+};
+
+// cppcheck-suppress unknownMacro
+Test(hook_list, process, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  struct Sample *smps[6];
+
+  auto sigs = std::make_shared<SignalList>("2f");
+
+  auto first = std::make_shared<ReasonHook>(
+      1, std::map<uint64_t, Hook::Reason>{
+             {1, Hook::Reason::SKIP_SAMPLE},
+             {3, Hook::Reason::STOP_PROCESSING}});
+  auto second = std::make_shared<ReasonHook>(
+      2, std::map<uint64_t, Hook::Reason>{{4, Hook::Reason::SKIP_SAMPLE}});
+
+  HookList hl;
+  hl.push_back(second);
+  hl.push_back(first);
+
+  json_t *json_first = json_object(), *json_second = json_object();
+
+  first->parse(json_first);
+  second->parse(json_second);
+
+  hl.check();
+  hl.prepare(sigs, 0, nullptr, nullptr);
+
+  // Each hook works on its own copy of the signal list
+  first->expected = sigs;
+  second->expected = first->getSignals();
+  cr_assert_neq(first->getSignals(), second->getSignals());
+
+  ret = pool_init(&pool, 6, SAMPLE_LENGTH(2));
+  cr_assert_eq(ret, 0);
+
+  ret = sample_alloc_many(&pool, smps, 6);
+  cr_assert_eq(ret, 6);
+
+  for (unsigned i = 0; i < 6; i++) {
+    smps[i]->sequence = i;
+    smps[i]->signals = sigs;
+  }
+
+  ret = hl.process(smps, 6);
+  cr_assert_eq(ret, 4);
+
+  // Hooks see all samples which have been passed by their predecessor
+  cr_assert_eq(first->seen, std::vector<uint64_t>({0, 1, 2, 3, 4, 5}));
+  cr_assert_eq(second->seen, std::vector<uint64_t>({0, 2, 4, 5}));
+
+  // Stopped samples are kept, skipped samples are moved to the end
+  uint64_t expected[] = {0, 2, 3, 5, 4, 1};
+  for (unsigned i = 0; i < 6; i++)
+    cr_assert_eq(smps[i]->sequence, expected[i], "smps[%u]", i);
+
+  // The signals of each sample are those of the last hook which processed it
+  for (unsigned i = 0; i < 6; i++) {
+    auto sigs_expected = smps[i]->sequence == 1 || smps[i]->sequence == 3
+                             ? first->getSignals()
+                             : second->getSignals();
+
+    cr_assert_eq(smps[i]->signals, sigs_expected, "smps[%u]", i);
+  }
+
+  // If all samples are passed, the signals are updated as well
+  first->seen.clear();
+  second->seen.clear();
+
+  for (unsigned i = 0; i < 2; i++) {
+    smps[i]->sequence = 10 + i;
+    smps[i]->signals = sigs;
+  }
+
+  ret = hl.process(smps, 2);
+  cr_assert_eq(ret, 2);
+
+  cr_assert_eq(second->seen, std::vector<uint64_t>({10, 11}));
+  cr_assert_eq(smps[0]->signals, second->getSignals());
+  cr_assert_eq(smps[1]->signals, second->getSignals());
+
+  sample_decref_many(smps, 6);
+
+  json_decref(json_first);
+  json_decref(json_second);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
@@ -77,3 +77,61 @@ ParameterizedTest(struct param *p, pool, basic, .init = init_memory) {
   ret = pool_destroy(&pool);
   cr_assert_eq(ret, 0, "Failed to destroy pool");
 }
+
+Test(pool, cache, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  void *ptrs[64];
+
+  ret = pool_init(&pool, 64, 8, &memory::heap);
+  cr_assert_eq(ret, 0, "Failed to create pool");
+
+  ret = pool_cache_enable(&pool, 64);
+  cr_assert_neq(ret, 0, "Magazines must not exceed the pool size");
+
+  ret = pool_cache_enable(&pool, 8, 5);
+  cr_assert_neq(ret, 0, "Magazines of all threads must fit into the pool");
+
+  ret = pool_cache_enable(&pool, 8);
+  cr_assert_eq(ret, 0);
+
+  // First allocation refills the magazine from the queue
+  ret = pool_get_many(&pool, ptrs, 8);
+  cr_assert_eq(ret, 8);
+  cr_assert_eq(queue_available(&pool.queue), 56);
+
+  // Releasing fills the loaded magazine again
+  ret = pool_put_many(&pool, ptrs, 8);
+  cr_assert_eq(ret, 8);
+  cr_assert_eq(queue_available(&pool.queue), 56);
+
+  for (int i = 0; i < 10; i++) {
+    ret = pool_get_many(&pool, ptrs, 8);
+    cr_assert_eq(ret, 8);
+
+    ret = pool_put_many(&pool, ptrs, 8);
+    cr_assert_eq(ret, 8);
+  }
+
+  // The counters are published without flushing the magazines
+  cr_assert_geq(pool.cache_hits + pool.cache_misses, 22 - 8);
+
+  // All blocks are still reachable through the cache
+  ret = pool_get_many(&pool, ptrs, 64);
+  cr_assert_eq(ret, 64);
+
+  ret = pool_put_many(&pool, ptrs, 64);
+  cr_assert_eq(ret, 64);
+
+  pool_cache_flush(&pool);
+  cr_assert_eq(queue_available(&pool.queue), 64);
+
+  size_t hits = pool.cache_hits, misses = pool.cache_misses;
+  cr_assert_eq(hits + misses, 24);
+  cr_assert_eq(hits, 21);
+
+  Log::get("test:pool:cache")->info("hits={}, misses={}", hits, misses);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0, "Failed to destroy pool");
+}
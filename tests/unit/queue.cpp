@@ -5,12 +5,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <pthread.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <vector>
 
 #include <criterion/criterion.h>
 #include <criterion/parameterized.h>
@@ -313,6 +315,280 @@ ParameterizedTest(struct param *p, queue, multi_threaded, .timeout = 20,
 }
 #endif // _POSIX_BARRIERS
 
+struct bench_param {
+  int thread_count; // Number of producer and consumer threads each
+  int batch_size;
+  bool many;
+  int flags; // QueueFlags passed to queue_init()
+  intptr_t iter_count;
+  std::atomic<int> start;
+  struct CQueue queue;
+};
+
+static void *bench_producer(void *ctx) {
+  struct bench_param *p = (struct bench_param *)ctx;
+  std::vector<void *> ptrs(p->batch_size);
+
+  while (p->start == 0)
+    sched_yield();
+
+  for (intptr_t count = 0; count < p->iter_count;) {
+    int cnt = MIN(p->batch_size, p->iter_count - count);
+
+    for (int i = 0; i < cnt; i++)
+      ptrs[i] = (void *)(count + i);
+
+    int pushed = 0;
+    while (pushed < cnt) {
+      int ret = p->many
+                    ? queue_push_many(&p->queue, &ptrs[pushed], cnt - pushed)
+                    : queue_push(&p->queue, ptrs[pushed]);
+      if (ret > 0)
+        pushed += ret;
+      else
+        sched_yield(); // queue full, let other threads proceed
+    }
+
+    count += cnt;
+  }
+
+  return nullptr;
+}
+
+static void *bench_consumer(void *ctx) {
+  struct bench_param *p = (struct bench_param *)ctx;
+  std::vector<void *> ptrs(p->batch_size);
+
+  while (p->start == 0)
+    sched_yield();
+
+  for (intptr_t count = 0; count < p->iter_count;) {
+    int cnt = MIN(p->batch_size, p->iter_count - count);
+
+    int ret = p->many ? queue_pull_many(&p->queue, ptrs.data(), cnt)
+                      : queue_pull(&p->queue, &ptrs[0]);
+    if (ret > 0)
+      count += ret;
+    else
+      sched_yield(); // queue empty, let other threads proceed
+  }
+
+  return nullptr;
+}
+
+// Compare throughput of batched and single-cell operations
+Test(queue, batch_throughput, .timeout = 60, .init = init_memory) {
+  int ret;
+  struct Tsc tsc;
+
+  Logger logger = Log::get("test:queue:batch_throughput");
+
+  ret = tsc_init(&tsc);
+  cr_assert(!ret);
+
+  for (int thread_count : {1, 2, 4, 8}) {
+    uint64_t cycles[2];
+
+    for (bool many : {false, true}) {
+      auto *p = new struct bench_param;
+
+      p->thread_count = thread_count;
+      p->batch_size = 64;
+      p->many = many;
+      p->flags = 0;
+      p->iter_count = 1 << 14;
+      p->start = 0;
+
+      ret = queue_init(&p->queue, 1 << 10, &memory::heap, p->flags);
+      cr_assert_eq(ret, 0, "Failed to create queue");
+
+      std::vector<pthread_t> producers(thread_count), consumers(thread_count);
+
+      for (int i = 0; i < thread_count; i++) {
+        pthread_create(&producers[i], nullptr, bench_producer, p);
+        pthread_create(&consumers[i], nullptr, bench_consumer, p);
+      }
+
+      uint64_t start_tsc_time = tsc_now(&tsc);
+      p->start = 1;
+
+      for (int i = 0; i < thread_count; i++) {
+        pthread_join(producers[i], nullptr);
+        pthread_join(consumers[i], nullptr);
+      }
+
+      cycles[many] = tsc_now(&tsc) - start_tsc_time;
+
+      ret = queue_available(&p->queue);
+      cr_assert_eq(ret, 0);
+
+      ret = queue_destroy(&p->queue);
+      cr_assert_eq(ret, 0, "Failed to destroy queue");
+
+      delete p;
+    }
+
+    double ops = 2.0 * thread_count * (1 << 14);
+
+    logger->info("threads={}+{}: single={:.1f} cycles/op, many={:.1f} "
+                 "cycles/op, speedup={:.2f}",
+                 thread_count, thread_count, cycles[0] / ops, cycles[1] / ops,
+                 (double)cycles[0] / cycles[1]);
+  }
+}
+
+struct mpmc_param {
+  int producer_count;
+  int consumer_count;
+  int batch_size;
+  intptr_t iter_count; // Number of values pushed by each producer
+  std::atomic<int> start;
+  std::atomic<intptr_t> pulled;
+  std::atomic<int> errors;
+  std::vector<std::atomic<int>> seen;
+  struct CQueue queue;
+};
+
+struct mpmc_ctx {
+  struct mpmc_param *p;
+  int id;
+};
+
+// Values are encoded as (producer << 32 | seq) + 1 to avoid nullptr
+static void *mpmc_producer(void *ctx) {
+  auto *c = (struct mpmc_ctx *)ctx;
+  auto *p = c->p;
+  std::vector<void *> ptrs(p->batch_size);
+
+  while (p->start == 0)
+    sched_yield();
+
+  for (intptr_t seq = 0; seq < p->iter_count;) {
+    int cnt = MIN(p->batch_size, p->iter_count - seq);
+
+    for (int i = 0; i < cnt; i++)
+      ptrs[i] = (void *)((((intptr_t)c->id << 32) | (seq + i)) + 1);
+
+    int pushed = 0;
+    while (pushed < cnt) {
+      int ret = queue_push_many(&p->queue, &ptrs[pushed], cnt - pushed);
+      if (ret > 0)
+        pushed += ret;
+      else
+        sched_yield(); // queue full, let other threads proceed
+    }
+
+    seq += cnt;
+  }
+
+  return nullptr;
+}
+
+static void *mpmc_consumer(void *ctx) {
+  auto *c = (struct mpmc_ctx *)ctx;
+  auto *p = c->p;
+  intptr_t total = p->producer_count * p->iter_count;
+  std::vector<void *> ptrs(p->batch_size);
+
+  // Last sequence number this consumer has seen from each producer
+  std::vector<intptr_t> last(p->producer_count, -1);
+
+  while (p->start == 0)
+    sched_yield();
+
+  while (p->pulled < total) {
+    int ret = queue_pull_many(&p->queue, ptrs.data(), p->batch_size);
+    if (ret <= 0) {
+      sched_yield(); // queue empty, let other threads proceed
+      continue;
+    }
+
+    p->pulled += ret;
+
+    for (int i = 0; i < ret; i++) {
+      intptr_t val = (intptr_t)ptrs[i] - 1;
+      int producer = val >> 32;
+      intptr_t seq = val & 0xffffffff;
+
+      if (producer < 0 || producer >= p->producer_count ||
+          seq >= p->iter_count) {
+        p->errors++;
+        continue;
+      }
+
+      // A single consumer must see each producer's values in FIFO order
+      if (seq <= last[producer])
+        p->errors++;
+
+      last[producer] = seq;
+
+      p->seen[producer * p->iter_count + seq]++;
+    }
+  }
+
+  return nullptr;
+}
+
+// Check ordering, loss and duplication of batched operations under contention
+Test(queue, mpmc_many, .timeout = 60, .init = init_memory) {
+  int ret;
+
+  for (int thread_count : {1, 2, 4, 8}) {
+    auto *p = new struct mpmc_param;
+
+    p->producer_count = thread_count;
+    p->consumer_count = thread_count;
+    p->batch_size = 48;
+    p->iter_count = 1 << 14;
+    p->start = 0;
+    p->pulled = 0;
+    p->errors = 0;
+    p->seen = std::vector<std::atomic<int>>(p->producer_count * p->iter_count);
+
+    ret = queue_init(&p->queue, 1 << 8, &memory::heap);
+    cr_assert_eq(ret, 0, "Failed to create queue");
+
+    std::vector<pthread_t> producers(p->producer_count),
+        consumers(p->consumer_count);
+    std::vector<struct mpmc_ctx> producer_ctxs(p->producer_count),
+        consumer_ctxs(p->consumer_count);
+
+    for (int i = 0; i < p->producer_count; i++) {
+      producer_ctxs[i] = {p, i};
+      pthread_create(&producers[i], nullptr, mpmc_producer, &producer_ctxs[i]);
+    }
+
+    for (int i = 0; i < p->consumer_count; i++) {
+      consumer_ctxs[i] = {p, i};
+      pthread_create(&consumers[i], nullptr, mpmc_consumer, &consumer_ctxs[i]);
+    }
+
+    p->start = 1;
+
+    for (int i = 0; i < p->producer_count; i++)
+      pthread_join(producers[i], nullptr);
+
+    for (int i = 0; i < p->consumer_count; i++)
+      pthread_join(consumers[i], nullptr);
+
+    cr_assert_eq(p->errors, 0, "Out-of-order or invalid values: %d",
+                 p->errors.load());
+    cr_assert_eq(p->pulled, p->producer_count * p->iter_count);
+
+    for (size_t i = 0; i < p->seen.size(); i++)
+      cr_assert_eq(p->seen[i], 1, "Value %zu seen %d times", i,
+                   p->seen[i].load());
+
+    ret = queue_available(&p->queue);
+    cr_assert_eq(ret, 0);
+
+    ret = queue_destroy(&p->queue);
+    cr_assert_eq(ret, 0, "Failed to destroy queue");
+
+    delete p;
+  }
+}
+
 Test(queue, init_destroy, .init = init_memory) {
   int ret;
   struct CQueue q;
@@ -323,3 +599,102 @@ Test(queue, init_destroy, .init = init_memory) {
   ret = queue_destroy(&q);
   cr_assert_eq(ret, 0); // Should succeed
 }
+
+// Compare throughput of MPMC and SPSC mode with a single producer and consumer
+Test(queue, spsc_throughput, .timeout = 60, .init = init_memory) {
+  int ret;
+  struct Tsc tsc;
+
+  Logger logger = Log::get("test:queue:spsc_throughput");
+
+  ret = tsc_init(&tsc);
+  cr_assert(!ret);
+
+  for (bool many : {false, true}) {
+    uint64_t cycles[2];
+
+    for (int flags : {0, (int)QueueFlags::SPSC}) {
+      auto *p = new struct bench_param;
+
+      p->thread_count = 1;
+      p->batch_size = 64;
+      p->many = many;
+      p->flags = flags;
+      p->iter_count = 1 << 16;
+      p->start = 0;
+
+      ret = queue_init(&p->queue, 1 << 10, &memory::heap, p->flags);
+      cr_assert_eq(ret, 0, "Failed to create queue");
+
+      pthread_t producer, consumer;
+
+      pthread_create(&producer, nullptr, bench_producer, p);
+      pthread_create(&consumer, nullptr, bench_consumer, p);
+
+      uint64_t start_tsc_time = tsc_now(&tsc);
+      p->start = 1;
+
+      pthread_join(producer, nullptr);
+      pthread_join(consumer, nullptr);
+
+      cycles[flags ? 1 : 0] = tsc_now(&tsc) - start_tsc_time;
+
+      ret = queue_available(&p->queue);
+      cr_assert_eq(ret, 0);
+
+      ret = queue_destroy(&p->queue);
+      cr_assert_eq(ret, 0, "Failed to destroy queue");
+
+      delete p;
+    }
+
+    double ops = 2.0 * (1 << 16);
+
+    logger->info("many={}: mpmc={:.1f} cycles/op, spsc={:.1f} cycles/op, "
+                 "speedup={:.2f}",
+                 many, cycles[0] / ops, cycles[1] / ops,
+                 (double)cycles[0] / cycles[1]);
+  }
+}
+
+Test(queue, spsc, .init = init_memory) {
+  int ret;
+  struct CQueue q;
+  void *ptrs[64];
+
+  ret = queue_init(&q, 64, &memory::heap, (int)QueueFlags::SPSC);
+  cr_assert_eq(ret, 0);
+
+  // Wrap around the ring multiple times and check ordering
+  for (intptr_t iter = 0; iter < 100; iter++) {
+    for (intptr_t i = 0; i < 48; i++)
+      ptrs[i] = (void *)(iter * 48 + i);
+
+    ret = queue_push_many(&q, ptrs, 48);
+    cr_assert_eq(ret, 48);
+    cr_assert_eq(queue_available(&q), 48);
+
+    ret = queue_pull_many(&q, ptrs, 64);
+    cr_assert_eq(ret, 48);
+
+    for (intptr_t i = 0; i < 48; i++)
+      cr_assert_eq((intptr_t)ptrs[i], iter * 48 + i);
+  }
+
+  // Overrun
+  ret = queue_push_many(&q, ptrs, 64);
+  cr_assert_eq(ret, 64);
+
+  ret = queue_push(&q, ptrs[0]);
+  cr_assert_eq(ret, 0);
+
+  ret = queue_pull_many(&q, ptrs, 64);
+  cr_assert_eq(ret, 64);
+
+  // Underrun
+  ret = queue_pull(&q, &ptrs[0]);
+  cr_assert_eq(ret, 0);
+
+  ret = queue_destroy(&q);
+  cr_assert_eq(ret, 0);
+}
@@ -25,6 +25,7 @@ struct param {
   enum QueueSignalledMode mode;
   int flags;
   bool polled;
+  bool spinning;
 };
 
 static void *producer(void *ctx) {
@@ -62,6 +63,33 @@ static void *consumer(void *ctx) {
   return nullptr;
 }
 
+// Busy-polls the queue for a while, before it falls back to blocking pulls
+static void *spinning_consumer(void *ctx) {
+  int ret;
+  struct CQueueSignalled *q = (struct CQueueSignalled *)ctx;
+
+  void *data[NUM_ELEM];
+
+  for (intptr_t i = 0, spins = 0; i < NUM_ELEM;) {
+    if (spins++ < 1000)
+      ret = queue_signalled_try_pull_many(q, data, ARRAY_LEN(data));
+    else
+      ret = queue_signalled_pull_many(q, data, ARRAY_LEN(data));
+
+    if (ret < 0)
+      return (void *)1; // Indicates an error to the parent thread
+    else if (ret > 0)
+      spins = 0;
+
+    for (intptr_t j = 0; j < ret; j++, i++) {
+      if ((intptr_t)data[j] != i)
+        return (void *)2; // Indicates an error to the parent thread
+    }
+  }
+
+  return nullptr;
+}
+
 void *polled_consumer(void *ctx) {
   int ret, fd;
   struct CQueueSignalled *q = (struct CQueueSignalled *)ctx;
@@ -99,9 +127,11 @@ ParameterizedTestParameters(queue_signalled, simple) {
       {QueueSignalledMode::PTHREAD, (int)QueueSignalledFlags::PROCESS_SHARED,
        false},
       {QueueSignalledMode::POLLING, 0, false},
+      {QueueSignalledMode::PTHREAD, 0, false, true},
 #if defined(__linux__) && defined(HAS_EVENTFD)
       {QueueSignalledMode::EVENTFD, 0, false},
-      {QueueSignalledMode::EVENTFD, 0, true}
+      {QueueSignalledMode::EVENTFD, 0, true},
+      {QueueSignalledMode::EVENTFD, 0, false, true}
 #endif
   };
 
@@ -125,7 +155,10 @@ ParameterizedTest(struct param *param, queue_signalled, simple, .timeout = 5,
   ret = pthread_create(&t1, nullptr, producer, &q);
   cr_assert_eq(ret, 0);
 
-  ret = pthread_create(&t2, nullptr, param->polled ? polled_consumer : consumer,
+  ret = pthread_create(&t2, nullptr,
+                       param->polled     ? polled_consumer
+                       : param->spinning ? spinning_consumer
+                                         : consumer,
                        &q);
   cr_assert_eq(ret, 0);
 
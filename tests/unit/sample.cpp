@@ -0,0 +1,223 @@
+/* Unit tests for samples.
+ *
+ * Author: Steffen Vogel <post@steffenvogel.de>
+ * SPDX-FileCopyrightText: 2014-2023 Institute for Automation of Complex Power Systems, RWTH Aachen University
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstring>
+
+#include <criterion/criterion.h>
+
+#include <villas/log.hpp>
+#include <villas/pool.hpp>
+#include <villas/sample.hpp>
+#include <villas/tsc.hpp>
+#include <villas/utils.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+#define NUM_VALUES 64
+
+// cppcheck-suppress unknownMacro
+Test(sample, freeze, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  struct Sample *smp, *cpy;
+
+  ret = pool_init(&pool, 4, SAMPLE_LENGTH(NUM_VALUES));
+  cr_assert_eq(ret, 0);
+
+  smp = sample_alloc(&pool);
+  cr_assert_not_null(smp);
+  cr_assert_not(sample_is_frozen(smp));
+
+  sample_freeze(smp);
+  cr_assert(sample_is_frozen(smp));
+
+  // Copies of frozen samples are writable
+  cpy = sample_clone(smp);
+  cr_assert_not_null(cpy);
+  cr_assert_not(sample_is_frozen(cpy));
+
+  sample_decref(cpy);
+  sample_decref(smp);
+
+  // Recycled samples are not frozen
+  smp = sample_alloc(&pool);
+  cr_assert_not_null(smp);
+  cr_assert_not(sample_is_frozen(smp));
+
+  sample_decref(smp);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+Test(sample, make_writable, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  struct Sample *smp, *wr;
+
+  ret = pool_init(&pool, 4, SAMPLE_LENGTH(NUM_VALUES));
+  cr_assert_eq(ret, 0);
+
+  smp = sample_alloc(&pool);
+  cr_assert_not_null(smp);
+
+  smp->length = 1;
+  smp->data[0].f = 1.0;
+
+  // Unfrozen samples are returned as is
+  wr = sample_make_writable(smp);
+  cr_assert_eq(wr, smp);
+
+  // Frozen samples with a single owner are thawed in place
+  sample_freeze(smp);
+  wr = sample_make_writable(smp);
+  cr_assert_eq(wr, smp);
+  cr_assert_not(sample_is_frozen(wr));
+
+  // Shared frozen samples are cloned
+  sample_freeze(smp);
+  sample_incref(smp);
+  cr_assert_eq(smp->refcnt, 2);
+
+  wr = sample_make_writable(smp);
+  cr_assert_neq(wr, smp);
+  cr_assert_not(sample_is_frozen(wr));
+  cr_assert_eq(wr->refcnt, 1);
+  cr_assert_eq(wr->data[0].f, 1.0);
+
+  // The reference to the original has been released
+  cr_assert_eq(smp->refcnt, 1);
+  cr_assert(sample_is_frozen(smp));
+
+  // Modifying the clone does not affect the shared sample
+  wr->data[0].f = 2.0;
+  cr_assert_eq(smp->data[0].f, 1.0);
+
+  sample_decref(wr);
+  sample_decref(smp);
+
+  cr_assert_eq(queue_available(&pool.queue), 4u);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+Test(sample, make_writable_underrun, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  struct Sample *smp, *wr;
+
+  ret = pool_init(&pool, 1, SAMPLE_LENGTH(NUM_VALUES));
+  cr_assert_eq(ret, 0);
+
+  smp = sample_alloc(&pool);
+  cr_assert_not_null(smp);
+
+  sample_freeze(smp);
+  sample_incref(smp);
+
+  // The caller keeps its reference if the clone fails
+  wr = sample_make_writable(smp);
+  cr_assert_null(wr);
+  cr_assert_eq(smp->refcnt, 2);
+
+  sample_decref(smp);
+  sample_decref(smp);
+
+  ret = pool_destroy(&pool);
+  cr_assert_eq(ret, 0);
+}
+
+/* Compare fan-out to multiple destinations by cloning and by reference.
+ *
+ * Destinations with write hooks need private copies of shared samples.
+ */
+Test(sample, fanout, .init = init_memory) {
+  int ret;
+  struct Pool pool;
+  struct Tsc tsc;
+
+  const int vectorize = 64;
+  const int iterations = 1000;
+
+  enum { CLONE, SHARED, SHARED_HOOKS, MODES };
+  const char *names[] = {"clone", "shared", "shared+hooks"};
+
+  Logger logger = Log::get("test:sample:fanout");
+
+  ret = tsc_init(&tsc);
+  cr_assert(!ret);
+
+  for (int dests : {1, 4, 16}) {
+    uint64_t cycles[MODES];
+
+    ret = pool_init(&pool, vectorize * (dests + 2), SAMPLE_LENGTH(NUM_VALUES));
+    cr_assert_eq(ret, 0);
+
+    struct Sample *smps[vectorize], *clones[vectorize];
+    struct Sample *queued[dests][vectorize];
+
+    ret = sample_alloc_many(&pool, smps, vectorize);
+    cr_assert_eq(ret, vectorize);
+
+    for (int i = 0; i < vectorize; i++)
+      smps[i]->length = NUM_VALUES;
+
+    for (int mode = 0; mode < MODES; mode++) {
+      uint64_t start = tsc_now(&tsc);
+
+      for (int iter = 0; iter < iterations; iter++) {
+        // See PathDestination::enqueueAll()
+        if (mode == CLONE) {
+          ret = sample_clone_many(clones, smps, vectorize);
+          cr_assert_eq(ret, vectorize);
+        } else {
+          sample_freeze_many(smps, vectorize);
+          sample_incref_many(smps, vectorize);
+          memcpy(clones, smps, sizeof(smps));
+        }
+
+        for (int d = 0; d < dests; d++) {
+          memcpy(queued[d], clones, sizeof(clones));
+          sample_incref_many(clones, vectorize);
+        }
+
+        sample_decref_many(clones, vectorize);
+
+        // See PathDestination::write()
+        for (int d = 0; d < dests; d++) {
+          if (mode == SHARED_HOOKS) {
+            ret = sample_make_writable_many(queued[d], vectorize);
+            cr_assert_eq(ret, vectorize);
+          }
+
+          sample_decref_many(queued[d], vectorize);
+        }
+      }
+
+      cycles[mode] = tsc_now(&tsc) - start;
+    }
+
+    for (int mode = SHARED; mode < MODES; mode++)
+      logger->info("destinations={}: clone={} cycles/sample, {}={} "
+                   "cycles/sample, speedup={:.2f}",
+                   dests, cycles[CLONE] / (iterations * vectorize),
+                   names[mode], cycles[mode] / (iterations * vectorize),
+                   (double)cycles[CLONE] / cycles[mode]);
+
+    sample_decref_many(smps, vectorize);
+
+    cr_assert_eq(queue_available(&pool.queue),
+                 (size_t)vectorize * (dests + 2));
+
+    ret = pool_destroy(&pool);
+    cr_assert_eq(ret, 0);
+  }
+}
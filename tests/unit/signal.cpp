@@ -72,3 +72,51 @@ Test(signal_data, parse, .init = init_memory) {
   cr_assert_float_eq(std::real(sd.z), 0, 1e-6);
   cr_assert_float_eq(std::imag(sd.z), -3, 1e-6);
 }
+
+Test(signal_data, print, .init = init_memory) {
+  int ret;
+  union SignalData sd, sp;
+  char buf[64], ref[64];
+  char *end;
+
+  // Shortest representation which is parsed back to the same value
+  for (double f : {0.1, -1.2e-17, 230.0 / 3, 1e300, 5e-324}) {
+    sd.f = f;
+
+    ret = sd.printString(SignalType::FLOAT, buf, sizeof(buf), -1);
+    cr_assert_eq(ret, strlen(buf));
+
+    ret = sp.parseString(SignalType::FLOAT, buf, &end);
+    cr_assert_eq(ret, 0);
+    cr_assert_eq(*end, '\0');
+    cr_assert_eq(sp.f, sd.f);
+  }
+
+  sd.f = 0.1;
+  sd.printString(SignalType::FLOAT, buf, sizeof(buf), -1);
+  cr_assert_str_eq(buf, "0.1");
+
+  sd.z = std::complex<float>(0.1, -0.2);
+  sd.printString(SignalType::COMPLEX, buf, sizeof(buf), -1);
+  cr_assert_str_eq(buf, "0.1-0.2i");
+
+  // A fixed precision produces the same output as printf()
+  for (int precision : {0, 5, 17}) {
+    sd.f = 230.0 / 3;
+    sd.printString(SignalType::FLOAT, buf, sizeof(buf), precision);
+    snprintf(ref, sizeof(ref), "%.*f", precision, sd.f);
+    cr_assert_str_eq(buf, ref);
+
+    sd.z = std::complex<float>(1.5, 0.25);
+    sd.printString(SignalType::COMPLEX, buf, sizeof(buf), precision);
+    snprintf(ref, sizeof(ref), "%.*f%+.*fi", precision, std::real(sd.z),
+             precision, std::imag(sd.z));
+    cr_assert_str_eq(buf, ref);
+  }
+
+  // Truncated output behaves like snprintf()
+  sd.f = 123456.789;
+  ret = sd.printString(SignalType::FLOAT, buf, 4, 3);
+  cr_assert_eq(ret, 10);
+  cr_assert_str_eq(buf, "123");
+}